@@ -0,0 +1,247 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file benchmark/batch_ted_benchmark.cc
+///
+/// \details
+/// Measures the throughput of the batched tree edit distance on many small
+/// tree pairs, e.g., records of a few schemas compared within their schema,
+/// against one zhang_shasha_ted call per pair. It also runs pairs of similar
+/// shapes, which are batched only where shapes are equal, and pairs of
+/// random shapes, which are mostly not batched. Fails if the random shapes are
+/// slower than one call per pair beyond the cost of finding the shapes.
+///
+/// Usage: batch_ted_benchmark [PAIRS] [SHAPES]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+#include "node.h"
+#include "string_label.h"
+#include "unit_cost_model.h"
+#include "string_edit_distance_cost_model.h"
+#include "zhang_shasha.h"
+#include "batch_ted.h"
+
+using Label = label::StringLabel;
+
+/// Draws a random tree shape: every node but the root is attached to a
+/// random earlier node.
+///
+/// \param size Number of nodes.
+/// \param rng Random number generator.
+/// \return Parent of each node, -1 for the root.
+std::vector<int> make_parents(int size, std::mt19937& rng) {
+  std::vector<int> parent(size, -1);
+  for (int n = 1; n < size; ++n) {
+    parent[n] = std::uniform_int_distribution<int>(0, n - 1)(rng);
+  }
+  return parent;
+}
+
+/// Moves a random subtree of a shape to another random parent, which keeps
+/// the size of the shape.
+///
+/// \param parent Parent of each node, -1 for the root.
+/// \param rng Random number generator.
+/// \return Parent of each node of the new shape.
+std::vector<int> move_subtree(std::vector<int> parent, std::mt19937& rng) {
+  const int kNode = std::uniform_int_distribution<int>(
+      1, parent.size() - 1)(rng);
+  parent[kNode] = std::uniform_int_distribution<int>(0, kNode - 1)(rng);
+  return parent;
+}
+
+/// Creates a tree shape with internal labels from the schema.
+///
+/// \param parent Parent of each node, -1 for the root. A parent precedes
+///        its children.
+/// \return The root of the tree.
+node::Node<Label> make_shape(const std::vector<int>& parent) {
+  // Copy the tree bottom-up such that children are complete when added.
+  const int kSize = parent.size();
+  std::vector<node::Node<Label>> nodes;
+  for (int n = 0; n < kSize; ++n) {
+    nodes.emplace_back(Label("field" + std::to_string(n % 7)));
+  }
+  for (int n = kSize - 1; n > 0; --n) {
+    nodes[parent[n]].add_child(nodes[n]);
+  }
+  return nodes[0];
+}
+
+/// Creates a random tree shape with internal labels from the schema.
+///
+/// \param size Number of nodes.
+/// \param rng Random number generator.
+/// \return The root of the tree.
+node::Node<Label> make_shape(int size, std::mt19937& rng) {
+  return make_shape(make_parents(size, rng));
+}
+
+/// Copies a shape and draws its leaf labels from a small domain.
+///
+/// \param shape The shape.
+/// \param rng Random number generator.
+/// \return The record.
+node::Node<Label> make_record(const node::Node<Label>& shape,
+                              std::mt19937& rng) {
+  if (shape.is_leaf()) {
+    return node::Node<Label>(Label(
+        "value" + std::to_string(std::uniform_int_distribution<int>(0, 4)(rng))));
+  }
+  node::Node<Label> record(shape.label());
+  for (const node::Node<Label>& child : shape.get_children()) {
+    record.add_child(make_record(child, rng));
+  }
+  return record;
+}
+
+/// Computes the distances of all pairs one by one and in batches, and prints
+/// the throughput of both. Each is timed by its fastest of kRepetitions
+/// alternating runs, which damps the timing noise.
+///
+/// \param name Name of the cost model.
+/// \param pairs The tree pairs.
+/// \return Time one by one divided by the batched time.
+template <typename CostModel>
+double run(const std::string& name,
+           const std::vector<typename zhang_shasha::BatchAlgorithm<
+               Label, CostModel>::TreePair>& pairs) {
+  const int kRepetitions = 3;
+  zhang_shasha::Algorithm<Label, CostModel> zs_ted;
+  double single_sum = 0.0;
+  double single_s = std::numeric_limits<double>::max();
+  double batch_s = std::numeric_limits<double>::max();
+  std::vector<double> distances;
+  typename zhang_shasha::BatchAlgorithm<Label, CostModel>::Statistics stats;
+  for (int r = 0; r < kRepetitions; ++r) {
+    single_sum = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& pair : pairs) {
+      single_sum += zs_ted.zhang_shasha_ted(pair.first, pair.second);
+    }
+    single_s = std::min(single_s, std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count());
+
+    zhang_shasha::BatchAlgorithm<Label, CostModel> batch_ted;
+    start = std::chrono::steady_clock::now();
+    distances = batch_ted.zhang_shasha_ted(pairs);
+    batch_s = std::min(batch_s, std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count());
+    stats = batch_ted.get_statistics();
+  }
+  double batch_sum = 0.0;
+  for (double d : distances) {
+    batch_sum += d;
+  }
+
+  std::cout << name
+            << " single_pairs_per_s=" << pairs.size() / single_s
+            << " batch_pairs_per_s=" << pairs.size() / batch_s
+            << " speedup=" << single_s / batch_s
+            << " batches=" << stats.batches
+            << " unbatched=" << stats.single_pairs
+            << " batched_ratio="
+            << static_cast<double>(stats.batched_pairs) / stats.pairs
+            << " sums_equal=" << (single_sum == batch_sum)
+            << std::endl;
+  return single_s / batch_s;
+}
+
+int main(int argc, char** argv) {
+  const int kPairs = argc > 1 ? std::atoi(argv[1]) : 100000;
+  const int kShapes = argc > 2 ? std::atoi(argv[2]) : 50;
+
+  std::mt19937 rng(42);
+  std::vector<std::vector<int>> shape_parents;
+  std::vector<node::Node<Label>> shapes;
+  for (int s = 0; s < kShapes; ++s) {
+    shape_parents.push_back(make_parents(
+        std::uniform_int_distribution<int>(8, 48)(rng), rng));
+    shapes.push_back(make_shape(shape_parents.back()));
+  }
+  // Every pair compares two records of the same schema.
+  std::vector<node::Node<Label>> records;
+  records.reserve(2 * kPairs);
+  for (int p = 0; p < kPairs; ++p) {
+    const node::Node<Label>& kShape = shapes[p % kShapes];
+    records.push_back(make_record(kShape, rng));
+    records.push_back(make_record(kShape, rng));
+  }
+  std::vector<zhang_shasha::BatchAlgorithm<
+      Label, cost_model::UnitCostModel<Label>>::TreePair> pairs;
+  for (int p = 0; p < kPairs; ++p) {
+    pairs.emplace_back(std::cref(records[2 * p]),
+                       std::cref(records[2 * p + 1]));
+  }
+  std::cout << "pairs=" << kPairs << " shapes=" << kShapes << std::endl;
+
+  run<cost_model::UnitCostModel<Label>>("unit", pairs);
+  run<cost_model::StringEditDistanceCostModel<Label>>(
+      "string_edit_distance", pairs);
+
+  // Every tree has its own random shape.
+  std::vector<node::Node<Label>> random_trees;
+  random_trees.reserve(2 * kPairs);
+  for (int t = 0; t < 2 * kPairs; ++t) {
+    random_trees.push_back(make_record(make_shape(
+        std::uniform_int_distribution<int>(8, 48)(rng), rng), rng));
+  }
+  pairs.clear();
+  for (int p = 0; p < kPairs; ++p) {
+    pairs.emplace_back(std::cref(random_trees[2 * p]),
+                       std::cref(random_trees[2 * p + 1]));
+  }
+  // Random shapes are batched at most where it is estimated to be faster.
+  // The fallback costs one extra pass over the nodes, about 5% on trees
+  // this small; a larger loss means the fallback got slower.
+  const double kRandomSpeedup =
+      run<cost_model::UnitCostModel<Label>>("random_shapes_unit", pairs);
+
+  // Every tree is a record of a schema with one subtree moved: equal sizes,
+  // mostly different shapes.
+  std::vector<node::Node<Label>> similar_trees;
+  similar_trees.reserve(2 * kPairs);
+  for (int t = 0; t < 2 * kPairs; ++t) {
+    similar_trees.push_back(make_record(make_shape(
+        move_subtree(shape_parents[t / 2 % kShapes], rng)), rng));
+  }
+  pairs.clear();
+  for (int p = 0; p < kPairs; ++p) {
+    pairs.emplace_back(std::cref(similar_trees[2 * p]),
+                       std::cref(similar_trees[2 * p + 1]));
+  }
+  run<cost_model::UnitCostModel<Label>>("similar_shapes_unit", pairs);
+
+  if (kRandomSpeedup < 0.9) {
+    std::cerr << "Batching random shapes is slower than one call per pair: "
+              << "speedup=" << kRandomSpeedup << std::endl;
+    return 1;
+  }
+  return 0;
+}
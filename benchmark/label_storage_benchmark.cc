@@ -0,0 +1,123 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file benchmark/label_storage_benchmark.cc
+///
+/// \details
+/// Compares the load time and the resident memory of a large tree with
+/// StringLabel and with ArenaLabel. Run each label type in a separate
+/// process, the allocator does not return freed memory to the system.
+///
+/// Usage: label_storage_benchmark string|arena [NODES]
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "node.h"
+#include "string_label.h"
+#include "arena_label.h"
+#include "label_dictionary.h"
+
+/// Returns the resident memory of the process.
+///
+/// \return Resident memory in bytes, 0 if unknown.
+long long resident_bytes() {
+  std::ifstream statm("/proc/self/statm");
+  long long pages = 0;
+  long long resident = 0;
+  statm >> pages >> resident;
+  return resident * 4096;
+}
+
+/// Returns the label of the i-th node. Half of the labels are short element
+/// names, the other half are longer values from a domain of 1000 strings.
+///
+/// \param i Number of the node.
+/// \return The label.
+std::string make_label(int i) {
+  static const std::vector<std::string> kNames = {
+      "record", "id", "name", "tags", "tag", "body", "p", "title"};
+  if (i % 2 == 0) {
+    return kNames[(i / 2) % kNames.size()];
+  }
+  return "http://example.org/resource/" + std::to_string(i % 1000);
+}
+
+/// Builds a tree of records with ten nodes each, interns its labels, and
+/// prints the time and the memory used.
+///
+/// \param name Name of the label type.
+/// \param nodes Number of nodes.
+/// \param create Creates a label from a string.
+template <typename Label, typename Factory>
+void run(const std::string& name, int nodes, Factory create) {
+  const long long kResidentBefore = resident_bytes();
+  auto start = std::chrono::steady_clock::now();
+  node::Node<Label> root(create(make_label(0)));
+  for (int i = 1; i < nodes; i += 10) {
+    node::Node<Label>& record = root.add_child(node::Node<Label>(create(make_label(i))));
+    for (int j = 1; j < 10 && i + j < nodes; ++j) {
+      record.add_child(node::Node<Label>(create(make_label(i + j))));
+    }
+  }
+  const double kLoadS = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+  start = std::chrono::steady_clock::now();
+  label::LabelDictionary<Label> labels;
+  for (const auto& record : root.get_children()) {
+    labels.insert(record.label());
+    for (const auto& child : record.get_children()) {
+      labels.insert(child.label());
+    }
+  }
+  const double kInternS = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+  std::cout << name
+            << " nodes=" << root.get_tree_size()
+            << " distinct_labels=" << labels.size()
+            << " load_s=" << kLoadS
+            << " intern_s=" << kInternS
+            << " resident_mb=" << (resident_bytes() - kResidentBefore) / (1 << 20)
+            << std::endl;
+}
+
+int main(int argc, char** argv) {
+  const std::string kMode = argc > 1 ? argv[1] : "string";
+  const int kNodes = argc > 2 ? std::atoi(argv[2]) : 10000000;
+
+  if (kMode == "string") {
+    run<label::StringLabel>("string", kNodes, [](const std::string& l) {
+      return label::StringLabel(l);
+    });
+  } else {
+    label::LabelArena arena;
+    run<label::ArenaLabel>("arena", kNodes, [&arena](const std::string& l) {
+      return label::ArenaLabel(l, arena);
+    });
+    std::cout << "arena_kb=" << arena.allocated_bytes() / 1024 << std::endl;
+  }
+
+  return 0;
+}
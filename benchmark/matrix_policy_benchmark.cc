@@ -0,0 +1,157 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file benchmark/matrix_policy_benchmark.cc
+///
+/// \details
+/// Compares the Matrix allocation policies on a table of 20k x 20k
+/// distances: allocation time, resident memory after touching a small block
+/// only (lazily zeroed pages), a full row-wise dynamic programming sweep, and
+/// column-wise reads. Finally runs zhang_shasha_ted on two trees of 20k
+/// nodes, whose td and fd tables use AlignedMatrixPolicy.
+///
+/// Usage: matrix_policy_benchmark [SIZE] [SKIP_TED]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+#include "matrix.h"
+#include "node.h"
+#include "string_label.h"
+#include "unit_cost_model.h"
+#include "zhang_shasha.h"
+
+using Label = label::StringLabel;
+
+/// Returns the resident memory of the process in MB (Linux only).
+///
+/// \return Resident set size, or 0 if unknown.
+double resident_mb() {
+  std::ifstream statm("/proc/self/statm");
+  long long pages = 0;
+  long long resident = 0;
+  if (!(statm >> pages >> resident)) {
+    return 0.0;
+  }
+  return resident * static_cast<double>(sysconf(_SC_PAGESIZE)) / (1 << 20);
+}
+
+/// Returns the milliseconds since a point in time.
+///
+/// \param start The point in time.
+/// \return Elapsed milliseconds.
+double elapsed_ms(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - start).count();
+}
+
+/// Measures one allocation policy on a square table.
+///
+/// \param name Name of the policy.
+/// \param size Number of rows and columns minus one.
+template <typename Policy>
+void run(const std::string& name, int size) {
+  const double kBaseMb = resident_mb();
+  auto start = std::chrono::steady_clock::now();
+  data_structures::Matrix<int, Policy> fd;
+  fd.resize(size + 1, size + 1);
+  const double kAllocMs = elapsed_ms(start);
+
+  // Touch a 2000 x 2000 block, as the subforest distances of a small
+  // key-root pair do.
+  const int kBlock = std::min(size, 2000);
+  for (int i = 0; i <= kBlock; ++i) {
+    for (int j = 0; j <= kBlock; ++j) {
+      fd.at(i, j) = i + j;
+    }
+  }
+  const double kBlockMb = resident_mb() - kBaseMb;
+
+  // Edit distance recurrence over the whole table, row by row.
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i <= size; ++i) {
+    fd.at(i, 0) = i;
+  }
+  for (int j = 0; j <= size; ++j) {
+    fd.at(0, j) = j;
+  }
+  for (int i = 1; i <= size; ++i) {
+    for (int j = 1; j <= size; ++j) {
+      fd.at(i, j) = std::min({fd.at(i - 1, j) + 1, fd.at(i, j - 1) + 1,
+                              fd.at(i - 1, j - 1) + ((i * 7 + j) % 5 != 0)});
+    }
+  }
+  const double kSweepMs = elapsed_ms(start);
+
+  // Reads down 256 columns, one row apart each.
+  start = std::chrono::steady_clock::now();
+  long long sum = 0;
+  for (int j = 0; j < 256; ++j) {
+    for (int i = 0; i <= size; ++i) {
+      sum += fd.at(i, j);
+    }
+  }
+  const double kColumnsMs = elapsed_ms(start);
+
+  std::cout << name
+            << " alloc_ms=" << kAllocMs
+            << " block_rss_mb=" << kBlockMb
+            << " sweep_ms=" << kSweepMs
+            << " columns_ms=" << kColumnsMs
+            << " full_rss_mb=" << resident_mb() - kBaseMb
+            << " distance=" << fd.at(size, size)
+            << " checksum=" << sum % 1000
+            << std::endl;
+}
+
+int main(int argc, char** argv) {
+  const int kSize = argc > 1 ? std::atoi(argv[1]) : 20000;
+  const bool kSkipTed = argc > 2 && std::atoi(argv[2]) != 0;
+
+  run<data_structures::DefaultMatrixPolicy>("default", kSize);
+  run<data_structures::AlignedMatrixPolicy>("aligned", kSize);
+
+  if (!kSkipTed) {
+    // Flat trees: every leaf is a key root, the root pair fills the whole
+    // tables once.
+    node::Node<Label> t1(Label("root"));
+    node::Node<Label> t2(Label("root"));
+    for (int n = 1; n < kSize; ++n) {
+      t1.add_child(node::Node<Label>(Label(std::to_string(n % 13))));
+      t2.add_child(node::Node<Label>(Label(std::to_string(n % 11))));
+    }
+    zhang_shasha::Algorithm<Label, cost_model::UnitCostModel<Label>> zs_ted;
+    auto start = std::chrono::steady_clock::now();
+    const double kTed = zs_ted.zhang_shasha_ted(t1, t2);
+    std::cout << "zhang_shasha nodes=" << kSize
+              << " ted=" << kTed
+              << " time_ms=" << elapsed_ms(start)
+              << " rss_mb=" << resident_mb()
+              << std::endl;
+  }
+
+  return 0;
+}
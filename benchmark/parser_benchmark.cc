@@ -0,0 +1,140 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file benchmark/parser_benchmark.cc
+///
+/// \details
+/// Measures the throughput of the streaming XML and JSON parsers. The input
+/// is a stream of generated records produced on the fly, so that inputs
+/// larger than the memory can be parsed. Every record is a separate document
+/// and its tree is discarded after parsing.
+///
+/// Usage: parser_benchmark [MEGABYTES]
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include "node.h"
+#include "string_label.h"
+#include "label_dictionary.h"
+#include "xml_parser.h"
+#include "json_parser.h"
+
+using Label = label::StringLabel;
+
+/// Stream buffer repeating generated records until a size limit is reached.
+class RecordBuffer : public std::streambuf {
+public:
+  /// Constructor.
+  ///
+  /// \param format Either "xml" or "json".
+  /// \param limit Number of bytes to produce.
+  RecordBuffer(const std::string& format, long long limit)
+      : format_(format), remaining_(limit) {}
+
+protected:
+  int_type underflow() override {
+    if (remaining_ <= 0) {
+      return traits_type::eof();
+    }
+    record_.clear();
+    for (int r = 0; r < 64; ++r, ++count_) {
+      append_record();
+    }
+    if (static_cast<long long>(record_.size()) > remaining_) {
+      record_.resize(remaining_);
+    }
+    remaining_ -= record_.size();
+    setg(&record_[0], &record_[0], &record_[0] + record_.size());
+    return traits_type::to_int_type(record_[0]);
+  }
+
+private:
+  /// Appends one record to the current chunk.
+  void append_record() {
+    const std::string kId = std::to_string(count_ % 100000);
+    const std::string kGroup = std::to_string(count_ % 17);
+    if (format_ == "xml") {
+      record_ += "<record id=\"" + kId + "\" group=\"" + kGroup + "\">"
+                 "<name>item &amp; " + kId + "</name>"
+                 "<tags><tag>red</tag><tag>green</tag><tag>blue</tag></tags>"
+                 "<body><p>The quick brown fox.</p><p>Jumps over the dog."
+                 "</p></body></record>\n";
+    } else {
+      record_ += "{\"id\": " + kId + ", \"group\": " + kGroup + ", "
+                 "\"name\": \"item \\u0026 " + kId + "\", "
+                 "\"tags\": [\"red\", \"green\", \"blue\"], "
+                 "\"body\": {\"p\": [\"The quick brown fox.\", "
+                 "\"Jumps over the dog.\"]}, \"valid\": true}\n";
+    }
+  }
+
+  std::string format_;
+  long long remaining_;
+  long long count_ = 0;
+  std::string record_;
+};
+
+/// Parses all records of a generated stream and prints the throughput.
+///
+/// \param format Either "xml" or "json".
+/// \param parser The parser.
+/// \param bytes Size of the input.
+template <typename Parser>
+void run(const std::string& format, Parser& parser, long long bytes) {
+  RecordBuffer buffer(format, bytes);
+  std::istream in(&buffer);
+  long long documents = 0;
+  long long nodes = 0;
+  auto start = std::chrono::steady_clock::now();
+  while (parser.parse(in)) {
+    ++documents;
+    nodes += parser.get_tree().get_tree_size();
+  }
+  const double kTimeS = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+  std::cout << format
+            << " megabytes=" << bytes / (1 << 20)
+            << " documents=" << documents
+            << " nodes=" << nodes
+            << " time_s=" << kTimeS
+            << " megabytes_per_s=" << bytes / (1 << 20) / kTimeS
+            << std::endl;
+}
+
+int main(int argc, char** argv) {
+  const long long kBytes =
+      (argc > 1 ? std::atoll(argv[1]) : 1024) * (1LL << 20);
+
+  label::LabelDictionary<Label> labels;
+  parser::XmlParser xml_parser(parser::XmlMapping(), &labels);
+  run("xml", xml_parser, kBytes);
+  std::cout << "distinct_labels=" << labels.size() << std::endl;
+
+  parser::JsonParser json_parser(parser::JsonMapping(), &labels);
+  run("json", json_parser, kBytes);
+  std::cout << "distinct_labels=" << labels.size() << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,129 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file benchmark/repetitive_trees_benchmark.cc
+///
+/// \details
+/// Measures the tree edit distance on highly repetitive trees, e.g., XML
+/// documents with many records of the same shape. Such trees contain many
+/// identical subtrees whose key-root pairs are reused by the algorithm.
+///
+/// Usage: repetitive_trees_benchmark [RECORDS] [REPETITIONS]
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "node.h"
+#include "string_label.h"
+#include "unit_cost_model.h"
+#include "string_edit_distance_cost_model.h"
+#include "zhang_shasha.h"
+
+using Label = label::StringLabel;
+
+/// Creates a leaf node.
+///
+/// \param label The label.
+/// \return The node.
+node::Node<Label> leaf(const std::string& label) {
+  return node::Node<Label>(Label(label));
+}
+
+/// Creates a document with records of the same shape. The records differ
+/// only in few labels taken from small domains.
+///
+/// \param records Number of records.
+/// \param variant Changes the labels of some records.
+/// \return The root of the document.
+node::Node<Label> make_document(int records, int variant) {
+  node::Node<Label> root(Label("catalog"));
+  for (int r = 0; r < records; ++r) {
+    node::Node<Label> record(Label("record"));
+    node::Node<Label> id(Label("id"));
+    id.add_child(leaf(std::to_string(r % 8)));
+    record.add_child(id);
+    node::Node<Label> name(Label("name"));
+    name.add_child(leaf(r % 23 == variant ? "changed" : "text"));
+    record.add_child(name);
+    node::Node<Label> tags(Label("tags"));
+    for (int t = 0; t < 3; ++t) {
+      tags.add_child(leaf("tag"));
+    }
+    record.add_child(tags);
+    node::Node<Label> body(Label("body"));
+    for (int p = 0; p < 2; ++p) {
+      node::Node<Label> paragraph(Label("p"));
+      paragraph.add_child(leaf("sentence"));
+      paragraph.add_child(leaf("sentence"));
+      body.add_child(paragraph);
+    }
+    record.add_child(body);
+    root.add_child(record);
+  }
+  return root;
+}
+
+/// Runs the algorithm repeatedly and prints the average time and counters.
+///
+/// \param name Name of the cost model.
+/// \param t1 Source tree.
+/// \param t2 Destination tree.
+/// \param repetitions Number of runs.
+template <typename CostModel>
+void run(const std::string& name, const node::Node<Label>& t1,
+         const node::Node<Label>& t2, int repetitions) {
+  zhang_shasha::Algorithm<Label, CostModel> zs_ted;
+  double ted = 0.0;
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < repetitions; ++r) {
+    ted = zs_ted.zhang_shasha_ted(t1, t2);
+  }
+  const double kTimeMs = std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - start).count() / repetitions;
+  const auto& stats = zs_ted.get_statistics();
+  std::cout << name
+            << " ted=" << ted
+            << " time_ms=" << kTimeMs
+            << " forest_distance_calls=" << stats.forest_distance_calls
+            << " key_root_pairs_reused=" << stats.key_root_pairs_reused
+            << " cells_computed=" << stats.cells_computed
+            << std::endl;
+}
+
+int main(int argc, char** argv) {
+  const int kRecords = argc > 1 ? std::atoi(argv[1]) : 200;
+  const int kRepetitions = argc > 2 ? std::atoi(argv[2]) : 3;
+
+  const node::Node<Label> t1 = make_document(kRecords, 0);
+  const node::Node<Label> t2 = make_document(kRecords, 5);
+  std::cout << "t1_size=" << t1.get_tree_size()
+            << " t2_size=" << t2.get_tree_size() << std::endl;
+
+  run<cost_model::UnitCostModel<Label>>("unit", t1, t2, kRepetitions);
+  run<cost_model::StringEditDistanceCostModel<Label>>(
+      "string_edit_distance", t1, t2, kRepetitions);
+  run<cost_model::UnitCostModel<Label>>("unit_identical", t1, t1,
+                                        kRepetitions);
+
+  return 0;
+}
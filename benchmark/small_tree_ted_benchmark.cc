@@ -0,0 +1,130 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file benchmark/small_tree_ted_benchmark.cc
+///
+/// \details
+/// Measures the time per tree edit distance computation on tiny and small
+/// trees with zhang_shasha::Algorithm and with SizeDispatchingAlgorithm,
+/// which uses fixed-size buffers for such trees.
+///
+/// Usage: small_tree_ted_benchmark [PAIRS]
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "node.h"
+#include "string_label.h"
+#include "unit_cost_model.h"
+#include "zhang_shasha.h"
+#include "small_tree_ted.h"
+
+using Label = label::StringLabel;
+using CostModel = cost_model::UnitCostModel<Label>;
+
+/// Creates a random tree with labels from a small alphabet.
+///
+/// \param size Number of nodes.
+/// \param rng Random number generator.
+/// \return The root of the tree.
+node::Node<Label> make_tree(int size, std::mt19937& rng) {
+  // Attach every new node to a random earlier node, then copy the tree
+  // bottom-up such that children are complete when added.
+  std::vector<int> parent(size, -1);
+  for (int n = 1; n < size; ++n) {
+    parent[n] = std::uniform_int_distribution<int>(0, n - 1)(rng);
+  }
+  std::vector<node::Node<Label>> nodes;
+  for (int n = 0; n < size; ++n) {
+    nodes.emplace_back(Label(std::string(
+        1, 'a' + std::uniform_int_distribution<int>(0, 5)(rng))));
+  }
+  for (int n = size - 1; n > 0; --n) {
+    nodes[parent[n]].add_child(nodes[n]);
+  }
+  return nodes[0];
+}
+
+/// Computes the distances of all pairs with an algorithm and returns the
+/// average time per pair.
+///
+/// \param algorithm The algorithm.
+/// \param trees Pairs of consecutive trees.
+/// \param sum Sum of the distances.
+/// \return Nanoseconds per pair.
+template <typename Algorithm>
+double time_pairs(Algorithm& algorithm,
+                  const std::vector<node::Node<Label>>& trees, double& sum) {
+  sum = 0.0;
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t p = 0; p + 1 < trees.size(); p += 2) {
+    sum += algorithm.zhang_shasha_ted(trees[p], trees[p + 1]);
+  }
+  return std::chrono::duration<double, std::nano>(
+      std::chrono::steady_clock::now() - start).count() / (trees.size() / 2);
+}
+
+/// Prints the time per pair of both algorithms for trees with sizes in a
+/// range.
+///
+/// \param min_size Minimum number of nodes of a tree.
+/// \param max_size Maximum number of nodes of a tree.
+/// \param pairs Number of tree pairs.
+void run(int min_size, int max_size, int pairs) {
+  std::mt19937 rng(42);
+  std::vector<node::Node<Label>> trees;
+  for (int t = 0; t < 2 * pairs; ++t) {
+    trees.push_back(make_tree(
+        std::uniform_int_distribution<int>(min_size, max_size)(rng), rng));
+  }
+  // Heap-allocated, the dispatching algorithm holds its buffers inline.
+  std::unique_ptr<zhang_shasha::Algorithm<Label, CostModel>> zs_ted(
+      new zhang_shasha::Algorithm<Label, CostModel>());
+  std::unique_ptr<zhang_shasha::SizeDispatchingAlgorithm<Label, CostModel>>
+      dispatching_ted(
+          new zhang_shasha::SizeDispatchingAlgorithm<Label, CostModel>());
+  double zs_sum = 0.0;
+  double dispatching_sum = 0.0;
+  const double kZsNs = time_pairs(*zs_ted, trees, zs_sum);
+  const double kDispatchingNs =
+      time_pairs(*dispatching_ted, trees, dispatching_sum);
+  std::cout << "sizes=" << min_size << ".." << max_size
+            << " zhang_shasha_ns=" << kZsNs
+            << " dispatching_ns=" << kDispatchingNs
+            << " speedup=" << kZsNs / kDispatchingNs
+            << " sums_equal=" << (zs_sum == dispatching_sum)
+            << std::endl;
+}
+
+int main(int argc, char** argv) {
+  const int kPairs = argc > 1 ? std::atoi(argv[1]) : 200000;
+
+  run(2, 8, kPairs);
+  run(8, 16, kPairs);
+  run(17, 64, kPairs / 10);
+
+  return 0;
+}
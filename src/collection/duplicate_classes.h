@@ -0,0 +1,170 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file collection/duplicate_classes.h
+///
+/// \details
+/// Contains the declaration of the DuplicateClasses class. It groups the
+/// identical trees of a collection, so that all-pairs computations run on
+/// one representative per group.
+
+#ifndef TREE_SIMILARITY_COLLECTION_DUPLICATE_CLASSES_H
+#define TREE_SIMILARITY_COLLECTION_DUPLICATE_CLASSES_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include "node.h"
+#include "matrix.h"
+#include "hash.h"
+
+namespace collection {
+
+/// \class DuplicateClasses
+///
+/// \details
+/// Partitions a collection of trees into classes of identical trees (equal
+/// labels and equal shape) in time linear in the size of the collection.
+/// Trees are grouped by a structural hash and compared node by node on equal
+/// hashes, so hash collisions never merge different trees.
+///
+/// Distances within a class are 0 and distances between two classes are
+/// those of their representatives. Near-exact duplicates, e.g., trees that
+/// differ in the case or spacing of labels, can be collapsed by normalising
+/// the labels while parsing (see the label factory of
+/// BasicBracketNotationParser).
+///
+/// \tparam Label Type of the labels. A specialization of std::hash must be
+///         provided.
+template <typename Label>
+class DuplicateClasses {
+// Member struct.
+public:
+  /// Counters describing the collapsed collection.
+  struct Statistics {
+    /// Number of trees of the collection.
+    long long trees = 0;
+    /// Number of classes, i.e., of distinct trees.
+    long long classes = 0;
+    /// Number of nodes of all trees.
+    long long nodes = 0;
+    /// Number of nodes of the representatives.
+    long long representative_nodes = 0;
+    /// Number of trees per class, trees / classes.
+    double collapse_ratio = 1.0;
+  };
+  /// A pair of trees of a join result.
+  struct JoinPair {
+    /// Position of the first tree in the collection.
+    int tree1;
+    /// Position of the second tree in the collection, tree1 < tree2.
+    int tree2;
+    /// Distance between the trees.
+    double distance;
+  };
+// Member functions.
+public:
+  /// Groups the trees of a collection into classes. Classes are numbered in
+  /// the order of their first trees, which are their representatives.
+  ///
+  /// \param trees The collection.
+  void build(const std::vector<node::Node<Label>>& trees);
+
+  /// Returns the class of a tree.
+  ///
+  /// \param tree Position of the tree in the collection.
+  /// \return The class id.
+  int get_class(int tree) const;
+
+  /// Returns the number of classes.
+  int get_class_count() const;
+
+  /// Returns the representative tree of every class.
+  ///
+  /// \return Positions of the representatives, indexed by class id.
+  const std::vector<int>& get_representatives() const;
+
+  /// Returns the trees of a class.
+  ///
+  /// \param class_id The class id.
+  /// \return Positions of the trees in ascending order.
+  const std::vector<int>& get_members(int class_id) const;
+
+  /// Returns the counters of the last build.
+  Statistics get_statistics() const;
+
+  /// Computes the distances between all pairs of trees, calling distance on
+  /// pairs of representatives only.
+  ///
+  /// \param trees The collection passed to build.
+  /// \param distance Returns the distance of two trees.
+  /// \return Matrix of the distances, row i and column j hold the distance
+  ///         from tree i to tree j.
+  template <typename Distance>
+  data_structures::Matrix<double> distance_matrix(
+      const std::vector<node::Node<Label>>& trees, Distance distance) const;
+
+  /// Finds all pairs of trees within a distance threshold, calling distance
+  /// on pairs of representatives only. The distance must be symmetric. Tree
+  /// pairs are enumerated only for class pairs within the threshold.
+  ///
+  /// \param trees The collection passed to build.
+  /// \param threshold The maximum distance.
+  /// \param distance Returns the distance of two trees.
+  /// \return The pairs ordered by tree1 and tree2.
+  template <typename Distance>
+  std::vector<JoinPair> join(const std::vector<node::Node<Label>>& trees,
+                             double threshold, Distance distance) const;
+// Member functions.
+private:
+  /// Computes a structural hash of a tree.
+  ///
+  /// \param tree The tree.
+  /// \return The hash.
+  static std::uint64_t hash(const node::Node<Label>& tree);
+
+  /// Compares two trees node by node.
+  ///
+  /// \param t1 The first tree.
+  /// \param t2 The second tree.
+  /// \return True if the labels and the shapes are equal.
+  static bool equal(const node::Node<Label>& t1, const node::Node<Label>& t2);
+// Member variables.
+private:
+  /// Class of every tree.
+  std::vector<int> class_of_;
+  /// Representative of every class.
+  std::vector<int> representatives_;
+  /// Trees of every class.
+  std::vector<std::vector<int>> members_;
+  /// Counters.
+  Statistics stats_;
+};
+
+// Implementation details.
+#include "duplicate_classes_impl.h"
+
+}
+
+#endif // TREE_SIMILARITY_COLLECTION_DUPLICATE_CLASSES_H
@@ -0,0 +1,181 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file collection/duplicate_classes_impl.h
+///
+/// \details
+/// Contains the implementation of the DuplicateClasses class.
+
+#ifndef TREE_SIMILARITY_COLLECTION_DUPLICATE_CLASSES_IMPL_H
+#define TREE_SIMILARITY_COLLECTION_DUPLICATE_CLASSES_IMPL_H
+
+template <typename Label>
+void DuplicateClasses<Label>::build(
+    const std::vector<node::Node<Label>>& trees) {
+  class_of_.assign(trees.size(), -1);
+  representatives_.clear();
+  members_.clear();
+  stats_ = Statistics();
+
+  // Classes of equal hashes. More than one only on hash collisions.
+  std::unordered_map<std::uint64_t, std::vector<int>> classes_by_hash;
+  classes_by_hash.reserve(trees.size());
+  for (int t = 0; t < static_cast<int>(trees.size()); ++t) {
+    std::vector<int>& candidates = classes_by_hash[hash(trees[t])];
+    int class_id = -1;
+    for (int c : candidates) {
+      if (equal(trees[representatives_[c]], trees[t])) {
+        class_id = c;
+        break;
+      }
+    }
+    const int kSize = trees[t].get_tree_size();
+    if (class_id == -1) {
+      class_id = static_cast<int>(representatives_.size());
+      candidates.push_back(class_id);
+      representatives_.push_back(t);
+      members_.emplace_back();
+      stats_.representative_nodes += kSize;
+    }
+    class_of_[t] = class_id;
+    members_[class_id].push_back(t);
+    stats_.nodes += kSize;
+  }
+
+  stats_.trees = trees.size();
+  stats_.classes = representatives_.size();
+  if (stats_.classes > 0) {
+    stats_.collapse_ratio = static_cast<double>(stats_.trees) / stats_.classes;
+  }
+}
+
+template <typename Label>
+int DuplicateClasses<Label>::get_class(int tree) const {
+  return class_of_[tree];
+}
+
+template <typename Label>
+int DuplicateClasses<Label>::get_class_count() const {
+  return static_cast<int>(representatives_.size());
+}
+
+template <typename Label>
+const std::vector<int>& DuplicateClasses<Label>::get_representatives() const {
+  return representatives_;
+}
+
+template <typename Label>
+const std::vector<int>& DuplicateClasses<Label>::get_members(
+    int class_id) const {
+  return members_[class_id];
+}
+
+template <typename Label>
+typename DuplicateClasses<Label>::Statistics
+DuplicateClasses<Label>::get_statistics() const {
+  return stats_;
+}
+
+template <typename Label>
+template <typename Distance>
+data_structures::Matrix<double> DuplicateClasses<Label>::distance_matrix(
+    const std::vector<node::Node<Label>>& trees, Distance distance) const {
+  const int kClasses = get_class_count();
+  data_structures::Matrix<double> class_distances(kClasses, kClasses);
+  for (int a = 0; a < kClasses; ++a) {
+    for (int b = 0; b < kClasses; ++b) {
+      class_distances.at(a, b) = a == b ? 0.0 :
+          distance(trees[representatives_[a]], trees[representatives_[b]]);
+    }
+  }
+
+  const int kTrees = static_cast<int>(class_of_.size());
+  data_structures::Matrix<double> distances(kTrees, kTrees);
+  for (int i = 0; i < kTrees; ++i) {
+    for (int j = 0; j < kTrees; ++j) {
+      distances.at(i, j) = class_distances.at(class_of_[i], class_of_[j]);
+    }
+  }
+  return distances;
+}
+
+template <typename Label>
+template <typename Distance>
+std::vector<typename DuplicateClasses<Label>::JoinPair>
+DuplicateClasses<Label>::join(const std::vector<node::Node<Label>>& trees,
+                              double threshold, Distance distance) const {
+  // Pairs of trees of one class are at distance 0, pairs of two classes at
+  // the distance of the representatives. Only the members of class pairs
+  // within the threshold are enumerated.
+  std::vector<JoinPair> pairs;
+  const int kClasses = get_class_count();
+  for (int a = 0; a < kClasses; ++a) {
+    for (int b = a; b < kClasses; ++b) {
+      const double kDistance = a == b ? 0.0 :
+          distance(trees[representatives_[a]], trees[representatives_[b]]);
+      if (!(kDistance <= threshold)) {
+        continue;
+      }
+      for (int i : members_[a]) {
+        for (int j : members_[b]) {
+          if (a != b || i < j) {
+            pairs.push_back(JoinPair{std::min(i, j), std::max(i, j),
+                                     kDistance});
+          }
+        }
+      }
+    }
+  }
+  std::sort(pairs.begin(), pairs.end(),
+            [](const JoinPair& p1, const JoinPair& p2) {
+              return p1.tree1 < p2.tree1 ||
+                     (p1.tree1 == p2.tree1 && p1.tree2 < p2.tree2);
+            });
+  return pairs;
+}
+
+template <typename Label>
+std::uint64_t DuplicateClasses<Label>::hash(const node::Node<Label>& tree) {
+  std::uint64_t h = data_structures::mix_hash(
+      std::hash<Label>()(tree.label()) + tree.get_children().size());
+  for (const auto& child : tree.get_children()) {
+    h = data_structures::mix_hash(h + hash(child));
+  }
+  return h;
+}
+
+template <typename Label>
+bool DuplicateClasses<Label>::equal(const node::Node<Label>& t1,
+                                    const node::Node<Label>& t2) {
+  if (!(t1.label() == t2.label()) ||
+      t1.get_children().size() != t2.get_children().size()) {
+    return false;
+  }
+  for (std::size_t c = 0; c < t1.get_children().size(); ++c) {
+    if (!equal(t1.get_children()[c], t2.get_children()[c])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+#endif // TREE_SIMILARITY_COLLECTION_DUPLICATE_CLASSES_IMPL_H
@@ -0,0 +1,126 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+/// \file constrained_ted/constrained_ted.h
+///
+/// \details
+/// Implements the constrained tree edit distance algorithm by Zhang.
+/// K.Zhang. A constrained edit distance between unordered labeled trees.
+/// Algorithmica 1996. The algorithm is applied to ordered trees.
+///
+/// In a constrained edit mapping, disjoint subtrees are mapped to disjoint
+/// subtrees. The constrained distance is thus an upper bound of the tree edit
+/// distance and is computed in O(|T1||T2|) time and space.
+
+#ifndef TREE_SIMILARITY_CONSTRAINED_TED_CONSTRAINED_TED_H
+#define TREE_SIMILARITY_CONSTRAINED_TED_CONSTRAINED_TED_H
+
+#include <algorithm>
+#include <vector>
+#include "node.h"
+#include "matrix.h"
+#include "tree_index.h"
+#include "cost_model_traits.h"
+
+namespace constrained_ted {
+
+template <typename Label, typename CostModel>
+class Algorithm {
+// Member functions.
+public:
+  /// Constructor. Creates the cost model based on the template.
+  Algorithm();
+  /// Constructor. Uses a copy of a configured cost model.
+  ///
+  /// \param c The cost model.
+  Algorithm(const CostModel& c);
+  /// Computes the constrained tree edit distance between two trees.
+  ///
+  /// \param t1 Source tree.
+  /// \param t2 Destination tree.
+  /// \return Constrained tree edit distance value.
+  double constrained_ted(const node::Node<Label>& t1,
+                         const node::Node<Label>& t2);
+  /// Computes the constrained tree edit distance between the trees rooted at
+  /// two DAG nodes. The trees are indexed directly from the DAGs without
+  /// materializing them as nodes.
+  ///
+  /// \param dag1 DAG holding the source tree.
+  /// \param root1 Id of the source tree root in dag1.
+  /// \param dag2 DAG holding the destination tree.
+  /// \param root2 Id of the destination tree root in dag2.
+  /// \return Constrained tree edit distance value.
+  double constrained_ted(const tree_index::TreeDag<Label>& dag1, int root1,
+                         const tree_index::TreeDag<Label>& dag2, int root2);
+// Types and type aliases.
+private:
+  /// Type of the stored distances (see CostModelTraits).
+  using CostType = typename cost_model::CostModelTraits<CostModel>::CostType;
+// Member variables.
+private:
+  /// Index of the source tree.
+  tree_index::TreeIndex<Label> t1_;
+  /// Index of the destination tree.
+  tree_index::TreeIndex<Label> t2_;
+  /// Cost of deleting the subtree rooted at each source node. Indexed in
+  /// postorder-1.
+  std::vector<CostType> t1_del_tree_;
+  /// Cost of deleting the children forest of each source node. Indexed in
+  /// postorder-1.
+  std::vector<CostType> t1_del_forest_;
+  /// Cost of inserting the subtree rooted at each destination node. Indexed in
+  /// postorder-1.
+  std::vector<CostType> t2_ins_tree_;
+  /// Cost of inserting the children forest of each destination node. Indexed
+  /// in postorder-1.
+  std::vector<CostType> t2_ins_forest_;
+  /// Constrained distances between subtrees.
+  data_structures::Matrix<CostType> dt_;
+  /// Constrained distances between the children forests of two nodes.
+  data_structures::Matrix<CostType> df_;
+  /// Edit distance between the children sequences of two nodes.
+  data_structures::Matrix<CostType> e_;
+  /// Cost model.
+  const CostModel c_;
+// Member functions.
+private:
+  /// Computes the constrained tree edit distance between the indexed trees t1_
+  /// and t2_.
+  ///
+  /// \return Constrained tree edit distance value.
+  double compute_distance();
+  /// Computes the edit distance between the sequences of children subtrees
+  /// of two nodes with the subtree distances as rename costs.
+  ///
+  /// \param i Postorder id of the source node.
+  /// \param j Postorder id of the destination node.
+  /// \return Distance between the children forests mapped in order.
+  CostType children_sequence_distance(int i, int j);
+};
+
+// Implementation details.
+#include "constrained_ted_impl.h"
+
+}
+
+#endif // TREE_SIMILARITY_CONSTRAINED_TED_CONSTRAINED_TED_H
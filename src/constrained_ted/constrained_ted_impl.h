@@ -0,0 +1,149 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+/// \file constrained_ted/constrained_ted_impl.h
+///
+/// \details
+/// Contains the implementation of the constrained tree edit distance.
+
+#ifndef TREE_SIMILARITY_CONSTRAINED_TED_CONSTRAINED_TED_IMPL_H
+#define TREE_SIMILARITY_CONSTRAINED_TED_CONSTRAINED_TED_IMPL_H
+
+template <typename Label, typename CostModel>
+Algorithm<Label, CostModel>::Algorithm() : c_() {}
+
+template <typename Label, typename CostModel>
+Algorithm<Label, CostModel>::Algorithm(const CostModel& c) : c_(c) {}
+
+template <typename Label, typename CostModel>
+double Algorithm<Label, CostModel>::constrained_ted(
+    const node::Node<Label>& t1, const node::Node<Label>& t2) {
+  t1_.index(t1);
+  t2_.index(t2);
+  return compute_distance();
+}
+
+template <typename Label, typename CostModel>
+double Algorithm<Label, CostModel>::constrained_ted(
+    const tree_index::TreeDag<Label>& dag1, int root1,
+    const tree_index::TreeDag<Label>& dag2, int root2) {
+  t1_.index(dag1, root1);
+  t2_.index(dag2, root2);
+  return compute_distance();
+}
+
+template <typename Label, typename CostModel>
+double Algorithm<Label, CostModel>::compute_distance() {
+  tree_index::subtree_costs(
+      t1_, [this](const node::Node<Label>& n) { return c_.del(n); },
+      t1_del_tree_, t1_del_forest_);
+  tree_index::subtree_costs(
+      t2_, [this](const node::Node<Label>& n) { return c_.ins(n); },
+      t2_ins_tree_, t2_ins_forest_);
+  const int kT1Size = t1_.size();
+  const int kT2Size = t2_.size();
+  dt_.resize(kT1Size+1, kT2Size+1);
+  df_.resize(kT1Size+1, kT2Size+1);
+
+  // Both loops in postorder, thus the distances of all pairs of children are
+  // known.
+  for (int i = 1; i <= kT1Size; ++i) {
+    const int kIChildren = t1_.children_count(i);
+    for (int j = 1; j <= kT2Size; ++j) {
+      const int kJChildren = t2_.children_count(j);
+
+      // Distance between the children forests:
+      // (1) the forest of i is mapped into the forest of a child of j,
+      // (2) the forest of a child of i is mapped into the forest of j,
+      // (3) the children of i are mapped to the children of j in order.
+      CostType forest = children_sequence_distance(i, j);
+      for (int t = 0; t < kJChildren; ++t) {
+        const int kJt = t2_.child(j, t);
+        forest = std::min(forest, t2_ins_forest_[j - 1] + df_.at(i, kJt) -
+                                      t2_ins_forest_[kJt - 1]);
+      }
+      for (int s = 0; s < kIChildren; ++s) {
+        const int kIs = t1_.child(i, s);
+        forest = std::min(forest, t1_del_forest_[i - 1] + df_.at(kIs, j) -
+                                      t1_del_forest_[kIs - 1]);
+      }
+      df_.at(i, j) = forest;
+
+      // Distance between the subtrees:
+      // (1) the subtree of i is mapped into the subtree of a child of j,
+      // (2) the subtree of a child of i is mapped into the subtree of j,
+      // (3) i is mapped to j and their forests are mapped.
+      CostType tree = forest + c_.ren(t1_.node(i), t2_.node(j));
+      for (int t = 0; t < kJChildren; ++t) {
+        const int kJt = t2_.child(j, t);
+        tree = std::min(tree, t2_ins_tree_[j - 1] + dt_.at(i, kJt) -
+                                  t2_ins_tree_[kJt - 1]);
+      }
+      for (int s = 0; s < kIChildren; ++s) {
+        const int kIs = t1_.child(i, s);
+        tree = std::min(tree, t1_del_tree_[i - 1] + dt_.at(kIs, j) -
+                                  t1_del_tree_[kIs - 1]);
+      }
+      dt_.at(i, j) = tree;
+    }
+  }
+
+  return dt_.at(kT1Size, kT2Size);
+}
+
+template <typename Label, typename CostModel>
+typename Algorithm<Label, CostModel>::CostType
+Algorithm<Label, CostModel>::children_sequence_distance(int i, int j) {
+  const int kIChildren = t1_.children_count(i);
+  const int kJChildren = t2_.children_count(j);
+  if (kIChildren == 0) {
+    return t2_ins_forest_[j - 1];
+  }
+  if (kJChildren == 0) {
+    return t1_del_forest_[i - 1];
+  }
+  if (e_.get_rows() < static_cast<std::size_t>(kIChildren + 1) ||
+      e_.get_columns() < static_cast<std::size_t>(kJChildren + 1)) {
+    e_.resize(std::max<std::size_t>(e_.get_rows(), kIChildren + 1),
+              std::max<std::size_t>(e_.get_columns(), kJChildren + 1));
+  }
+  e_.at(0, 0) = 0;
+  for (int s = 1; s <= kIChildren; ++s) {
+    e_.at(s, 0) = e_.at(s - 1, 0) + t1_del_tree_[t1_.child(i, s - 1) - 1];
+  }
+  for (int t = 1; t <= kJChildren; ++t) {
+    e_.at(0, t) = e_.at(0, t - 1) + t2_ins_tree_[t2_.child(j, t - 1) - 1];
+  }
+  for (int s = 1; s <= kIChildren; ++s) {
+    const int kIs = t1_.child(i, s - 1);
+    for (int t = 1; t <= kJChildren; ++t) {
+      const int kJt = t2_.child(j, t - 1);
+      e_.at(s, t) = std::min({e_.at(s - 1, t) + t1_del_tree_[kIs - 1],
+                              e_.at(s, t - 1) + t2_ins_tree_[kJt - 1],
+                              e_.at(s - 1, t - 1) + dt_.at(kIs, kJt)});
+    }
+  }
+  return e_.at(kIChildren, kJChildren);
+}
+
+#endif // TREE_SIMILARITY_CONSTRAINED_TED_CONSTRAINED_TED_IMPL_H
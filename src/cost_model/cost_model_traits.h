@@ -0,0 +1,99 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file cost_model/cost_model_traits.h
+///
+/// \details
+/// Contains the CostModelTraits class template. The TED algorithms query it at
+/// compile time to select specialized code paths for a cost model.
+
+#ifndef TREE_SIMILARITY_COST_MODEL_COST_MODEL_TRAITS_H
+#define TREE_SIMILARITY_COST_MODEL_COST_MODEL_TRAITS_H
+
+namespace cost_model {
+
+/// \struct DefaultCostModelTraits
+///
+/// \details
+/// Describes an arbitrary cost model with per-node cost functions. The
+/// specializations of CostModelTraits derive from it and override only the
+/// properties they announce.
+struct DefaultCostModelTraits {
+  /// True if the costs depend on node labels only and the cost model provides
+  /// the overloads ren(label1, label2), del(label), and ins(label). The
+  /// algorithms then compute the rename cost once per distinct pair of labels
+  /// instead of once per pair of nodes.
+  static constexpr bool kLabelBased = false;
+
+  /// True if renaming a node to an equal label costs 0 and all costs are
+  /// non-negative, i.e., the distance between identical trees is 0. Implied
+  /// by kConstantCosts.
+  static constexpr bool kEqualLabelsFree = false;
+
+  /// True if deleting any node costs kDeleteCost, inserting any node costs
+  /// kInsertCost, and renaming a node costs 0 for equal labels and kRenameCost
+  /// otherwise. The algorithms then fold the constants into the DP, compare
+  /// interned label ids instead of calling the cost functions, and require a
+  /// specialization of std::hash for the label type.
+  static constexpr bool kConstantCosts = false;
+  /// Constant costs. Meaningful only if kConstantCosts is true.
+  static constexpr int kDeleteCost = 1;
+  static constexpr int kInsertCost = 1;
+  static constexpr int kRenameCost = 1;
+
+  /// Type used by the algorithms to store and accumulate distances. An
+  /// integer type can be used if all costs are integers.
+  using CostType = double;
+};
+
+/// \struct CostModelTraits
+///
+/// \details
+/// Describes properties of a cost model (see DefaultCostModelTraits). A cost
+/// model specializes this template to announce additional properties.
+///
+/// \tparam CostModel The cost model described.
+template <class CostModel>
+struct CostModelTraits : DefaultCostModelTraits {};
+
+/// \struct ConstantCostValues
+///
+/// \details
+/// Holds the constant costs of a cost model with kConstantCosts as values of
+/// its CostType. The algorithms read these copies, the traits' constants
+/// must not be odr-used.
+///
+/// \tparam CostModel The cost model.
+template <class CostModel>
+struct ConstantCostValues {
+  using Traits = CostModelTraits<CostModel>;
+  /// Cost of deleting any node.
+  typename Traits::CostType del = Traits::kDeleteCost;
+  /// Cost of inserting any node.
+  typename Traits::CostType ins = Traits::kInsertCost;
+  /// Cost of renaming a node to a different label.
+  typename Traits::CostType ren = Traits::kRenameCost;
+};
+
+}
+
+#endif // TREE_SIMILARITY_COST_MODEL_COST_MODEL_TRAITS_H
@@ -0,0 +1,118 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file cost_model/string_edit_distance_cost_model.h
+///
+/// \details
+/// Contains the declaration of a cost model for fuzzy labels: renaming costs
+/// the normalized string edit distance between the labels.
+
+#ifndef TREE_SIMILARITY_COST_MODEL_STRING_EDIT_DISTANCE_COST_MODEL_H
+#define TREE_SIMILARITY_COST_MODEL_STRING_EDIT_DISTANCE_COST_MODEL_H
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "node.h"
+#include "cost_model_traits.h"
+
+namespace cost_model {
+
+/// Computes the edit distance (Levenshtein distance, unit costs) between two
+/// strings with the bit-parallel algorithm of Myers (G. Myers. A fast
+/// bit-vector algorithm for approximate string matching based on dynamic
+/// programming. J. ACM 1999) in the formulation of Hyyrö for the global
+/// distance (H. Hyyrö. A bit-vector algorithm for computing Levenshtein and
+/// Damerau edit distances. Nordic J. of Computing 2003). The shorter string is
+/// encoded in ceil(length/64) machine words, i.e., the running time is
+/// O(ceil(m/64) * n) for lengths m <= n.
+///
+/// \param s1 First string.
+/// \param s2 Second string.
+/// \return Edit distance between s1 and s2.
+int string_edit_distance(const std::string& s1, const std::string& s2);
+
+/// \class StringEditDistanceCostModel
+///
+/// \details
+/// Cost model where deleting and inserting a node costs 1 and renaming costs
+/// the string edit distance of the labels divided by the length of the longer
+/// label, i.e., a value in [0, 1]. The costs depend on labels only (see
+/// CostModelTraits), thus the TED algorithms compute the rename cost once per
+/// distinct pair of labels.
+///
+/// \tparam Label Label type. Requires the member function to_string().
+template <class Label>
+struct StringEditDistanceCostModel {
+  /// Rename cost function on nodes.
+  ///
+  /// \param node1 The node to be renamed.
+  /// \param node2 The node having the desired name.
+  /// \return Normalized string edit distance between the labels.
+  double ren(const node::Node<Label>& node1, const node::Node<Label>& node2) const;
+
+  /// Delete cost function on nodes.
+  ///
+  /// \param node The node to be deleted.
+  /// \return Cost of deleting node.
+  double del(const node::Node<Label>& node) const;
+
+  /// Insert cost function on nodes.
+  ///
+  /// \param node The node to be inserted.
+  /// \return Cost of inserting node.
+  double ins(const node::Node<Label>& node) const;
+
+  /// Rename cost function on labels.
+  ///
+  /// \param label1 The label to be renamed.
+  /// \param label2 The desired label.
+  /// \return Normalized string edit distance between the labels.
+  double ren(const Label& label1, const Label& label2) const;
+
+  /// Delete cost function on labels.
+  ///
+  /// \param label The label of the node to be deleted.
+  /// \return Cost of deleting a node with this label.
+  double del(const Label& label) const;
+
+  /// Insert cost function on labels.
+  ///
+  /// \param label The label of the node to be inserted.
+  /// \return Cost of inserting a node with this label.
+  double ins(const Label& label) const;
+};
+
+template <class Label>
+struct CostModelTraits<StringEditDistanceCostModel<Label>>
+    : DefaultCostModelTraits {
+  static constexpr bool kLabelBased = true;
+  static constexpr bool kEqualLabelsFree = true;
+};
+
+// Implementational details
+#include "string_edit_distance_cost_model_impl.h"
+
+}
+
+#endif // TREE_SIMILARITY_COST_MODEL_STRING_EDIT_DISTANCE_COST_MODEL_H
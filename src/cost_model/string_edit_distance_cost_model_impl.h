@@ -0,0 +1,131 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file cost_model/string_edit_distance_cost_model_impl.h
+///
+/// \details
+/// Contains the implementation of the string edit distance cost model.
+
+#ifndef TREE_SIMILARITY_COST_MODEL_STRING_EDIT_DISTANCE_COST_MODEL_IMPL_H
+#define TREE_SIMILARITY_COST_MODEL_STRING_EDIT_DISTANCE_COST_MODEL_IMPL_H
+
+inline int string_edit_distance(const std::string& s1, const std::string& s2) {
+  // The shorter string is the pattern encoded in bit-vectors, the longer one
+  // is the text scanned character by character.
+  const std::string& pattern = s1.size() <= s2.size() ? s1 : s2;
+  const std::string& text = s1.size() <= s2.size() ? s2 : s1;
+  const int m = pattern.size();
+  if (m == 0) {
+    return text.size();
+  }
+  const int kBlocks = (m + 63) / 64;
+  // Bit of the last pattern row in the last block.
+  const uint64_t kLastBit = uint64_t(1) << ((m - 1) % 64);
+
+  // peq[c * kBlocks + b] has bit k set iff pattern[64 * b + k] == c.
+  std::vector<uint64_t> peq(256 * kBlocks, 0);
+  for (int i = 0; i < m; ++i) {
+    peq[static_cast<unsigned char>(pattern[i]) * kBlocks + i / 64] |=
+        uint64_t(1) << (i % 64);
+  }
+  // Vertical deltas of the current column: +1 (pv) or -1 (mv), 0 otherwise.
+  // The first column is 0, 1, ..., m, i.e., all deltas are +1.
+  std::vector<uint64_t> pv(kBlocks, ~uint64_t(0));
+  std::vector<uint64_t> mv(kBlocks, 0);
+  int score = m;
+
+  for (const char c : text) {
+    const uint64_t* eq_column = &peq[static_cast<unsigned char>(c) * kBlocks];
+    // The first row is 0, 1, ..., n, i.e., the horizontal delta entering the
+    // first block is always +1.
+    int h_in = 1;
+    for (int b = 0; b < kBlocks; ++b) {
+      uint64_t eq = eq_column[b];
+      const uint64_t kHighBit = b == kBlocks - 1 ? kLastBit : uint64_t(1) << 63;
+      const uint64_t xv = eq | mv[b];
+      if (h_in < 0) {
+        eq |= 1;
+      }
+      const uint64_t xh = (((eq & pv[b]) + pv[b]) ^ pv[b]) | eq;
+      uint64_t ph = mv[b] | ~(xh | pv[b]);
+      uint64_t mh = pv[b] & xh;
+      int h_out = 0;
+      if (ph & kHighBit) {
+        h_out = 1;
+      } else if (mh & kHighBit) {
+        h_out = -1;
+      }
+      ph <<= 1;
+      mh <<= 1;
+      if (h_in < 0) {
+        mh |= 1;
+      } else if (h_in > 0) {
+        ph |= 1;
+      }
+      pv[b] = mh | ~(xv | ph);
+      mv[b] = ph & xv;
+      h_in = h_out;
+    }
+    score += h_in;
+  }
+  return score;
+}
+
+template <class Label>
+double StringEditDistanceCostModel<Label>::ren(const node::Node<Label>& node1,
+                                               const node::Node<Label>& node2) const {
+  return ren(node1.label(), node2.label());
+}
+
+template <class Label>
+double StringEditDistanceCostModel<Label>::del(const node::Node<Label>& node) const {
+  return del(node.label());
+}
+
+template <class Label>
+double StringEditDistanceCostModel<Label>::ins(const node::Node<Label>& node) const {
+  return ins(node.label());
+}
+
+template <class Label>
+double StringEditDistanceCostModel<Label>::ren(const Label& label1,
+                                               const Label& label2) const {
+  const std::string& s1 = label1.to_string();
+  const std::string& s2 = label2.to_string();
+  const std::size_t kLongest = std::max(s1.size(), s2.size());
+  if (kLongest == 0) {
+    return 0.0;
+  }
+  return static_cast<double>(string_edit_distance(s1, s2)) / kLongest;
+}
+
+template <class Label>
+double StringEditDistanceCostModel<Label>::del(const Label&) const {
+  return 1.0;
+}
+
+template <class Label>
+double StringEditDistanceCostModel<Label>::ins(const Label&) const {
+  return 1.0;
+}
+
+#endif // TREE_SIMILARITY_COST_MODEL_STRING_EDIT_DISTANCE_COST_MODEL_IMPL_H
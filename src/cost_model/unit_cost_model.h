@@ -28,6 +28,7 @@
 #define TREE_SIMILARITY_COST_MODEL_UNIT_COST_MODEL_H
 
 #include "node.h"
+#include "cost_model_traits.h"
 
 namespace cost_model {
 
@@ -64,6 +65,17 @@ struct UnitCostModel {
     int ins(const node::Node<Label>& node) const;
 };
 
+/// Unit costs are constant and integer, the algorithms use the specialized
+/// code paths for them.
+template <class Label>
+struct CostModelTraits<UnitCostModel<Label>> : DefaultCostModelTraits {
+  static constexpr bool kConstantCosts = true;
+  static constexpr int kDeleteCost = 1;
+  static constexpr int kInsertCost = 1;
+  static constexpr int kRenameCost = 1;
+  using CostType = int;
+};
+
 // Implementational details
 #include "unit_cost_model_impl.h"
 
@@ -0,0 +1,164 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file cost_model/weighted_cost_model.h
+///
+/// \details
+/// Contains the declaration of a table-driven cost model with per-label
+/// delete and insert costs and per-label-pair rename costs read from a file.
+
+#ifndef TREE_SIMILARITY_COST_MODEL_WEIGHTED_COST_MODEL_H
+#define TREE_SIMILARITY_COST_MODEL_WEIGHTED_COST_MODEL_H
+
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "node.h"
+#include "label_dictionary.h"
+#include "cost_model_traits.h"
+
+namespace cost_model {
+
+/// \class WeightedCostModel
+///
+/// \details
+/// Cost model with costs given per label. Without any costs read, it is
+/// equivalent to the unit cost model. The costs file consists of lines of the
+/// following forms (labels are quoted and escaped exactly as in the bracket
+/// notation, lines starting with '#' are comments):
+///
+///   default del COST
+///   default ins COST
+///   default ren COST
+///   del "LABEL" COST
+///   ins "LABEL" COST
+///   ren "LABEL1" "LABEL2" COST
+///
+/// Labels not listed use the default costs. Renaming a label to an equal label
+/// always costs 0.
+///
+/// The labels listed in the file are interned once and their costs are stored
+/// in dense arrays indexed by label ids. The cost model is label-based (see
+/// CostModelTraits), thus the TED algorithms look up the costs once per
+/// distinct label (pair) of the input trees and run the DP on arrays.
+///
+/// \tparam Label Label type. Requires a constructor from std::string and a
+///               specialization of std::hash.
+template <class Label>
+class WeightedCostModel {
+// Member functions
+public:
+  /// Rename cost function on nodes.
+  double ren(const node::Node<Label>& node1, const node::Node<Label>& node2) const;
+  /// Delete cost function on nodes.
+  double del(const node::Node<Label>& node) const;
+  /// Insert cost function on nodes.
+  double ins(const node::Node<Label>& node) const;
+
+  /// Rename cost function on labels.
+  ///
+  /// \param label1 The label to be renamed.
+  /// \param label2 The desired label.
+  /// \return Cost of renaming label1 to label2.
+  double ren(const Label& label1, const Label& label2) const;
+  /// Delete cost function on labels.
+  ///
+  /// \param label The label of the node to be deleted.
+  /// \return Cost of deleting a node with this label.
+  double del(const Label& label) const;
+  /// Insert cost function on labels.
+  ///
+  /// \param label The label of the node to be inserted.
+  /// \return Cost of inserting a node with this label.
+  double ins(const Label& label) const;
+
+  /// Reads costs from a file (see the class description for the format).
+  /// Costs read before are kept unless overridden.
+  ///
+  /// \param file_name Path to the costs file.
+  /// \return True on success. False if the file cannot be read or contains a
+  ///         malformed line, see get_error().
+  bool read_from_file(const std::string& file_name);
+
+  /// Checks if the costs are symmetric, i.e., every label costs the same to
+  /// delete and to insert and renaming label1 to label2 costs the same as
+  /// renaming label2 to label1. Only then the distance from T1 to T2 equals
+  /// the distance from T2 to T1.
+  ///
+  /// \return True if the costs are symmetric.
+  bool is_symmetric() const;
+
+  /// Describes the reason of the last failed read_from_file.
+  ///
+  /// \return Error message.
+  const std::string& get_error() const;
+
+// Member functions
+private:
+  /// Parses a single line of a costs file.
+  ///
+  /// \param line The line without the trailing newline.
+  /// \return True if the line is well-formed.
+  bool parse_line(const std::string& line);
+  /// Reads a quoted label starting at position pos of line and advances pos
+  /// past the closing quote.
+  ///
+  /// \return True if a quoted label was read.
+  bool parse_label(const std::string& line, std::size_t& pos,
+                   std::string& label) const;
+  /// Returns the id of label in labels_, inserting it and growing the cost
+  /// arrays if necessary.
+  int intern(const std::string& label);
+
+// Member variables
+private:
+  /// Default costs for labels not listed in the file.
+  double default_del_ = 1.0;
+  double default_ins_ = 1.0;
+  double default_ren_ = 1.0;
+  /// Labels listed in the costs file.
+  label::LabelDictionary<Label> labels_;
+  /// Delete and insert costs indexed by label id. NaN means the default.
+  std::vector<double> del_;
+  std::vector<double> ins_;
+  /// Rename costs of label pairs, keyed by the two label ids.
+  std::unordered_map<unsigned long long, double> ren_;
+  /// Error of the last failed read.
+  std::string error_;
+};
+
+template <class Label>
+struct CostModelTraits<WeightedCostModel<Label>> : DefaultCostModelTraits {
+  static constexpr bool kLabelBased = true;
+  static constexpr bool kEqualLabelsFree = true;
+};
+
+// Implementational details
+#include "weighted_cost_model_impl.h"
+
+}
+
+#endif // TREE_SIMILARITY_COST_MODEL_WEIGHTED_COST_MODEL_H
@@ -0,0 +1,224 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file cost_model/weighted_cost_model_impl.h
+///
+/// \details
+/// Contains the implementation of the table-driven weighted cost model.
+
+#ifndef TREE_SIMILARITY_COST_MODEL_WEIGHTED_COST_MODEL_IMPL_H
+#define TREE_SIMILARITY_COST_MODEL_WEIGHTED_COST_MODEL_IMPL_H
+
+template <class Label>
+double WeightedCostModel<Label>::ren(const node::Node<Label>& node1,
+                                     const node::Node<Label>& node2) const {
+  return ren(node1.label(), node2.label());
+}
+
+template <class Label>
+double WeightedCostModel<Label>::del(const node::Node<Label>& node) const {
+  return del(node.label());
+}
+
+template <class Label>
+double WeightedCostModel<Label>::ins(const node::Node<Label>& node) const {
+  return ins(node.label());
+}
+
+template <class Label>
+double WeightedCostModel<Label>::ren(const Label& label1,
+                                     const Label& label2) const {
+  if (label1 == label2) {
+    return 0.0;
+  }
+  const int kId1 = labels_.lookup(label1);
+  const int kId2 = labels_.lookup(label2);
+  if (kId1 >= 0 && kId2 >= 0) {
+    auto it = ren_.find(static_cast<unsigned long long>(kId1) << 32 | kId2);
+    if (it != ren_.end()) {
+      return it->second;
+    }
+  }
+  return default_ren_;
+}
+
+template <class Label>
+double WeightedCostModel<Label>::del(const Label& label) const {
+  const int kId = labels_.lookup(label);
+  if (kId < 0 || std::isnan(del_[kId])) {
+    return default_del_;
+  }
+  return del_[kId];
+}
+
+template <class Label>
+double WeightedCostModel<Label>::ins(const Label& label) const {
+  const int kId = labels_.lookup(label);
+  if (kId < 0 || std::isnan(ins_[kId])) {
+    return default_ins_;
+  }
+  return ins_[kId];
+}
+
+template <class Label>
+bool WeightedCostModel<Label>::read_from_file(const std::string& file_name) {
+  std::ifstream costs_file(file_name);
+  if (!costs_file.is_open()) {
+    error_ = "cannot open " + file_name;
+    return false;
+  }
+  int line_number = 0;
+  for (std::string line; std::getline(costs_file, line);) {
+    ++line_number;
+    if (!parse_line(line)) {
+      error_ = file_name + ":" + std::to_string(line_number) +
+               ": malformed line '" + line + "'";
+      return false;
+    }
+  }
+  return true;
+}
+
+template <class Label>
+bool WeightedCostModel<Label>::is_symmetric() const {
+  if (default_del_ != default_ins_) {
+    return false;
+  }
+  for (std::size_t id = 0; id < del_.size(); ++id) {
+    const double kDel = std::isnan(del_[id]) ? default_del_ : del_[id];
+    const double kIns = std::isnan(ins_[id]) ? default_ins_ : ins_[id];
+    if (kDel != kIns) {
+      return false;
+    }
+  }
+  for (const auto& ren : ren_) {
+    const unsigned long long kReverse = ren.first << 32 | ren.first >> 32;
+    auto it = ren_.find(kReverse);
+    if (kReverse != ren.first &&
+        ren.second != (it != ren_.end() ? it->second : default_ren_)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <class Label>
+const std::string& WeightedCostModel<Label>::get_error() const {
+  return error_;
+}
+
+template <class Label>
+bool WeightedCostModel<Label>::parse_line(const std::string& line) {
+  std::size_t pos = line.find_first_not_of(" \t\r");
+  if (pos == std::string::npos || line[pos] == '#') {
+    return true; // Empty line or comment.
+  }
+  std::size_t end = line.find_first_of(" \t", pos);
+  if (end == std::string::npos) {
+    return false;
+  }
+  std::string operation = line.substr(pos, end - pos);
+  pos = end;
+  const bool kDefault = operation == "default";
+  if (kDefault) {
+    pos = line.find_first_not_of(" \t", pos);
+    end = line.find_first_of(" \t", pos);
+    if (pos == std::string::npos || end == std::string::npos) {
+      return false;
+    }
+    operation = line.substr(pos, end - pos);
+    pos = end;
+  }
+  if (operation != "del" && operation != "ins" && operation != "ren") {
+    return false;
+  }
+
+  // Labels of a non-default line.
+  std::vector<std::string> labels;
+  const int kLabels = kDefault ? 0 : (operation == "ren" ? 2 : 1);
+  for (int i = 0; i < kLabels; ++i) {
+    std::string label;
+    pos = line.find_first_not_of(" \t", pos);
+    if (pos == std::string::npos || !parse_label(line, pos, label)) {
+      return false;
+    }
+    labels.push_back(label);
+  }
+
+  // The cost, optionally followed by a comment.
+  std::istringstream rest(line.substr(pos));
+  double cost;
+  std::string trailing;
+  if (!(rest >> cost) || cost < 0 || (rest >> trailing && trailing[0] != '#')) {
+    return false;
+  }
+
+  if (kDefault) {
+    if (operation == "del") default_del_ = cost;
+    if (operation == "ins") default_ins_ = cost;
+    if (operation == "ren") default_ren_ = cost;
+  } else if (operation == "del") {
+    del_[intern(labels[0])] = cost;
+  } else if (operation == "ins") {
+    ins_[intern(labels[0])] = cost;
+  } else {
+    const unsigned long long kId1 = intern(labels[0]);
+    const unsigned long long kId2 = intern(labels[1]);
+    ren_[kId1 << 32 | kId2] = cost;
+  }
+  return true;
+}
+
+template <class Label>
+bool WeightedCostModel<Label>::parse_label(const std::string& line,
+                                           std::size_t& pos,
+                                           std::string& label) const {
+  if (line[pos] != '"') {
+    return false;
+  }
+  label.clear();
+  for (++pos; pos < line.size(); ++pos) {
+    if (line[pos] == '\\' && pos + 1 < line.size()) {
+      // Escapes are kept, the bracket notation parser keeps them as well.
+      label += line[pos];
+      label += line[++pos];
+    } else if (line[pos] == '"') {
+      ++pos;
+      return true;
+    } else {
+      label += line[pos];
+    }
+  }
+  return false; // Missing closing quote.
+}
+
+template <class Label>
+int WeightedCostModel<Label>::intern(const std::string& label) {
+  const int kId = labels_.insert(Label(label));
+  if (kId == static_cast<int>(del_.size())) {
+    del_.push_back(std::numeric_limits<double>::quiet_NaN());
+    ins_.push_back(std::numeric_limits<double>::quiet_NaN());
+  }
+  return kId;
+}
+
+#endif // TREE_SIMILARITY_COST_MODEL_WEIGHTED_COST_MODEL_IMPL_H
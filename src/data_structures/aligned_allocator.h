@@ -0,0 +1,158 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file data_structures/aligned_allocator.h
+///
+/// \details
+/// Contains the AlignedAllocator class, an allocator for large dynamic
+/// programming tables. Memory is aligned to cache lines, large blocks are
+/// mapped from the operating system such that pages are zeroed on first
+/// touch only and may be backed by transparent huge pages.
+
+#ifndef TREE_SIMILARITY_DATA_STRUCTURES_ALIGNED_ALLOCATOR_H
+#define TREE_SIMILARITY_DATA_STRUCTURES_ALIGNED_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#define TREE_SIMILARITY_HAS_MMAP
+#endif
+
+namespace data_structures {
+
+/// \class AlignedAllocator
+///
+/// \details
+/// Allocates blocks aligned to kAlignment bytes. Blocks of at least
+/// kMapThreshold bytes are mapped anonymously where mmap is available: the
+/// kernel provides zeroed pages when they are first touched, thus untouched
+/// parts of a table cost neither time nor physical memory. On Linux, such
+/// blocks are advised to be backed by transparent huge pages, which reduces
+/// TLB misses on multi-GB tables.
+///
+/// Elements constructed without arguments are default-initialized instead of
+/// value-initialized, e.g., std::vector::resize does not write zeros to a
+/// new table of doubles. Their values are unspecified.
+template <typename T>
+class AlignedAllocator {
+public:
+  using value_type = T;
+  /// Alignment of every block in bytes, a cache line.
+  static constexpr std::size_t kAlignment = 64;
+  /// Minimum size in bytes of a block that is mapped instead of taken from
+  /// the heap, the size of a huge page on x86-64.
+  static constexpr std::size_t kMapThreshold = std::size_t(2) << 20;
+  template <typename U>
+  struct rebind {
+    using other = AlignedAllocator<U>;
+  };
+  AlignedAllocator() = default;
+  template <typename U>
+  AlignedAllocator(const AlignedAllocator<U>&) {}
+  /// Allocates memory for n elements.
+  ///
+  /// \param n Number of elements.
+  /// \return Pointer to the first element, aligned to kAlignment bytes.
+  /// \throws std::bad_alloc If n exceeds max_size() or no memory is left.
+  T* allocate(std::size_t n);
+  /// Returns the largest number of elements whose size in bytes, together
+  /// with the alignment padding of heap blocks, does not overflow.
+  std::size_t max_size() const {
+    return (SIZE_MAX - kAlignment) / sizeof(T);
+  }
+  /// Frees memory returned by allocate.
+  ///
+  /// \param p Pointer returned by allocate.
+  /// \param n Number of elements passed to allocate.
+  void deallocate(T* p, std::size_t n);
+  /// Default-initializes an element, i.e., leaves trivial types unwritten.
+  template <typename U>
+  void construct(U* p) {
+    ::new (static_cast<void*>(p)) U;
+  }
+  /// Constructs an element from arguments.
+  template <typename U, typename... Args>
+  void construct(U* p, Args&&... args) {
+    ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+  }
+};
+
+template <typename T, typename U>
+bool operator==(const AlignedAllocator<T>&, const AlignedAllocator<U>&) {
+  return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const AlignedAllocator<T>&, const AlignedAllocator<U>&) {
+  return false;
+}
+
+template <typename T>
+T* AlignedAllocator<T>::allocate(std::size_t n) {
+  if (n > max_size()) {
+    throw std::bad_alloc();
+  }
+  const std::size_t kBytes = n * sizeof(T);
+#ifdef TREE_SIMILARITY_HAS_MMAP
+  if (kBytes >= kMapThreshold) {
+    void* p = mmap(nullptr, kBytes, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+#ifdef MADV_HUGEPAGE
+    // Only advice, the kernel may ignore it.
+    madvise(p, kBytes, MADV_HUGEPAGE);
+#endif
+    return static_cast<T*>(p);
+  }
+#endif
+  // Over-allocate and store the offset to the start of the heap block right
+  // before the aligned address.
+  char* block = static_cast<char*>(::operator new(kBytes + kAlignment));
+  const std::size_t kOffset =
+      kAlignment - reinterpret_cast<std::uintptr_t>(block) % kAlignment;
+  char* aligned = block + kOffset;
+  *(aligned - 1) = static_cast<char>(kOffset);
+  return reinterpret_cast<T*>(aligned);
+}
+
+template <typename T>
+void AlignedAllocator<T>::deallocate(T* p, std::size_t n) {
+  const std::size_t kBytes = n * sizeof(T);
+#ifdef TREE_SIMILARITY_HAS_MMAP
+  if (kBytes >= kMapThreshold) {
+    munmap(p, kBytes);
+    return;
+  }
+#endif
+  char* aligned = reinterpret_cast<char*>(p);
+  ::operator delete(aligned - static_cast<unsigned char>(*(aligned - 1)));
+}
+
+}
+
+#endif // TREE_SIMILARITY_DATA_STRUCTURES_ALIGNED_ALLOCATOR_H
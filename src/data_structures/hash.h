@@ -0,0 +1,76 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file data_structures/hash.h
+///
+/// \details
+/// Contains the hash functions shared by the structural hashes of trees and
+/// the hash maps keyed by integer sequences.
+
+#ifndef TREE_SIMILARITY_DATA_STRUCTURES_HASH_H
+#define TREE_SIMILARITY_DATA_STRUCTURES_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace data_structures {
+
+/// Mixes the bits of a hash value (finalizer of splitmix64). Merkle-style
+/// hashes of trees combine a node with its children as
+/// h = mix_hash(h + child).
+///
+/// \param x The value.
+/// \return The mixed value.
+inline std::uint64_t mix_hash(std::uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+/// Combines a hash value into a seed, as boost::hash_combine.
+///
+/// \param seed The seed.
+/// \param value The hash value.
+/// \return The combined hash.
+inline std::size_t hash_combine(std::size_t seed, std::size_t value) {
+  return seed ^ (value + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
+
+/// Hashes a sequence of integers, e.g., a subtree given by its label id and
+/// the ids of its children.
+struct IntSequenceHash {
+  std::size_t operator()(const std::vector<int>& key) const {
+    std::size_t h = key.size();
+    for (int e : key) {
+      h = hash_combine(h, std::hash<int>()(e));
+    }
+    return h;
+  }
+};
+
+}
+
+#endif // TREE_SIMILARITY_DATA_STRUCTURES_HASH_H
@@ -37,28 +37,94 @@
 
 #include <memory>
 #include <vector>
+#include "aligned_allocator.h"
 
 namespace data_structures {
 
-template<typename ElementType>
+/// Allocation policy of a Matrix: elements are stored by std::allocator
+/// without gaps between the rows.
+struct DefaultMatrixPolicy {
+  /// Allocator of the elements.
+  template<typename ElementType>
+  using Allocator = std::allocator<ElementType>;
+  /// Returns the distance between the starts of two consecutive rows.
+  ///
+  /// \param columns The number of columns.
+  /// \return The row stride in elements.
+  template<typename ElementType>
+  static size_t row_stride(size_t columns) {
+    return columns;
+  }
+};
+
+/// Allocation policy of a Matrix for large dynamic programming tables:
+/// elements are stored by AlignedAllocator, i.e., cache-line aligned, lazily
+/// zeroed, and with huge-page advice for large tables. Rows of at least
+/// kPaddedRowBytes are padded to whole cache lines. If the resulting stride
+/// is a multiple of the page size, another cache line is added, otherwise
+/// the elements of one column map to few cache sets and evict each other
+/// when the table is traversed by columns.
+struct AlignedMatrixPolicy {
+  /// Minimum size of a row in bytes for padding.
+  static constexpr size_t kPaddedRowBytes = 4096;
+  /// Allocator of the elements.
+  template<typename ElementType>
+  using Allocator = AlignedAllocator<ElementType>;
+  /// Returns the distance between the starts of two consecutive rows.
+  ///
+  /// \param columns The number of columns.
+  /// \return The row stride in elements.
+  template<typename ElementType>
+  static size_t row_stride(size_t columns) {
+    const size_t kLine = AlignedAllocator<ElementType>::kAlignment;
+    const size_t kPage = 4096;
+    size_t bytes = columns * sizeof(ElementType);
+    if (bytes < kPaddedRowBytes || kLine % sizeof(ElementType) != 0) {
+      return columns;
+    }
+    bytes = (bytes + kLine - 1) / kLine * kLine;
+    if (bytes % kPage == 0) {
+      bytes += kLine;
+    }
+    return bytes / sizeof(ElementType);
+  }
+};
+
+/// \tparam Policy Allocation policy, DefaultMatrixPolicy or
+///         AlignedMatrixPolicy.
+template<typename ElementType, typename Policy = DefaultMatrixPolicy>
 class Matrix {
 // Member variables.
 private:
   /// Number of rows in the matrix.
-  size_t rows_;
+  size_t rows_ = 0;
   /// Number of columns in the matrix.
-  size_t columns_;
+  size_t columns_ = 0;
+  /// Distance between the starts of two consecutive rows in data_.
+  size_t stride_ = 0;
   /// Consecutive-allocated long vector containing the matrix elements.
-  std::vector<ElementType> data_;
+  std::vector<ElementType, typename Policy::template Allocator<ElementType>>
+      data_;
 // Member functions.
 public:
   /// Constructor(s).
   Matrix() = default; // Used while constructing ZS-Algorithm.
   Matrix(size_t rows, size_t columns);
+  /// Changes the dimensions of the matrix. The allocated memory is reused if
+  /// it is large enough, such that a matrix can serve as a workspace for many
+  /// consecutive computations. The contents after resizing are unspecified,
+  /// a matrix growing beyond its allocated memory does not copy them.
+  ///
+  /// \param rows The new number of rows.
+  /// \param columns The new number of columns.
+  void resize(size_t rows, size_t columns);
   /// Returns the number of rows.
   size_t get_rows() const;
   /// Returns the number of columns.
   size_t get_columns() const;
+  /// Returns the distance between the starts of two consecutive rows in
+  /// elements, i.e., the number of columns plus the row padding.
+  size_t get_stride() const;
   /// Accesses the element of specific row and column.
   ///
   /// \param row The row to be accessed.
@@ -66,29 +132,54 @@ public:
   ///
   /// \return Reference to the specified element.
   ElementType& at(size_t row, size_t col);
+  const ElementType& at(size_t row, size_t col) const;
 };
 
-template<typename ElementType>
-Matrix<ElementType>::Matrix(size_t rows, size_t columns)
-  : rows_(rows), columns_(columns)
+template<typename ElementType, typename Policy>
+Matrix<ElementType, Policy>::Matrix(size_t rows, size_t columns)
+  : rows_(rows), columns_(columns),
+    stride_(Policy::template row_stride<ElementType>(columns))
 {
-  data_.resize(rows_ * columns_);
+  data_.resize(rows_ * stride_);
 }
 
-template<typename ElementType>
-size_t Matrix<ElementType>::get_rows() const {
+template<typename ElementType, typename Policy>
+void Matrix<ElementType, Policy>::resize(size_t rows, size_t columns) {
+  rows_ = rows;
+  columns_ = columns;
+  stride_ = Policy::template row_stride<ElementType>(columns);
+  if (rows_ * stride_ > data_.capacity()) {
+    // Release first, the old contents need not be copied.
+    decltype(data_)().swap(data_);
+  }
+  data_.resize(rows_ * stride_);
+}
+
+template<typename ElementType, typename Policy>
+size_t Matrix<ElementType, Policy>::get_rows() const {
   return rows_;
 }
 
-template<typename ElementType>
-size_t Matrix<ElementType>::get_columns() const {
+template<typename ElementType, typename Policy>
+size_t Matrix<ElementType, Policy>::get_columns() const {
   return columns_;
 }
 
-template<typename ElementType>
-ElementType& Matrix<ElementType>::at(size_t row, size_t col) {
+template<typename ElementType, typename Policy>
+size_t Matrix<ElementType, Policy>::get_stride() const {
+  return stride_;
+}
+
+template<typename ElementType, typename Policy>
+ElementType& Matrix<ElementType, Policy>::at(size_t row, size_t col) {
   // NOTE: Using at() for checking bounds.
-  return data_.at(row * columns_ + col);
+  return data_.at(row * stride_ + col);
+}
+
+template<typename ElementType, typename Policy>
+const ElementType& Matrix<ElementType, Policy>::at(size_t row,
+                                                   size_t col) const {
+  return data_.at(row * stride_ + col);
 }
 
 } // namespace data_structures
@@ -0,0 +1,119 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file label/arena_label.h
+///
+/// \details
+/// Contains the declaration of the ArenaLabel class (represents a string
+/// label without a heap allocation per label). Short labels are stored inside
+/// the label, longer labels in a LabelArena shared by many labels.
+
+#ifndef TREE_SIMILARITY_LABEL_ARENA_LABEL_H
+#define TREE_SIMILARITY_LABEL_ARENA_LABEL_H
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include "label_arena.h"
+
+namespace label {
+
+/// \class ArenaLabel
+///
+/// \details
+/// Represents a string label in 24 bytes. Labels of up to kInlineCapacity
+/// characters are stored inline, longer labels point to the characters in a
+/// LabelArena. The hash of the string is computed once, so unequal labels
+/// are mostly told apart by comparing the hash and the size, and interning
+/// the labels does not read the characters again.
+///
+/// A label referring to an arena is valid as long as the arena. Labels are
+/// trivially copyable, so copying a tree does not copy any string.
+class ArenaLabel {
+public:
+    /// Maximum size of a label stored inline.
+    static constexpr std::size_t kInlineCapacity = 16;
+
+    /// Creates the label. Long labels are stored in the arena.
+    ///
+    /// \param label String representation of the label.
+    /// \param arena The arena holding long labels.
+    ArenaLabel(const std::string& label, LabelArena& arena);
+
+    /// Operator overloadings.
+    /// @{
+    bool operator==(const ArenaLabel& other) const;
+    /// @}
+
+    /// Returns the precomputed hash of the label (32-bit FNV-1a).
+    ///
+    /// \return The hash value.
+    std::uint32_t hash() const;
+
+    /// Returns the number of characters of the label.
+    ///
+    /// \return Size of the label.
+    std::size_t size() const;
+
+    /// Returns the characters of the label, not terminated by '\0'.
+    ///
+    /// \return Pointer to the characters.
+    const char* data() const;
+
+    /// Generates a string representation of the label.
+    ///
+    /// \return String representation of the label.
+    std::string to_string() const;
+
+private:
+    /// Hash of the label.
+    std::uint32_t hash_ = 0;
+
+    /// Number of characters of the label.
+    std::uint32_t size_ = 0;
+
+    /// The characters of a short label, or a pointer into the arena.
+    union {
+      char inline_[kInlineCapacity];
+      const char* data_;
+    };
+};
+
+// Implementation details
+#include "arena_label_impl.h"
+
+} // namespace label
+
+namespace std {
+
+/// Hashes an ArenaLabel by its precomputed hash. Needed for interning labels.
+template <>
+struct hash<label::ArenaLabel> {
+  size_t operator()(const label::ArenaLabel& label) const {
+    return label.hash();
+  }
+};
+
+} // namespace std
+
+#endif // TREE_SIMILARITY_LABEL_ARENA_LABEL_H
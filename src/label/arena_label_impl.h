@@ -0,0 +1,73 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file label/arena_label_impl.h
+///
+/// \details
+/// Contains the implementation of the ArenaLabel class.
+
+#ifndef TREE_SIMILARITY_LABEL_ARENA_LABEL_IMPL_H
+#define TREE_SIMILARITY_LABEL_ARENA_LABEL_IMPL_H
+
+inline ArenaLabel::ArenaLabel(const std::string& label, LabelArena& arena)
+    : size_(static_cast<std::uint32_t>(label.size())) {
+  // FNV-1a, 32-bit.
+  hash_ = 2166136261u;
+  for (char c : label) {
+    hash_ ^= static_cast<unsigned char>(c);
+    hash_ *= 16777619u;
+  }
+  if (label.size() <= kInlineCapacity) {
+    std::memcpy(inline_, label.data(), label.size());
+  } else {
+    data_ = arena.store(label.data(), label.size(), hash_);
+  }
+}
+
+inline bool ArenaLabel::operator==(const ArenaLabel& other) const {
+  if (hash_ != other.hash_ || size_ != other.size_) {
+    return false;
+  }
+  if (size_ <= kInlineCapacity) {
+    return std::memcmp(inline_, other.inline_, size_) == 0;
+  }
+  // Equal labels of one arena share the characters.
+  return data_ == other.data_ || std::memcmp(data_, other.data_, size_) == 0;
+}
+
+inline std::uint32_t ArenaLabel::hash() const {
+  return hash_;
+}
+
+inline std::size_t ArenaLabel::size() const {
+  return size_;
+}
+
+inline const char* ArenaLabel::data() const {
+  return size_ <= kInlineCapacity ? inline_ : data_;
+}
+
+inline std::string ArenaLabel::to_string() const {
+  return std::string(data(), size_);
+}
+
+#endif // TREE_SIMILARITY_LABEL_ARENA_LABEL_IMPL_H
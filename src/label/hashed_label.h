@@ -0,0 +1,98 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file label/hashed_label.h
+///
+/// \details
+/// Contains the declaration of the HashedLabel class (represents a string
+/// label by its 64-bit hash). Labels are compared in one instruction and
+/// take no memory besides the hash, at the price of a small probability that
+/// two different strings are considered equal.
+
+#ifndef TREE_SIMILARITY_LABEL_HASHED_LABEL_H
+#define TREE_SIMILARITY_LABEL_HASHED_LABEL_H
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+
+namespace label {
+
+/// \class HashedLabel
+///
+/// \details
+/// Represents a string label by its 64-bit FNV-1a hash. The hash does not
+/// depend on the platform, so hashed labels may be stored and compared across
+/// runs. For n distinct labels, the probability of a collision is about
+/// n^2 / 2^65, e.g., below 10^-7 for a million labels.
+class HashedLabel {
+public:
+    /// Hashes the string.
+    ///
+    /// \param label String representation of the label.
+    HashedLabel(const std::string& label);
+
+    /// Constructs the label from a hash value.
+    ///
+    /// \param hash The hash value.
+    explicit HashedLabel(std::uint64_t hash);
+
+    /// Operator overloadings.
+    /// @{
+    bool operator==(const HashedLabel& other) const;
+    /// @}
+
+    /// Returns the hash of the label.
+    ///
+    /// \return The hash value.
+    std::uint64_t hash() const;
+
+    /// Generates a string representation of the label. The string cannot be
+    /// recovered, the hash is printed as 16 hexadecimal digits.
+    ///
+    /// \return String representation of the hash.
+    std::string to_string() const;
+
+private:
+    /// The hash of the label associated with a node.
+    std::uint64_t hash_ = 0;
+};
+
+// Implementation details
+#include "hashed_label_impl.h"
+
+} // namespace label
+
+namespace std {
+
+/// Hashes a HashedLabel by its hash value. Needed for interning labels.
+template <>
+struct hash<label::HashedLabel> {
+  size_t operator()(const label::HashedLabel& label) const {
+    return static_cast<size_t>(label.hash());
+  }
+};
+
+} // namespace std
+
+#endif // TREE_SIMILARITY_LABEL_HASHED_LABEL_H
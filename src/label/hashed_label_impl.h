@@ -0,0 +1,57 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file label/hashed_label_impl.h
+///
+/// \details
+/// Contains the implementation of the HashedLabel class.
+
+#ifndef TREE_SIMILARITY_LABEL_HASHED_LABEL_IMPL_H
+#define TREE_SIMILARITY_LABEL_HASHED_LABEL_IMPL_H
+
+inline HashedLabel::HashedLabel(const std::string& label) {
+  // FNV-1a, 64-bit.
+  hash_ = 14695981039346656037ULL;
+  for (char c : label) {
+    hash_ ^= static_cast<unsigned char>(c);
+    hash_ *= 1099511628211ULL;
+  }
+}
+
+inline HashedLabel::HashedLabel(std::uint64_t hash) : hash_(hash) {}
+
+inline bool HashedLabel::operator==(const HashedLabel& other) const {
+  return hash_ == other.hash_;
+}
+
+inline std::uint64_t HashedLabel::hash() const {
+  return hash_;
+}
+
+inline std::string HashedLabel::to_string() const {
+  char buffer[17];
+  std::snprintf(buffer, sizeof(buffer), "%016llx",
+                static_cast<unsigned long long>(hash_));
+  return std::string(buffer);
+}
+
+#endif // TREE_SIMILARITY_LABEL_HASHED_LABEL_IMPL_H
@@ -0,0 +1,105 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file label/int_label.h
+///
+/// \details
+/// Contains the declaration of the IntLabel class (represents an integer
+/// associated with a Node). Parsing a corpus with integer labels to IntLabel
+/// avoids allocating a string per node and compares labels in one
+/// instruction.
+
+#ifndef TREE_SIMILARITY_LABEL_INT_LABEL_H
+#define TREE_SIMILARITY_LABEL_INT_LABEL_H
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <stdexcept>
+#include <string>
+
+namespace label {
+
+/// \class IntLabel
+///
+/// \details
+/// Represents a 64-bit signed integer label. The string constructor makes the
+/// label usable with BasicBracketNotationParser.
+class IntLabel {
+public:
+    /// Parses a decimal integer. Leading whitespace and a sign are accepted.
+    ///
+    /// \param label String representation of the label.
+    /// \throws std::invalid_argument If the string is not an integer.
+    /// \throws std::out_of_range If the integer does not fit 64 bits.
+    IntLabel(const std::string& label);
+
+    /// Constructs the label from its value.
+    ///
+    /// \param value The value.
+    explicit IntLabel(std::int64_t value);
+
+    /// Operator overloadings.
+    /// @{
+    bool operator==(const IntLabel& other) const;
+    /// @}
+
+    /// Returns the value of the label.
+    ///
+    /// \return The value.
+    std::int64_t value() const;
+
+    /// Generates a string representation of the label.
+    ///
+    /// \return String representation of the label.
+    std::string to_string() const;
+
+private:
+    /// The label to be associated with a node.
+    std::int64_t value_ = 0;
+
+    /// Parses a decimal integer, see the string constructor.
+    ///
+    /// \param label String representation of the label.
+    /// \return The value.
+    static std::int64_t parse(const std::string& label);
+};
+
+// Implementation details
+#include "int_label_impl.h"
+
+} // namespace label
+
+namespace std {
+
+/// Hashes an IntLabel by its value. Needed for interning labels.
+template <>
+struct hash<label::IntLabel> {
+  size_t operator()(const label::IntLabel& label) const {
+    return hash<int64_t>()(label.value());
+  }
+};
+
+} // namespace std
+
+#endif // TREE_SIMILARITY_LABEL_INT_LABEL_H
@@ -0,0 +1,61 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file label/int_label_impl.h
+///
+/// \details
+/// Contains the implementation of the IntLabel class.
+
+#ifndef TREE_SIMILARITY_LABEL_INT_LABEL_IMPL_H
+#define TREE_SIMILARITY_LABEL_INT_LABEL_IMPL_H
+
+inline IntLabel::IntLabel(const std::string& label) : value_(parse(label)) {}
+
+inline IntLabel::IntLabel(std::int64_t value) : value_(value) {}
+
+inline bool IntLabel::operator==(const IntLabel& other) const {
+  return value_ == other.value_;
+}
+
+inline std::int64_t IntLabel::value() const {
+  return value_;
+}
+
+inline std::string IntLabel::to_string() const {
+  return std::to_string(value_);
+}
+
+inline std::int64_t IntLabel::parse(const std::string& label) {
+  const char* begin = label.c_str();
+  char* end = nullptr;
+  errno = 0;
+  const long long kValue = std::strtoll(begin, &end, 10);
+  if (end == begin || *end != '\0') {
+    throw std::invalid_argument("Not an integer label: '" + label + "'");
+  }
+  if (errno == ERANGE) {
+    throw std::out_of_range("Integer label out of range: '" + label + "'");
+  }
+  return kValue;
+}
+
+#endif // TREE_SIMILARITY_LABEL_INT_LABEL_IMPL_H
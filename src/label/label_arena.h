@@ -0,0 +1,92 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file label/label_arena.h
+///
+/// \details
+/// Contains the declaration of the LabelArena class. A LabelArena stores the
+/// characters of many labels in large chunks instead of one heap allocation
+/// per label (see ArenaLabel).
+
+#ifndef TREE_SIMILARITY_LABEL_LABEL_ARENA_H
+#define TREE_SIMILARITY_LABEL_LABEL_ARENA_H
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace label {
+
+/// \class LabelArena
+///
+/// \details
+/// Append-only storage of label strings. Strings are never moved, so pointers
+/// returned by store() are valid until the arena is destroyed or cleared.
+/// Equal strings are stored once. An arena is meant to be owned by a tree or
+/// a collection of trees and must outlive all labels referring to it.
+class LabelArena {
+public:
+  /// Size of a chunk of the arena. Longer strings get a chunk of their own.
+  static constexpr std::size_t kChunkSize = 1 << 16;
+
+  /// Stores a string unless an equal string is already stored.
+  ///
+  /// \param data Characters of the string.
+  /// \param size Number of characters.
+  /// \param hash Hash of the string, used to find an equal string.
+  /// \return Pointer to the stored characters.
+  const char* store(const char* data, std::size_t size, std::uint32_t hash);
+
+  /// Returns the number of bytes allocated for strings.
+  ///
+  /// \return Number of allocated bytes.
+  std::size_t allocated_bytes() const;
+
+  /// Releases all strings. Labels referring to the arena become invalid.
+  void clear();
+
+private:
+  /// Chunks holding the strings.
+  std::vector<std::unique_ptr<char[]>> chunks_;
+
+  /// The chunk short strings are appended to.
+  char* current_ = nullptr;
+
+  /// Number of bytes used in the current chunk.
+  std::size_t used_ = kChunkSize;
+
+  /// Number of bytes allocated in all chunks.
+  std::size_t allocated_ = 0;
+
+  /// The first stored string for every hash. Strings whose hash collides with
+  /// a different string are stored again.
+  std::unordered_map<std::uint32_t, const char*> stored_;
+};
+
+// Implementation details
+#include "label_arena_impl.h"
+
+} // namespace label
+
+#endif // TREE_SIMILARITY_LABEL_LABEL_ARENA_H
@@ -0,0 +1,80 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file label/label_arena_impl.h
+///
+/// \details
+/// Contains the implementation of the LabelArena class.
+
+#ifndef TREE_SIMILARITY_LABEL_LABEL_ARENA_IMPL_H
+#define TREE_SIMILARITY_LABEL_LABEL_ARENA_IMPL_H
+
+inline const char* LabelArena::store(const char* data, std::size_t size,
+                                     std::uint32_t hash) {
+  // Strings are prefixed with their size to compare with a stored string.
+  auto found = stored_.find(hash);
+  if (found != stored_.end()) {
+    std::uint32_t stored_size = 0;
+    std::memcpy(&stored_size, found->second - sizeof(stored_size),
+                sizeof(stored_size));
+    if (stored_size == size && std::memcmp(found->second, data, size) == 0) {
+      return found->second;
+    }
+  }
+  const std::size_t kBytes = sizeof(std::uint32_t) + size;
+  char* destination = nullptr;
+  if (kBytes > kChunkSize) {
+    chunks_.emplace_back(new char[kBytes]);
+    destination = chunks_.back().get();
+    allocated_ += kBytes;
+  } else {
+    if (used_ + kBytes > kChunkSize) {
+      chunks_.emplace_back(new char[kChunkSize]);
+      current_ = chunks_.back().get();
+      used_ = 0;
+      allocated_ += kChunkSize;
+    }
+    destination = current_ + used_;
+    used_ += kBytes;
+  }
+  const std::uint32_t kSize = static_cast<std::uint32_t>(size);
+  std::memcpy(destination, &kSize, sizeof(kSize));
+  std::memcpy(destination + sizeof(kSize), data, size);
+  if (found == stored_.end()) {
+    stored_.emplace(hash, destination + sizeof(kSize));
+  }
+  return destination + sizeof(kSize);
+}
+
+inline std::size_t LabelArena::allocated_bytes() const {
+  return allocated_;
+}
+
+inline void LabelArena::clear() {
+  chunks_.clear();
+  stored_.clear();
+  current_ = nullptr;
+  used_ = kChunkSize;
+  allocated_ = 0;
+}
+
+#endif // TREE_SIMILARITY_LABEL_LABEL_ARENA_IMPL_H
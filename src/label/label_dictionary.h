@@ -0,0 +1,89 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file label/label_dictionary.h
+///
+/// \details
+/// Contains the declaration of the LabelDictionary class. It interns labels,
+/// i.e., assigns consecutive integer ids to distinct labels, such that labels
+/// can be compared and used as array indexes in constant time.
+
+#ifndef TREE_SIMILARITY_LABEL_LABEL_DICTIONARY_H
+#define TREE_SIMILARITY_LABEL_LABEL_DICTIONARY_H
+
+#include <unordered_map>
+#include <vector>
+
+namespace label {
+
+/// \class LabelDictionary
+///
+/// \details
+/// Maps distinct labels to ids 0, 1, 2, ... in the order of their first
+/// insertion.
+///
+/// \tparam Label Label type. Requires operator== and a specialization of
+///               std::hash.
+template <class Label>
+class LabelDictionary {
+// Member functions
+public:
+  /// Inserts a label if it is not in the dictionary yet.
+  ///
+  /// \param label The label to insert.
+  /// \return Id of the label.
+  int insert(const Label& label);
+
+  /// Looks up the id of a label without inserting it.
+  ///
+  /// \param label The label to look up.
+  /// \return Id of the label or -1 if it is not in the dictionary.
+  int lookup(const Label& label) const;
+
+  /// Retrieves the label with a given id.
+  ///
+  /// \param id Id of the label.
+  /// \return The label.
+  const Label& label(int id) const;
+
+  /// Returns the number of distinct labels.
+  ///
+  /// \return Number of labels in the dictionary.
+  int size() const;
+
+  /// Removes all labels. Ids start at 0 again.
+  void clear();
+
+// Member variables
+private:
+  /// Ids of the labels.
+  std::unordered_map<Label, int> ids_;
+  /// Labels indexed by their ids.
+  std::vector<Label> labels_;
+};
+
+// Implementation details
+#include "label_dictionary_impl.h"
+
+} // namespace label
+
+#endif // TREE_SIMILARITY_LABEL_LABEL_DICTIONARY_H
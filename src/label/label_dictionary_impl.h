@@ -0,0 +1,68 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file label/label_dictionary_impl.h
+///
+/// \details
+/// Contains the implementation of the LabelDictionary class.
+
+#ifndef TREE_SIMILARITY_LABEL_LABEL_DICTIONARY_IMPL_H
+#define TREE_SIMILARITY_LABEL_LABEL_DICTIONARY_IMPL_H
+
+template <class Label>
+int LabelDictionary<Label>::insert(const Label& label) {
+  // Look up first: emplace allocates a map node even for known labels.
+  auto it = ids_.find(label);
+  if (it != ids_.end()) {
+    return it->second;
+  }
+  ids_.emplace(label, static_cast<int>(labels_.size()));
+  labels_.push_back(label);
+  return static_cast<int>(labels_.size()) - 1;
+}
+
+template <class Label>
+int LabelDictionary<Label>::lookup(const Label& label) const {
+  auto it = ids_.find(label);
+  if (it == ids_.end()) {
+    return -1;
+  }
+  return it->second;
+}
+
+template <class Label>
+const Label& LabelDictionary<Label>::label(int id) const {
+  return labels_[id];
+}
+
+template <class Label>
+int LabelDictionary<Label>::size() const {
+  return static_cast<int>(labels_.size());
+}
+
+template <class Label>
+void LabelDictionary<Label>::clear() {
+  ids_.clear();
+  labels_.clear();
+}
+
+#endif // TREE_SIMILARITY_LABEL_LABEL_DICTIONARY_IMPL_H
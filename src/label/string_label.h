@@ -31,6 +31,7 @@
 #define TREE_SIMILARITY_LABEL_STRING_LABEL_H
 
 #include <string>
+#include <functional>
 
 namespace label {
 
@@ -47,7 +48,8 @@ namespace label {
 /// the following member functions such that it does not break the framework:
 ///     - bool operator==(...) const; // aka the 'equals' operator.
 /// The member function to get the member are optional but may be necessary if
-/// one wants to use a specialized cost model.
+/// one wants to use a specialized cost model. To intern labels (see
+/// LabelDictionary), a specialization of std::hash must be provided as well.
 class StringLabel {
 public:
     StringLabel(const std::string& label);
@@ -72,4 +74,16 @@ private:
 
 } // namespace label
 
+namespace std {
+
+/// Hashes a StringLabel by its string. Needed for interning labels.
+template <>
+struct hash<label::StringLabel> {
+  size_t operator()(const label::StringLabel& label) const {
+    return hash<string>()(label.to_string());
+  }
+};
+
+} // namespace std
+
 #endif // TREE_SIMILARITY_LABEL_STRING_LABEL_H
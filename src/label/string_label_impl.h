@@ -27,17 +27,17 @@
 #ifndef TREE_SIMILARITY_LABEL_STRING_LABEL_IMPL_H
 #define TREE_SIMILARITY_LABEL_STRING_LABEL_IMPL_H
 
-StringLabel::StringLabel(const std::string& label) : label_(label) {}
+inline StringLabel::StringLabel(const std::string& label) : label_(label) {}
 
 // const std::string& StringLabel::label() const {
 //   return label_;
 // }
 
-bool StringLabel::operator==(const StringLabel& other) const {
+inline bool StringLabel::operator==(const StringLabel& other) const {
   return (label_.compare(other.to_string()) == 0);
 }
 
-const std::string& StringLabel::to_string() const {
+inline const std::string& StringLabel::to_string() const {
   return label_;
 }
 
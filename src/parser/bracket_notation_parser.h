@@ -42,8 +42,11 @@
 ///  |
 /// ""                          -> an empty label
 /// TODO: Should the matched label be cleaned by removing escapes?
-/// TODO: This parses to StringLabel only. Should the label's type be assigned
-///       based on user's choice?
+///
+/// The label type is a template parameter. Every label is constructed from
+/// the matched string, e.g., IntLabel parses integer labels and HashedLabel
+/// keeps only a hash of the string. A custom label factory may be passed to
+/// the constructor instead. BracketNotationParser parses to StringLabel.
 
 #ifndef TREE_SIMILARITY_PARSER_BRACKET_NOTATION_PARSER_H
 #define TREE_SIMILARITY_PARSER_BRACKET_NOTATION_PARSER_H
@@ -51,21 +54,34 @@
 #include "node.h"
 #include "string_label.h"
 
+#include <functional>
 #include <iostream>
 #include <string>
 #include <regex>
 
 namespace parser {
 
-class BracketNotationParser {
+template <class Label>
+class BasicBracketNotationParser {
 // Types and type aliases
 public:
-  using Label = label::StringLabel;
+  /// Creates a label from the string matched between the quotes.
+  using LabelFactory = std::function<Label(const std::string&)>;
 
 // Member functions
 public:
+  /// Constructor. Labels are created with the constructor
+  /// Label(const std::string&).
+  BasicBracketNotationParser();
+
+  /// Constructor with a custom label factory, e.g., to store labels in an
+  /// arena owned by the caller.
+  ///
+  /// \param make_label Creates a label from its string.
+  explicit BasicBracketNotationParser(LabelFactory make_label);
+
   /// Takes the string of a tree in bracket notation, parses it to the Node
-  /// structure with StringLabels, and returns reference to the root.
+  /// structure with labels of type Label, and returns reference to the root.
   ///
   /// TODO: Verify if the returned object is not copied.
   ///
@@ -76,6 +92,9 @@ public:
 
 // Member variables
 private:
+  /// Creates the labels of the nodes.
+  LabelFactory label_factory;
+
   /// A stack to store nodes on a path to the root from the current node in the
   /// parsing process. Needed for maintaining correct parent-child relationships
   /// while parsing.
@@ -94,14 +113,18 @@ private:
   /// - any character that's not a quote or a backslash or a curly bracket,
   /// OR
   /// - a backslash followed by any character.
-  const std::string kMatchStringLabel = "\"([^\"\\\\" + kLeftBracket
-      + kRightBracket + "]|\\\\.)*\"";
+  /// Group 1 captures the entire label between the quotes.
+  const std::string kMatchStringLabel = "\"((?:[^\"\\\\" + kLeftBracket
+      + kRightBracket + "]|\\\\.)*)\"";
 
   /// A regex to match either left bracket or label or right bracket.
   const std::regex kR = std::regex(kMatchLeftBracket + "|" + kMatchStringLabel
                                    + "|" + kMatchRightBracket);
 };
 
+/// Parser of trees with string labels.
+using BracketNotationParser = BasicBracketNotationParser<label::StringLabel>;
+
 // Implementation details
 #include "bracket_notation_parser_impl.h"
 
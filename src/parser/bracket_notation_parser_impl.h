@@ -22,12 +22,21 @@
 /// \file parser/bracket_notation_parser_impl.h
 ///
 /// \details
-/// Contains the implementation of the BracketNotationParser class.
+/// Contains the implementation of the BasicBracketNotationParser class.
 
 #ifndef TREE_SIMILARITY_PARSER_BRACKET_NOTATION_PARSER_IMPL_H
 #define TREE_SIMILARITY_PARSER_BRACKET_NOTATION_PARSER_IMPL_H
 
-const node::Node<BracketNotationParser::Label> BracketNotationParser::parse_string(
+template <class Label>
+BasicBracketNotationParser<Label>::BasicBracketNotationParser()
+    : label_factory([](const std::string& label) { return Label(label); }) {}
+
+template <class Label>
+BasicBracketNotationParser<Label>::BasicBracketNotationParser(
+    LabelFactory make_label) : label_factory(make_label) {}
+
+template <class Label>
+const node::Node<Label> BasicBracketNotationParser<Label>::parse_string(
     const std::string& tree_string) {
 
   // Tokenize the input string - get iterator over tokens.
@@ -39,7 +48,7 @@ const node::Node<BracketNotationParser::Label> BracketNotationParser::parse_stri
   ++tokens_begin; // Advance tokens to label.
   std::smatch match = *tokens_begin;
   std::string match_str = match.str(1); // Return only group 1 - characters between the quotes.
-  Label root_label(match_str);
+  Label root_label = label_factory(match_str);
   node::Node<Label> root(root_label);
   node_stack.push_back(std::ref(root));
 
@@ -56,7 +65,7 @@ const node::Node<BracketNotationParser::Label> BracketNotationParser::parse_stri
       match_str = match.str(1); // Return only group 1 - characters between the quotes.
 
       // Create new node.
-      Label node_label(match_str);
+      Label node_label = label_factory(match_str);
       node::Node<Label> n(node_label);
 
       // Move n to become a child.
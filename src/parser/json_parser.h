@@ -0,0 +1,196 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file parser/json_parser.h
+///
+/// \details
+/// Implements a streaming parser for JSON documents (RFC 8259). It reads the
+/// document in one pass and builds the tree directly, without a DOM or a
+/// conversion to bracket notation. The auxiliary memory is bounded by the
+/// read buffer, the path from the root to the current value, and the current
+/// token.
+///
+/// Objects and arrays become nodes with a fixed label, their members and
+/// elements become children in document order. Scalars become leaves
+/// labeled with their text: strings without quotes and with escapes
+/// decoded, numbers and literals as written. Object keys are mapped as
+/// configured by JsonMapping.
+
+#ifndef TREE_SIMILARITY_PARSER_JSON_PARSER_H
+#define TREE_SIMILARITY_PARSER_JSON_PARSER_H
+
+#include <cctype>
+#include <cstdlib>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "node.h"
+#include "string_label.h"
+#include "label_dictionary.h"
+#include "stream_reader.h"
+
+namespace parser {
+
+/// Configures the mapping of JSON values to nodes.
+struct JsonMapping {
+  /// Label of object nodes.
+  std::string object_label = "{}";
+  /// Label of array nodes.
+  std::string array_label = "[]";
+  /// If true, an object member is a node labeled with its key that has the
+  /// value as its only child. Otherwise, the key and key_separator prefix
+  /// the label of the value node.
+  bool key_nodes = true;
+  /// Separates the key from the value label if key_nodes is false.
+  std::string key_separator = ":";
+  /// Map scalar values to leaves. Otherwise, scalars in arrays are dropped
+  /// and scalar members are represented by their keys only.
+  bool values = true;
+};
+
+/// \class JsonParser
+///
+/// \details
+/// Parses JSON documents into trees with StringLabels. Optionally, every
+/// label is interned in a dictionary owned by the caller.
+class JsonParser {
+// Types and type aliases
+public:
+  using Label = label::StringLabel;
+
+// Member functions
+public:
+  /// Constructor. Uses the default mapping.
+  JsonParser();
+
+  /// Constructor.
+  ///
+  /// \param mapping Mapping of JSON values to nodes.
+  /// \param labels Dictionary interning the labels of all parsed nodes, or
+  ///        nullptr.
+  JsonParser(const JsonMapping& mapping,
+             label::LabelDictionary<Label>* labels = nullptr);
+
+  /// Parses the next JSON document from a stream. Consecutive calls with the
+  /// same stream parse consecutive documents, e.g., one per line.
+  ///
+  /// \param in The stream.
+  /// \return True on success. False if the input is malformed or contains no
+  ///         further document, see get_error().
+  bool parse(std::istream& in);
+
+  /// Parses a JSON document from a string.
+  ///
+  /// \param document The document.
+  /// \return True on success, see parse.
+  bool parse_string(const std::string& document);
+
+  /// Returns the tree of the last successful parse. It may be moved away by
+  /// the caller.
+  ///
+  /// \return Reference to the root node.
+  node::Node<Label>& get_tree();
+
+  /// Describes the reason of the last failed parse.
+  ///
+  /// \return Error message.
+  const std::string& get_error() const;
+
+// Types and type aliases
+private:
+  /// An open object or array.
+  struct Container {
+    /// The node of the container.
+    std::reference_wrapper<node::Node<Label>> node;
+    /// True for an object, false for an array.
+    bool object;
+  };
+
+// Member functions
+private:
+  /// Adds the node of a value to the current container, or as the root.
+  /// Adds the key node of an object member if configured.
+  ///
+  /// \param label The label of the value.
+  /// \param scalar True if the value is a scalar.
+  /// \return Pointer to the node of the value, or nullptr if it is dropped.
+  node::Node<Label>* add_value(const std::string& label, bool scalar);
+  /// Adds a node as the last child of a parent, or as the root.
+  ///
+  /// \param parent The parent, or nullptr for the root.
+  /// \param label The label.
+  /// \return Reference to the added node.
+  node::Node<Label>& add_node(node::Node<Label>* parent,
+                              const std::string& label);
+  /// Reads a string after its opening quote and decodes its escapes.
+  ///
+  /// \param s Filled with the string.
+  /// \return False if the string is malformed.
+  bool read_string(std::string& s);
+  /// Reads four hexadecimal digits of a \u escape.
+  ///
+  /// \param code_unit Set to the UTF-16 code unit.
+  /// \return False if the digits are malformed.
+  bool read_code_unit(unsigned long& code_unit);
+  /// Reads a number or a literal starting with a given character.
+  ///
+  /// \param first The first character.
+  /// \param s Filled with the number or literal.
+  /// \return False if it is malformed.
+  bool read_scalar(int first, std::string& s);
+  /// Skips whitespace.
+  void skip_whitespace();
+  /// Sets the error message including the input position.
+  ///
+  /// \param message The message.
+  /// \return False.
+  bool fail(const std::string& message);
+
+// Member variables
+private:
+  /// Mapping of JSON values to nodes.
+  const JsonMapping mapping_;
+  /// Reader of the current stream.
+  StreamReader reader_;
+  /// The parsed tree.
+  std::unique_ptr<node::Node<Label>> tree_;
+  /// Open containers from the root to the current one.
+  std::vector<Container> container_stack_;
+  /// Key of the current object member.
+  std::string key_;
+  /// Buffer for scalar values.
+  std::string token_;
+  /// Error message of the last failed parse.
+  std::string error_;
+  /// Dictionary interning the labels, or nullptr.
+  label::LabelDictionary<Label>* labels_;
+};
+
+// Implementation details
+#include "json_parser_impl.h"
+
+}
+
+#endif // TREE_SIMILARITY_PARSER_JSON_PARSER_H
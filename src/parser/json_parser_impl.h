@@ -0,0 +1,267 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file parser/json_parser_impl.h
+///
+/// \details
+/// Contains the implementation of the JsonParser class.
+
+#ifndef TREE_SIMILARITY_PARSER_JSON_PARSER_IMPL_H
+#define TREE_SIMILARITY_PARSER_JSON_PARSER_IMPL_H
+
+inline JsonParser::JsonParser() : labels_(nullptr) {}
+
+inline JsonParser::JsonParser(const JsonMapping& mapping,
+                              label::LabelDictionary<Label>* labels)
+    : mapping_(mapping), labels_(labels) {}
+
+inline bool JsonParser::parse(std::istream& in) {
+  if (reader_.get_stream() != &in) {
+    reader_.reset(in);
+  }
+  tree_.reset();
+  container_stack_.clear();
+  error_.clear();
+
+  skip_whitespace();
+  if (reader_.peek() == -1) {
+    return fail("No document");
+  }
+  // What the next token must be.
+  enum { kValue, kValueOrEnd, kKey, kKeyOrEnd, kNext } expected = kValue;
+  while (true) {
+    skip_whitespace();
+    const int c = reader_.get();
+    if (c == -1) {
+      return fail("Unexpected end of input");
+    }
+    bool value_done = false;
+    if (expected == kKey || expected == kKeyOrEnd) {
+      if (c == '}' && expected == kKeyOrEnd) {
+        container_stack_.pop_back();
+        value_done = true;
+      } else if (c == '"') {
+        if (!read_string(key_)) {
+          return false;
+        }
+        skip_whitespace();
+        if (reader_.get() != ':') {
+          return fail("Expected ':' after key '" + key_ + "'");
+        }
+        expected = kValue;
+      } else {
+        return fail("Expected a key");
+      }
+    } else if (expected == kNext) {
+      const bool kObject = container_stack_.back().object;
+      if (c == ',') {
+        expected = kObject ? kKey : kValue;
+      } else if (c == (kObject ? '}' : ']')) {
+        container_stack_.pop_back();
+        value_done = true;
+      } else {
+        return fail(kObject ? "Expected ',' or '}'" : "Expected ',' or ']'");
+      }
+    } else if (c == ']' && expected == kValueOrEnd) {
+      container_stack_.pop_back();
+      value_done = true;
+    } else if (c == '{' || c == '[') {
+      const bool kObject = c == '{';
+      node::Node<Label>* container = add_value(
+          kObject ? mapping_.object_label : mapping_.array_label, false);
+      container_stack_.push_back({std::ref(*container), kObject});
+      expected = kObject ? kKeyOrEnd : kValueOrEnd;
+    } else {
+      if (c == '"' ? !read_string(token_) : !read_scalar(c, token_)) {
+        return false;
+      }
+      add_value(token_, true);
+      value_done = true;
+    }
+    if (value_done) {
+      if (container_stack_.empty()) {
+        return true;
+      }
+      expected = kNext;
+    }
+  }
+}
+
+inline bool JsonParser::parse_string(const std::string& document) {
+  std::istringstream in(document);
+  reader_.reset(in);
+  const bool kParsed = parse(in);
+  reader_.detach();
+  return kParsed;
+}
+
+inline node::Node<JsonParser::Label>& JsonParser::get_tree() {
+  return *tree_;
+}
+
+inline const std::string& JsonParser::get_error() const {
+  return error_;
+}
+
+inline node::Node<JsonParser::Label>* JsonParser::add_value(
+    const std::string& label, bool scalar) {
+  if (container_stack_.empty()) {
+    return &add_node(nullptr, label);
+  }
+  const Container& container = container_stack_.back();
+  node::Node<Label>* parent = &container.node.get();
+  const bool kDropped = scalar && !mapping_.values;
+  if (!container.object) {
+    return kDropped ? nullptr : &add_node(parent, label);
+  }
+  if (mapping_.key_nodes) {
+    node::Node<Label>& key = add_node(parent, key_);
+    return kDropped ? &key : &add_node(&key, label);
+  }
+  return &add_node(parent, kDropped ? key_
+                                    : key_ + mapping_.key_separator + label);
+}
+
+inline node::Node<JsonParser::Label>& JsonParser::add_node(
+    node::Node<Label>* parent, const std::string& label) {
+  Label node_label(label);
+  if (labels_) {
+    labels_->insert(node_label);
+  }
+  if (parent == nullptr) {
+    tree_.reset(new node::Node<Label>(node_label));
+    return *tree_;
+  }
+  return parent->add_child(node::Node<Label>(node_label));
+}
+
+inline bool JsonParser::read_string(std::string& s) {
+  s.clear();
+  for (int c = reader_.get(); c != '"'; c = reader_.get()) {
+    if (c == -1) {
+      return fail("Unterminated string");
+    }
+    if (c != '\\') {
+      s.push_back(static_cast<char>(c));
+      continue;
+    }
+    c = reader_.get();
+    switch (c) {
+      case '"': s.push_back('"'); break;
+      case '\\': s.push_back('\\'); break;
+      case '/': s.push_back('/'); break;
+      case 'b': s.push_back('\b'); break;
+      case 'f': s.push_back('\f'); break;
+      case 'n': s.push_back('\n'); break;
+      case 'r': s.push_back('\r'); break;
+      case 't': s.push_back('\t'); break;
+      case 'u': {
+        unsigned long code_point = 0;
+        if (!read_code_unit(code_point)) {
+          return false;
+        }
+        // A high surrogate must be followed by an escaped low surrogate.
+        if (code_point >= 0xD800 && code_point <= 0xDBFF) {
+          unsigned long low = 0;
+          if (reader_.get() != '\\' || reader_.get() != 'u' ||
+              !read_code_unit(low) || low < 0xDC00 || low > 0xDFFF) {
+            return fail("Unpaired surrogate in string");
+          }
+          code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+        } else if (code_point >= 0xDC00 && code_point <= 0xDFFF) {
+          return fail("Unpaired surrogate in string");
+        }
+        append_utf8(code_point, s);
+        break;
+      }
+      default:
+        return fail("Invalid escape in string");
+    }
+  }
+  return true;
+}
+
+inline bool JsonParser::read_code_unit(unsigned long& code_unit) {
+  char digits[5] = {};
+  for (int d = 0; d < 4; ++d) {
+    const int c = reader_.get();
+    if (c == -1 || !std::isxdigit(c)) {
+      return fail("Invalid \\u escape in string");
+    }
+    digits[d] = static_cast<char>(c);
+  }
+  code_unit = std::strtoul(digits, nullptr, 16);
+  return true;
+}
+
+inline bool JsonParser::read_scalar(int first, std::string& s) {
+  s.assign(1, static_cast<char>(first));
+  for (int c = reader_.peek();
+       c != -1 && (std::isalnum(c) || c == '-' || c == '+' || c == '.');
+       c = reader_.peek()) {
+    s.push_back(static_cast<char>(reader_.get()));
+  }
+  if (s == "true" || s == "false" || s == "null") {
+    return true;
+  }
+  // A number: an optional minus, digits, an optional fraction and exponent.
+  std::size_t p = s[0] == '-' ? 1 : 0;
+  const std::size_t kIntegerBegin = p;
+  while (p < s.size() && std::isdigit(static_cast<unsigned char>(s[p]))) {
+    ++p;
+  }
+  bool valid = p > kIntegerBegin &&
+               (s[kIntegerBegin] != '0' || p == kIntegerBegin + 1);
+  if (valid && p < s.size() && s[p] == '.') {
+    const std::size_t kFractionBegin = ++p;
+    while (p < s.size() && std::isdigit(static_cast<unsigned char>(s[p]))) {
+      ++p;
+    }
+    valid = p > kFractionBegin;
+  }
+  if (valid && p < s.size() && (s[p] == 'e' || s[p] == 'E')) {
+    ++p;
+    if (p < s.size() && (s[p] == '+' || s[p] == '-')) {
+      ++p;
+    }
+    const std::size_t kExponentBegin = p;
+    while (p < s.size() && std::isdigit(static_cast<unsigned char>(s[p]))) {
+      ++p;
+    }
+    valid = p > kExponentBegin;
+  }
+  return (valid && p == s.size()) || fail("Invalid value '" + s + "'");
+}
+
+inline void JsonParser::skip_whitespace() {
+  for (int c = reader_.peek(); c == ' ' || c == '\t' || c == '\n' || c == '\r';
+       c = reader_.peek()) {
+    reader_.get();
+  }
+}
+
+inline bool JsonParser::fail(const std::string& message) {
+  error_ = message + " at position " + std::to_string(reader_.position());
+  return false;
+}
+
+#endif // TREE_SIMILARITY_PARSER_JSON_PARSER_IMPL_H
@@ -0,0 +1,112 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file parser/stream_reader.h
+///
+/// \details
+/// Contains the declaration of the StreamReader class used by the streaming
+/// parsers. It reads an input stream through a fixed-size buffer, such that
+/// a document is parsed in one pass without holding it in memory.
+
+#ifndef TREE_SIMILARITY_PARSER_STREAM_READER_H
+#define TREE_SIMILARITY_PARSER_STREAM_READER_H
+
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace parser {
+
+/// \class StreamReader
+///
+/// \details
+/// Reads characters from a stream through a fixed-size buffer. A parser
+/// keeps its reader for a stream, such that consecutive documents can be
+/// parsed from it, e.g., one JSON document per line.
+class StreamReader {
+// Member functions
+public:
+  /// Constructor.
+  ///
+  /// \param buffer_size Number of characters read from the stream at once.
+  StreamReader(std::size_t buffer_size = 1 << 16);
+
+  /// Starts reading a stream. Discards the buffered characters of the
+  /// previous stream.
+  ///
+  /// \param in The stream.
+  void reset(std::istream& in);
+
+  /// Stops reading the stream, e.g., before it is destroyed. Discards the
+  /// buffered characters.
+  void detach();
+
+  /// Returns the stream read, or nullptr.
+  const std::istream* get_stream() const;
+
+  /// Returns the next character without consuming it.
+  ///
+  /// \return The character as unsigned char, or -1 at the end of the input.
+  int peek();
+
+  /// Consumes the next character.
+  ///
+  /// \return The character as unsigned char, or -1 at the end of the input.
+  int get();
+
+  /// Returns the number of characters consumed from the stream.
+  long long position() const;
+
+// Member functions
+private:
+  /// Refills the buffer from the stream.
+  ///
+  /// \return False at the end of the input.
+  bool fill();
+
+// Member variables
+private:
+  /// The stream read, or nullptr.
+  std::istream* in_ = nullptr;
+  /// Buffered characters.
+  std::vector<char> buffer_;
+  /// Position of the next character in buffer_.
+  std::size_t begin_ = 0;
+  /// Number of valid characters in buffer_.
+  std::size_t end_ = 0;
+  /// Number of characters consumed before buffer_.
+  long long consumed_ = 0;
+};
+
+/// Appends a Unicode code point encoded in UTF-8 to a string. Used for
+/// character references and escapes.
+///
+/// \param code_point The code point, at most 0x10FFFF.
+/// \param s The string.
+void append_utf8(unsigned long code_point, std::string& s);
+
+// Implementation details
+#include "stream_reader_impl.h"
+
+}
+
+#endif // TREE_SIMILARITY_PARSER_STREAM_READER_H
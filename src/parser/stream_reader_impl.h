@@ -0,0 +1,99 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file parser/stream_reader_impl.h
+///
+/// \details
+/// Contains the implementation of the StreamReader class.
+
+#ifndef TREE_SIMILARITY_PARSER_STREAM_READER_IMPL_H
+#define TREE_SIMILARITY_PARSER_STREAM_READER_IMPL_H
+
+inline StreamReader::StreamReader(std::size_t buffer_size)
+    : buffer_(buffer_size) {}
+
+inline void StreamReader::reset(std::istream& in) {
+  in_ = &in;
+  begin_ = 0;
+  end_ = 0;
+  consumed_ = 0;
+}
+
+inline void StreamReader::detach() {
+  in_ = nullptr;
+  begin_ = 0;
+  end_ = 0;
+  consumed_ = 0;
+}
+
+inline const std::istream* StreamReader::get_stream() const {
+  return in_;
+}
+
+inline int StreamReader::peek() {
+  if (begin_ == end_ && !fill()) {
+    return -1;
+  }
+  return static_cast<unsigned char>(buffer_[begin_]);
+}
+
+inline int StreamReader::get() {
+  if (begin_ == end_ && !fill()) {
+    return -1;
+  }
+  return static_cast<unsigned char>(buffer_[begin_++]);
+}
+
+inline long long StreamReader::position() const {
+  return consumed_ + begin_;
+}
+
+inline bool StreamReader::fill() {
+  if (in_ == nullptr) {
+    return false;
+  }
+  consumed_ += end_;
+  begin_ = 0;
+  in_->read(buffer_.data(), buffer_.size());
+  end_ = in_->gcount();
+  return end_ > 0;
+}
+
+inline void append_utf8(unsigned long code_point, std::string& s) {
+  if (code_point < 0x80) {
+    s.push_back(static_cast<char>(code_point));
+  } else if (code_point < 0x800) {
+    s.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+    s.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else if (code_point < 0x10000) {
+    s.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+    s.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    s.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else {
+    s.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+    s.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+    s.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    s.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  }
+}
+
+#endif // TREE_SIMILARITY_PARSER_STREAM_READER_IMPL_H
@@ -0,0 +1,195 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file parser/xml_parser.h
+///
+/// \details
+/// Implements a streaming parser for XML documents. It reads the document in
+/// one pass and builds the tree directly, without a DOM or a conversion to
+/// bracket notation. The auxiliary memory is bounded by the read buffer, the
+/// path from the root to the current element, and the current token.
+///
+/// Elements become nodes labeled with their names. Attributes and text are
+/// mapped to children as configured by XmlMapping. Comments, processing
+/// instructions, and the document type declaration are skipped. Character
+/// references and the predefined entities are decoded, other entity
+/// references are rejected. Namespaces are not interpreted, prefixes are
+/// part of names.
+
+#ifndef TREE_SIMILARITY_PARSER_XML_PARSER_H
+#define TREE_SIMILARITY_PARSER_XML_PARSER_H
+
+#include <cctype>
+#include <cstdlib>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "node.h"
+#include "string_label.h"
+#include "label_dictionary.h"
+#include "stream_reader.h"
+
+namespace parser {
+
+/// Configures the mapping of XML constructs to nodes.
+struct XmlMapping {
+  /// Map attributes to children of their element, preceding its content.
+  bool attributes = true;
+  /// Prefix of the labels of attribute nodes, distinguishing them from
+  /// elements.
+  std::string attribute_prefix = "@";
+  /// If true, an attribute is a node labeled with its name that has one leaf
+  /// child labeled with its value. Otherwise, an attribute is one leaf
+  /// labeled name=value.
+  bool attribute_value_nodes = true;
+  /// Map text content (including CDATA sections) to leaves. Text between two
+  /// tags is one leaf, whitespace-only text is dropped.
+  bool text = true;
+  /// Remove leading and trailing whitespace of text leaves.
+  bool trim_text = true;
+};
+
+/// \class XmlParser
+///
+/// \details
+/// Parses XML documents into trees with StringLabels. Optionally, every
+/// label is interned in a dictionary owned by the caller.
+class XmlParser {
+// Types and type aliases
+public:
+  using Label = label::StringLabel;
+
+// Member functions
+public:
+  /// Constructor. Uses the default mapping.
+  XmlParser();
+
+  /// Constructor.
+  ///
+  /// \param mapping Mapping of XML constructs to nodes.
+  /// \param labels Dictionary interning the labels of all parsed nodes, or
+  ///        nullptr.
+  XmlParser(const XmlMapping& mapping,
+            label::LabelDictionary<Label>* labels = nullptr);
+
+  /// Parses the next XML document from a stream. Consecutive calls with the
+  /// same stream parse consecutive documents, each ending with its root
+  /// element.
+  ///
+  /// \param in The stream.
+  /// \return True on success. False if the input is malformed or contains no
+  ///         further document, see get_error().
+  bool parse(std::istream& in);
+
+  /// Parses an XML document from a string.
+  ///
+  /// \param document The document.
+  /// \return True on success, see parse.
+  bool parse_string(const std::string& document);
+
+  /// Returns the tree of the last successful parse. It may be moved away by
+  /// the caller.
+  ///
+  /// \return Reference to the root node.
+  node::Node<Label>& get_tree();
+
+  /// Describes the reason of the last failed parse.
+  ///
+  /// \return Error message.
+  const std::string& get_error() const;
+
+// Member functions
+private:
+  /// Adds a node as the last child of the current element, or as the root.
+  ///
+  /// \param label The label.
+  /// \return Reference to the added node.
+  node::Node<Label>& add_node(const std::string& label);
+  /// Adds the buffered text as a leaf of the current element and clears it.
+  void flush_text();
+  /// Reads a name up to whitespace or one of "/>=".
+  ///
+  /// \param name Filled with the name.
+  /// \return False if the name is empty.
+  bool read_name(std::string& name);
+  /// Reads an entity or character reference after '&' and appends the
+  /// referenced characters.
+  ///
+  /// \param s The string to append to.
+  /// \return False if the reference is malformed or unknown.
+  bool read_reference(std::string& s);
+  /// Reads the attributes and the end of a start tag.
+  ///
+  /// \param element The element of the start tag.
+  /// \param empty Set to true if the element is empty (ends with "/>").
+  /// \return False if the tag is malformed.
+  bool read_attributes(node::Node<Label>& element, bool& empty);
+  /// Consumes the input up to and including a delimiter.
+  ///
+  /// \param delimiter The delimiter.
+  /// \param content If not nullptr, the skipped characters are appended.
+  /// \return False if the input ends first.
+  bool skip_past(const std::string& delimiter, std::string* content);
+  /// Skips a document type declaration after "<!", including an internal
+  /// subset in brackets.
+  ///
+  /// \return False if the input ends first.
+  bool skip_declaration();
+  /// Skips whitespace.
+  void skip_whitespace();
+  /// Sets the error message including the input position.
+  ///
+  /// \param message The message.
+  /// \return False.
+  bool fail(const std::string& message);
+
+// Member variables
+private:
+  /// Mapping of XML constructs to nodes.
+  const XmlMapping mapping_;
+  /// Reader of the current stream.
+  StreamReader reader_;
+  /// The parsed tree.
+  std::unique_ptr<node::Node<Label>> tree_;
+  /// Open elements from the root to the current element.
+  std::vector<std::reference_wrapper<node::Node<Label>>> node_stack_;
+  /// Dictionary interning the labels, or nullptr.
+  label::LabelDictionary<Label>* labels_;
+  /// Text of the current element since the last tag.
+  std::string text_;
+  /// Buffer for names.
+  std::string token_;
+  /// Buffer for attribute values.
+  std::string value_;
+  /// Error message of the last failed parse.
+  std::string error_;
+};
+
+// Implementation details
+#include "xml_parser_impl.h"
+
+}
+
+#endif // TREE_SIMILARITY_PARSER_XML_PARSER_H
@@ -0,0 +1,328 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file parser/xml_parser_impl.h
+///
+/// \details
+/// Contains the implementation of the XmlParser class.
+
+#ifndef TREE_SIMILARITY_PARSER_XML_PARSER_IMPL_H
+#define TREE_SIMILARITY_PARSER_XML_PARSER_IMPL_H
+
+inline XmlParser::XmlParser() : labels_(nullptr) {}
+
+inline XmlParser::XmlParser(const XmlMapping& mapping,
+                            label::LabelDictionary<Label>* labels)
+    : mapping_(mapping), labels_(labels) {}
+
+inline bool XmlParser::parse(std::istream& in) {
+  if (reader_.get_stream() != &in) {
+    reader_.reset(in);
+  }
+  tree_.reset();
+  node_stack_.clear();
+  text_.clear();
+  error_.clear();
+
+  for (int c = reader_.get(); c != -1; c = reader_.get()) {
+    if (c == '&') {
+      if (node_stack_.empty()) {
+        return fail("Content outside of the root element");
+      }
+      if (!read_reference(text_)) {
+        return false;
+      }
+    } else if (c != '<') {
+      if (!node_stack_.empty()) {
+        text_.push_back(static_cast<char>(c));
+      } else if (!std::isspace(c)) {
+        return fail("Content outside of the root element");
+      }
+    } else if (reader_.peek() == '?') {
+      // Processing instruction or XML declaration.
+      if (!skip_past("?>", nullptr)) {
+        return fail("Unterminated processing instruction");
+      }
+    } else if (reader_.peek() == '!') {
+      reader_.get();
+      if (reader_.peek() == '-') {
+        reader_.get();
+        if (reader_.get() != '-' || !skip_past("-->", nullptr)) {
+          return fail("Malformed comment");
+        }
+      } else if (reader_.peek() == '[') {
+        token_.clear();
+        while (token_.size() < 7 && reader_.peek() != -1) {
+          token_.push_back(static_cast<char>(reader_.get()));
+        }
+        if (token_ != "[CDATA[" || node_stack_.empty()) {
+          return fail("Malformed CDATA section");
+        }
+        if (!skip_past("]]>", &text_)) {
+          return fail("Unterminated CDATA section");
+        }
+        text_.resize(text_.size() - 3);
+      } else if (!skip_declaration()) {
+        return fail("Unterminated declaration");
+      }
+    } else if (reader_.peek() == '/') {
+      // End tag.
+      reader_.get();
+      if (node_stack_.empty() || !read_name(token_) ||
+          token_ != node_stack_.back().get().label().to_string()) {
+        return fail("Mismatched end tag '" + token_ + "'");
+      }
+      skip_whitespace();
+      if (reader_.get() != '>') {
+        return fail("Malformed end tag '" + token_ + "'");
+      }
+      flush_text();
+      node_stack_.pop_back();
+      if (node_stack_.empty()) {
+        return true;
+      }
+    } else {
+      // Start tag.
+      if (!read_name(token_)) {
+        return fail("Malformed start tag");
+      }
+      flush_text();
+      node::Node<Label>& element = add_node(token_);
+      bool empty = false;
+      if (!read_attributes(element, empty)) {
+        return false;
+      }
+      if (!empty) {
+        node_stack_.push_back(std::ref(element));
+      } else if (node_stack_.empty()) {
+        return true;
+      }
+    }
+  }
+  if (!tree_) {
+    return fail("No root element");
+  }
+  return fail("Unexpected end of input");
+}
+
+inline bool XmlParser::parse_string(const std::string& document) {
+  std::istringstream in(document);
+  reader_.reset(in);
+  const bool kParsed = parse(in);
+  reader_.detach();
+  return kParsed;
+}
+
+inline node::Node<XmlParser::Label>& XmlParser::get_tree() {
+  return *tree_;
+}
+
+inline const std::string& XmlParser::get_error() const {
+  return error_;
+}
+
+inline node::Node<XmlParser::Label>& XmlParser::add_node(
+    const std::string& label) {
+  Label node_label(label);
+  if (labels_) {
+    labels_->insert(node_label);
+  }
+  if (node_stack_.empty()) {
+    tree_.reset(new node::Node<Label>(node_label));
+    return *tree_;
+  }
+  return node_stack_.back().get().add_child(node::Node<Label>(node_label));
+}
+
+inline void XmlParser::flush_text() {
+  if (!mapping_.text || node_stack_.empty()) {
+    text_.clear();
+    return;
+  }
+  std::size_t begin = 0;
+  std::size_t end = text_.size();
+  while (begin < end && std::isspace(static_cast<unsigned char>(text_[begin]))) {
+    ++begin;
+  }
+  while (end > begin && std::isspace(static_cast<unsigned char>(text_[end - 1]))) {
+    --end;
+  }
+  if (begin < end) {
+    if (mapping_.trim_text) {
+      add_node(text_.substr(begin, end - begin));
+    } else {
+      add_node(text_);
+    }
+  }
+  text_.clear();
+}
+
+inline bool XmlParser::read_name(std::string& name) {
+  name.clear();
+  for (int c = reader_.peek();
+       c != -1 && !std::isspace(c) && c != '/' && c != '>' && c != '=';
+       c = reader_.peek()) {
+    name.push_back(static_cast<char>(reader_.get()));
+  }
+  return !name.empty();
+}
+
+inline bool XmlParser::read_reference(std::string& s) {
+  std::string reference;
+  for (int c = reader_.get(); c != ';'; c = reader_.get()) {
+    if (c == -1 || reference.size() > 16) {
+      return fail("Malformed reference");
+    }
+    reference.push_back(static_cast<char>(c));
+  }
+  if (reference.size() > 1 && reference[0] == '#') {
+    const bool kHex = reference[1] == 'x';
+    const std::string kDigits = reference.substr(kHex ? 2 : 1);
+    char* end = nullptr;
+    const unsigned long kCodePoint =
+        std::strtoul(kDigits.c_str(), &end, kHex ? 16 : 10);
+    if (kDigits.empty() || *end != '\0' || kCodePoint > 0x10FFFF) {
+      return fail("Malformed character reference '" + reference + "'");
+    }
+    append_utf8(kCodePoint, s);
+  } else if (reference == "lt") {
+    s.push_back('<');
+  } else if (reference == "gt") {
+    s.push_back('>');
+  } else if (reference == "amp") {
+    s.push_back('&');
+  } else if (reference == "quot") {
+    s.push_back('"');
+  } else if (reference == "apos") {
+    s.push_back('\'');
+  } else {
+    return fail("Unknown entity '" + reference + "'");
+  }
+  return true;
+}
+
+inline bool XmlParser::read_attributes(node::Node<Label>& element,
+                                       bool& empty) {
+  while (true) {
+    skip_whitespace();
+    const int c = reader_.get();
+    if (c == '>') {
+      return true;
+    }
+    if (c == '/') {
+      empty = true;
+      return reader_.get() == '>' || fail("Malformed empty-element tag");
+    }
+    if (c == -1) {
+      return fail("Unterminated start tag");
+    }
+    token_.assign(1, static_cast<char>(c));
+    std::string name;
+    if (c != '=') {
+      read_name(name);
+    }
+    token_ += name;
+    skip_whitespace();
+    if (reader_.get() != '=') {
+      return fail("Malformed attribute '" + token_ + "'");
+    }
+    skip_whitespace();
+    const int kQuote = reader_.get();
+    if (kQuote != '"' && kQuote != '\'') {
+      return fail("Unquoted value of attribute '" + token_ + "'");
+    }
+    value_.clear();
+    for (int v = reader_.get(); v != kQuote; v = reader_.get()) {
+      if (v == -1 || v == '<') {
+        return fail("Malformed value of attribute '" + token_ + "'");
+      }
+      if (v == '&') {
+        if (!read_reference(value_)) {
+          return false;
+        }
+      } else {
+        value_.push_back(static_cast<char>(v));
+      }
+    }
+    if (!mapping_.attributes) {
+      continue;
+    }
+    // The attribute nodes are children of the element, which is not on the
+    // stack yet.
+    node_stack_.push_back(std::ref(element));
+    if (mapping_.attribute_value_nodes) {
+      node_stack_.push_back(std::ref(add_node(mapping_.attribute_prefix + token_)));
+      add_node(value_);
+      node_stack_.pop_back();
+    } else {
+      add_node(mapping_.attribute_prefix + token_ + "=" + value_);
+    }
+    node_stack_.pop_back();
+  }
+}
+
+inline bool XmlParser::skip_past(const std::string& delimiter,
+                                 std::string* content) {
+  // The last characters read, compared with the delimiter after each one.
+  std::string window;
+  while (window != delimiter) {
+    const int c = reader_.get();
+    if (c == -1) {
+      return false;
+    }
+    if (content) {
+      content->push_back(static_cast<char>(c));
+    }
+    if (window.size() == delimiter.size()) {
+      window.erase(0, 1);
+    }
+    window.push_back(static_cast<char>(c));
+  }
+  return true;
+}
+
+inline bool XmlParser::skip_declaration() {
+  int depth = 0;
+  for (int c = reader_.get(); c != -1; c = reader_.get()) {
+    if (c == '[') {
+      ++depth;
+    } else if (c == ']') {
+      --depth;
+    } else if (c == '>' && depth <= 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+inline void XmlParser::skip_whitespace() {
+  while (reader_.peek() != -1 && std::isspace(reader_.peek())) {
+    reader_.get();
+  }
+}
+
+inline bool XmlParser::fail(const std::string& message) {
+  error_ = message + " at position " + std::to_string(reader_.position());
+  return false;
+}
+
+#endif // TREE_SIMILARITY_PARSER_XML_PARSER_IMPL_H
@@ -0,0 +1,178 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+/// \file pq_gram/pq_gram.h
+///
+/// \details
+/// Implements the pq-gram distance, an approximation of the tree edit
+/// distance, and an inverted index for fast approximate lookups. N.Augsten,
+/// M.Boehlen, J.Gamper. The pq-gram distance between ordered labeled trees.
+/// ACM TODS 2010.
+
+#ifndef TREE_SIMILARITY_PQ_GRAM_PQ_GRAM_H
+#define TREE_SIMILARITY_PQ_GRAM_PQ_GRAM_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "node.h"
+#include "hash.h"
+
+namespace pq_gram {
+
+/// A pq-gram profile: the bag of hashed pq-grams of a tree, sorted.
+using Profile = std::vector<std::uint64_t>;
+
+/// \class ProfileBuilder
+///
+/// \details
+/// Extracts pq-gram profiles. A pq-gram of a node consists of the node, its
+/// p-1 closest ancestors (the stem), and q consecutive children (the base).
+/// Missing ancestors and children are padded with a dummy label. Each pq-gram
+/// is hashed to 64 bits from the hashes of its p+q labels.
+///
+/// \tparam Label Label type. Requires a specialization of std::hash.
+template <class Label>
+class ProfileBuilder {
+// Member functions.
+public:
+  /// Constructor.
+  ///
+  /// \param p Stem length, at least 1.
+  /// \param q Base length, at least 1.
+  ProfileBuilder(int p = 2, int q = 3);
+  /// Extracts the sorted pq-gram profile of a tree.
+  ///
+  /// \param root Root of the tree.
+  /// \return The profile.
+  Profile extract(const node::Node<Label>& root) const;
+// Member variables.
+private:
+  /// Stem length.
+  const int p_;
+  /// Base length.
+  const int q_;
+// Member functions.
+private:
+  /// Emits the pq-grams of the subtree rooted at a node.
+  ///
+  /// \param node The node.
+  /// \param stem Label hashes of the p-1 closest ancestors, oldest first.
+  /// \param profile Collects the pq-gram hashes.
+  void extract_recursion(const node::Node<Label>& node,
+                         std::vector<std::uint64_t>& stem,
+                         Profile& profile) const;
+  /// Hashes a pq-gram given by its stem and base label hashes.
+  std::uint64_t hash_gram(const std::vector<std::uint64_t>& stem,
+                          const std::vector<std::uint64_t>& base) const;
+};
+
+/// Computes the size of the bag intersection of two sorted profiles.
+///
+/// \param profile1 A sorted profile.
+/// \param profile2 A sorted profile.
+/// \return Number of common pq-grams, counting duplicates.
+inline long long intersection_size(const Profile& profile1,
+                                   const Profile& profile2);
+
+/// Computes the normalized pq-gram distance 1 - 2|P1 ∩ P2| / (|P1| + |P2|),
+/// a value in [0, 1].
+///
+/// \param profile1 A sorted profile.
+/// \param profile2 A sorted profile.
+/// \return The pq-gram distance.
+inline double pq_gram_distance(const Profile& profile1,
+                               const Profile& profile2);
+
+/// \class Index
+///
+/// \details
+/// Inverted index from pq-grams to the trees of a collection containing them.
+/// A lookup touches only the posting lists of the pq-grams of the query,
+/// thus only trees sharing pq-grams with the query. The remaining trees have
+/// distance 1 and are only enumerated if the lookup asks for them.
+///
+/// \tparam Label Label type. Requires a specialization of std::hash.
+template <class Label>
+class Index {
+// Member functions.
+public:
+  /// Constructor.
+  ///
+  /// \param p Stem length.
+  /// \param q Base length.
+  Index(int p = 2, int q = 3);
+  /// Adds a tree to the index.
+  ///
+  /// \param tree Root of the tree.
+  /// \return Id of the tree, the number of previously added trees.
+  int add(const node::Node<Label>& tree);
+  /// Finds the k trees with the smallest pq-gram distance to a query tree.
+  /// Trees without a common pq-gram (distance 1) are reported by ascending id
+  /// if fewer than k trees share a pq-gram with the query.
+  ///
+  /// \param query Root of the query tree.
+  /// \param k Maximum number of results.
+  /// \return Pairs of tree id and distance, by ascending distance and id.
+  std::vector<std::pair<int, double>> lookup(const node::Node<Label>& query,
+                                             int k) const;
+  /// Finds the trees within a pq-gram distance threshold to a query tree.
+  ///
+  /// \param query Root of the query tree.
+  /// \param threshold Maximum distance. A threshold of at least 1 reports
+  ///                  all trees.
+  /// \return Pairs of tree id and distance, by ascending distance and id.
+  std::vector<std::pair<int, double>> range(const node::Node<Label>& query,
+                                            double threshold) const;
+  /// Returns the number of trees in the index.
+  int size() const;
+// Member variables.
+private:
+  /// Extracts the profiles.
+  const ProfileBuilder<Label> builder_;
+  /// For each pq-gram, pairs of tree id and number of occurrences.
+  std::unordered_map<std::uint64_t, std::vector<std::pair<int, int>>> postings_;
+  /// Profile size of each tree. Indexed by tree id.
+  std::vector<long long> profile_sizes_;
+// Member functions.
+private:
+  /// Computes the distances of all trees sharing a pq-gram with the query.
+  ///
+  /// \param query Root of the query tree.
+  /// \param min_results If fewer trees share a pq-gram with the query, adds
+  ///                    trees with distance 1 by ascending id up to this
+  ///                    number.
+  /// \return Pairs of tree id and distance, unordered.
+  std::vector<std::pair<int, double>> candidates(
+      const node::Node<Label>& query, int min_results) const;
+};
+
+// Implementation details.
+#include "pq_gram_impl.h"
+
+}
+
+#endif // TREE_SIMILARITY_PQ_GRAM_PQ_GRAM_H
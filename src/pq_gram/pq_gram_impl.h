@@ -0,0 +1,219 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+/// \file pq_gram/pq_gram_impl.h
+///
+/// \details
+/// Contains the implementation of the pq-gram profiles, distance, and index.
+
+#ifndef TREE_SIMILARITY_PQ_GRAM_PQ_GRAM_IMPL_H
+#define TREE_SIMILARITY_PQ_GRAM_PQ_GRAM_IMPL_H
+
+/// Hash of the dummy label used for padding.
+constexpr std::uint64_t kDummyHash = 0x2545f4914f6cdd1dULL;
+
+template <class Label>
+ProfileBuilder<Label>::ProfileBuilder(int p, int q)
+    : p_(std::max(p, 1)), q_(std::max(q, 1)) {}
+
+template <class Label>
+Profile ProfileBuilder<Label>::extract(const node::Node<Label>& root) const {
+  Profile profile;
+  std::vector<std::uint64_t> stem(p_, kDummyHash);
+  extract_recursion(root, stem, profile);
+  std::sort(profile.begin(), profile.end());
+  return profile;
+}
+
+template <class Label>
+void ProfileBuilder<Label>::extract_recursion(
+    const node::Node<Label>& node, std::vector<std::uint64_t>& stem,
+    Profile& profile) const {
+  // Shift the node into the stem, its oldest ancestor out.
+  const std::uint64_t kDropped = stem.front();
+  stem.erase(stem.begin());
+  stem.push_back(
+      data_structures::mix_hash(std::hash<Label>()(node.label())));
+
+  std::vector<std::uint64_t> base(q_, kDummyHash);
+  if (node.is_leaf()) {
+    profile.push_back(hash_gram(stem, base));
+  } else {
+    // Slide the base over the children padded with q-1 dummies on each side.
+    for (const auto& child : node.get_children()) {
+      base.erase(base.begin());
+      base.push_back(
+          data_structures::mix_hash(std::hash<Label>()(child.label())));
+      profile.push_back(hash_gram(stem, base));
+    }
+    for (int k = 1; k < q_; ++k) {
+      base.erase(base.begin());
+      base.push_back(kDummyHash);
+      profile.push_back(hash_gram(stem, base));
+    }
+    for (const auto& child : node.get_children()) {
+      extract_recursion(child, stem, profile);
+    }
+  }
+
+  stem.pop_back();
+  stem.insert(stem.begin(), kDropped);
+}
+
+template <class Label>
+std::uint64_t ProfileBuilder<Label>::hash_gram(
+    const std::vector<std::uint64_t>& stem,
+    const std::vector<std::uint64_t>& base) const {
+  std::uint64_t h = 0;
+  for (std::uint64_t e : stem) {
+    h = data_structures::mix_hash(h + e);
+  }
+  for (std::uint64_t e : base) {
+    h = data_structures::mix_hash(h + e);
+  }
+  return h;
+}
+
+inline long long intersection_size(const Profile& profile1,
+                                   const Profile& profile2) {
+  long long common = 0;
+  auto it1 = profile1.begin();
+  auto it2 = profile2.begin();
+  while (it1 != profile1.end() && it2 != profile2.end()) {
+    if (*it1 < *it2) {
+      ++it1;
+    } else if (*it2 < *it1) {
+      ++it2;
+    } else {
+      ++common;
+      ++it1;
+      ++it2;
+    }
+  }
+  return common;
+}
+
+inline double pq_gram_distance(const Profile& profile1,
+                               const Profile& profile2) {
+  const double kSizes = profile1.size() + profile2.size();
+  if (kSizes == 0) {
+    return 0.0;
+  }
+  return 1.0 - 2.0 * intersection_size(profile1, profile2) / kSizes;
+}
+
+template <class Label>
+Index<Label>::Index(int p, int q) : builder_(p, q) {}
+
+template <class Label>
+int Index<Label>::add(const node::Node<Label>& tree) {
+  const int kId = profile_sizes_.size();
+  const Profile kProfile = builder_.extract(tree);
+  profile_sizes_.push_back(kProfile.size());
+  // The profile is sorted, equal pq-grams are adjacent.
+  for (std::size_t begin = 0, end = 0; begin < kProfile.size(); begin = end) {
+    while (end < kProfile.size() && kProfile[end] == kProfile[begin]) {
+      ++end;
+    }
+    postings_[kProfile[begin]].emplace_back(kId, end - begin);
+  }
+  return kId;
+}
+
+template <class Label>
+std::vector<std::pair<int, double>> Index<Label>::candidates(
+    const node::Node<Label>& query, int min_results) const {
+  const Profile kProfile = builder_.extract(query);
+  // Common pq-grams of the touched trees only, the cost of a query does not
+  // grow with the size of the collection.
+  std::unordered_map<int, long long> common;
+  for (std::size_t begin = 0, end = 0; begin < kProfile.size(); begin = end) {
+    while (end < kProfile.size() && kProfile[end] == kProfile[begin]) {
+      ++end;
+    }
+    auto postings = postings_.find(kProfile[begin]);
+    if (postings == postings_.end()) {
+      continue;
+    }
+    const int kCount = end - begin;
+    for (const auto& posting : postings->second) {
+      common[posting.first] += std::min(kCount, posting.second);
+    }
+  }
+  std::vector<std::pair<int, double>> results;
+  results.reserve(std::max<std::size_t>(common.size(),
+      std::min(std::max(min_results, 0), size())));
+  for (const auto& c : common) {
+    results.emplace_back(c.first, 1.0 - 2.0 * c.second /
+        static_cast<double>(kProfile.size() + profile_sizes_[c.first]));
+  }
+  // Fill up with untouched trees, smallest ids first.
+  for (int id = 0; static_cast<int>(results.size()) < min_results &&
+       id < size(); ++id) {
+    if (common.find(id) == common.end()) {
+      results.emplace_back(id, 1.0);
+    }
+  }
+  return results;
+}
+
+/// Orders lookup results by ascending distance and id.
+inline bool closer(const std::pair<int, double>& a,
+                   const std::pair<int, double>& b) {
+  return a.second < b.second || (a.second == b.second && a.first < b.first);
+}
+
+template <class Label>
+std::vector<std::pair<int, double>> Index<Label>::lookup(
+    const node::Node<Label>& query, int k) const {
+  std::vector<std::pair<int, double>> results = candidates(query, k);
+  if (k < static_cast<int>(results.size())) {
+    std::partial_sort(results.begin(), results.begin() + std::max(k, 0),
+                      results.end(), closer);
+    results.resize(std::max(k, 0));
+  } else {
+    std::sort(results.begin(), results.end(), closer);
+  }
+  return results;
+}
+
+template <class Label>
+std::vector<std::pair<int, double>> Index<Label>::range(
+    const node::Node<Label>& query, double threshold) const {
+  std::vector<std::pair<int, double>> results =
+      candidates(query, threshold >= 1.0 ? size() : 0);
+  results.erase(std::remove_if(results.begin(), results.end(),
+                               [threshold](const std::pair<int, double>& r) {
+                                 return r.second > threshold;
+                               }),
+                results.end());
+  std::sort(results.begin(), results.end(), closer);
+  return results;
+}
+
+template <class Label>
+int Index<Label>::size() const {
+  return profile_sizes_.size();
+}
+
+#endif // TREE_SIMILARITY_PQ_GRAM_PQ_GRAM_IMPL_H
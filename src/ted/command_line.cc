@@ -26,32 +26,357 @@
 
 #include "command_line.h"
 
+/// Prints statistics of a TED computation in a single key=value line, such
+/// that it can be easily grepped from logs.
+///
+/// \param stats Statistics of the last TED computation.
+template <typename Statistics>
+void print_ted_statistics(const Statistics& stats) {
+  if (!Statistics::kEnabled) {
+    std::cout << "STATS disabled (build with TREE_SIMILARITY_STATISTICS)"
+              << std::endl;
+    return;
+  }
+  std::cout << "STATS"
+            << " t1_size=" << stats.t1_size
+            << " t2_size=" << stats.t2_size
+            << " t1_key_roots=" << stats.t1_key_roots
+            << " t2_key_roots=" << stats.t2_key_roots
+            << " forest_distance_calls=" << stats.forest_distance_calls
+            << " key_root_pairs_reused=" << stats.key_root_pairs_reused
+            << " cache_hits=" << stats.cache_hits
+            << " cells_computed=" << stats.cells_computed
+            << " matrix_bytes=" << stats.matrix_bytes
+            << " indexing_time_ms=" << stats.indexing_time_ms
+            << " dp_time_ms=" << stats.dp_time_ms
+            << std::endl;
+}
+
+/// Parses an integer command-line value that must be consumed completely.
+///
+/// \param value The command-line value.
+/// \param min Smallest accepted value.
+/// \param result The parsed value, unchanged if the value is rejected.
+/// \return True if value is a whole number from min to INT_MAX.
+bool parse_int(const char* value, long min, int& result) {
+  char* end = nullptr;
+  errno = 0;
+  const long kValue = std::strtol(value, &end, 10);
+  if (errno != 0 || end == value || *end != '\0' || kValue < min ||
+      kValue > INT_MAX) {
+    return false;
+  }
+  result = static_cast<int>(kValue);
+  return true;
+}
+
+/// Prints the usage of all modes to stderr.
+void print_usage() {
+  std::cerr << "Usage: ted [--stats] [--mapping] [--costs COSTS_FILE] [--memory-budget-mb MB] [--cache CACHE_FILE] SOURCE_TREE DESTINATION_TREE" << std::endl;
+  std::cerr << "       ted --server CORPUS_FILE [--socket PATH] [--threads N] [--deadline-ms MS] [--max-in-flight N]" << std::endl;
+  std::cerr << "       ted --collection FILE --shard S/N [--threshold TAU] [--costs COSTS_FILE] --output SHARD_FILE" << std::endl;
+  std::cerr << "       ted --merge [--output FILE] SHARD_FILE..." << std::endl;
+}
+
+/// Verifies that a mode supports every given option, such that no option is
+/// silently ignored. Prints an error and the usage otherwise.
+///
+/// \param mode The option selecting the mode, e.g., "--server".
+/// \param options The given options, in command-line order.
+/// \param supported The options supported by the mode, including mode.
+/// \return True if all given options are supported.
+bool check_options(const std::string& mode,
+                   const std::vector<std::string>& options,
+                   const std::vector<std::string>& supported) {
+  for (const std::string& option : options) {
+    if (std::find(supported.begin(), supported.end(), option) ==
+        supported.end()) {
+      std::cerr << "Option " << option << " is not supported with " << mode
+                << "." << std::endl;
+      print_usage();
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Computes and prints the tree edit distance between two trees.
+///
+/// \param c The cost model.
+/// \param trees Source and destination trees in bracket notation.
+/// \param print_statistics Print statistics of the computation.
+/// \param print_mapping Print an optimal edit mapping, one edit operation per
+///        line with nodes identified by postorder ids starting with 1.
+/// \param memory_budget If positive, the pair is planned with a
+///        ted_planner::Planner: the chosen engine, orientation, and estimated
+///        costs are printed, the pair is rejected if no exact computation fits
+///        this number of bytes. The distance is computed in the planned
+///        orientation unless a mapping is printed, whose postorder ids refer
+///        to the input trees.
+/// \param cache_file If not empty, the distance is looked up in and stored to
+///        this persistent cache file, unless a mapping is printed.
+/// \param cost_model_id Fingerprint of the cost model, part of the cache key.
+/// \return 0 on success, -1 if a tree is malformed, the pair is rejected,
+///         or the cache fails.
+template <typename Label, typename CostModel>
+int execute_ted(const CostModel& c, const std::vector<std::string>& trees,
+                bool print_statistics, bool print_mapping,
+                long long memory_budget, const std::string& cache_file,
+                std::uint64_t cost_model_id) {
+  // The parser does not validate its input.
+  for (const std::string& tree : trees) {
+    if (!ted_server::is_bracket_notation(tree)) {
+      std::cerr << "Malformed tree: " << tree << std::endl;
+      return -1;
+    }
+  }
+
+  parser::BracketNotationParser bnp;
+  node::Node<Label> source_tree = bnp.parse_string(trees[0]);
+  node::Node<Label> destination_tree = bnp.parse_string(trees[1]);
+
+  if (memory_budget > 0) {
+    // Only exact computations are planned, i.e., Zhang and Shasha in the
+    // orientation with fewer subproblems.
+    ted_planner::Planner<Label, CostModel> planner(c, memory_budget);
+    const ted_planner::Estimate plan =
+        planner.plan(source_tree, destination_tree);
+    std::cout << "PLAN engine=" << ted_planner::engine_name(plan.engine)
+              << " mirrored=" << plan.mirrored
+              << " subproblems=" << plan.subproblems
+              << " peak_bytes=" << plan.peak_bytes << std::endl;
+    if (plan.engine == ted_planner::Engine::kRejected) {
+      std::cerr << "The computation exceeds the memory budget of "
+                << memory_budget << " bytes." << std::endl;
+      return -1;
+    }
+    // Mirroring preserves the distance, but not the postorder ids.
+    if (plan.mirrored && !print_mapping) {
+      source_tree = ted_planner::mirror(source_tree);
+      destination_tree = ted_planner::mirror(destination_tree);
+    }
+  }
+
+  zhang_shasha::Algorithm<Label, CostModel> zs_ted(c);
+
+  // A mapping needs a computation, the cache is not used.
+  if (!cache_file.empty() && !print_mapping) {
+    zhang_shasha::PersistentDistanceCache cache;
+    if (!cache.open(cache_file)) {
+      std::cerr << "Error while opening the cache: " << cache.get_error() << std::endl;
+      return -1;
+    }
+    std::cout << "TED = " << cache.ted(zs_ted, source_tree, destination_tree, cost_model_id) << std::endl;
+    if (print_statistics) {
+      // On a hit nothing is computed and the computation counters are zero.
+      print_ted_statistics(zs_ted.get_statistics());
+      const auto cache_stats = cache.get_statistics();
+      std::cout << "CACHE"
+                << " hits=" << cache_stats.hits
+                << " misses=" << cache_stats.misses
+                << " entries=" << cache_stats.entries
+                << " loaded=" << cache_stats.loaded
+                << std::endl;
+    }
+    if (!cache.flush()) {
+      std::cerr << "Error while writing the cache: " << cache.get_error() << std::endl;
+      return -1;
+    }
+    return 0;
+  }
+
+  std::cout << "TED = " << zs_ted.zhang_shasha_ted(source_tree, destination_tree) << std::endl;
+
+  if (print_statistics) {
+    print_ted_statistics(zs_ted.get_statistics());
+  }
+
+  if (print_mapping) {
+    const auto mapping = zs_ted.compute_edit_mapping();
+    for (const auto& p : mapping.matched) {
+      std::cout << "MATCH " << p.first << " " << p.second << std::endl;
+    }
+    for (const auto& p : mapping.renamed) {
+      std::cout << "RENAME " << p.first << " " << p.second << std::endl;
+    }
+    for (int i : mapping.deleted) {
+      std::cout << "DELETE " << i << std::endl;
+    }
+    for (int j : mapping.inserted) {
+      std::cout << "INSERT " << j << std::endl;
+    }
+  }
+  return 0;
+}
+
 int main(int argc, char** argv) {
 
   // const std::string s("{\"a\"{\"\\{[b],\\{key:\\\"value\\\"\\}\\}\"{\"\"}}}");
 
   using Label = label::StringLabel;
-  using CostModel = cost_model::UnitCostModel<Label>;
+
+  // Parse parameters: two trees and optional flags.
+  bool print_statistics = false;
+  bool print_mapping = false;
+  bool server_mode = false;
+  std::string costs_file;
+  std::string cache_file;
+  long long memory_budget = 0;
+  ted_server::ServerOptions server_options;
+  bool merge_mode = false;
+  ted_shard::ShardOptions shard_options;
+  std::vector<std::string> trees;
+  std::vector<std::string> options;
+  for (int i = 1; i < argc; ++i) {
+    const std::string argument(argv[i]);
+    if (argument.compare(0, 2, "--") == 0) {
+      options.push_back(argument);
+    }
+    if (argument == "--stats") {
+      print_statistics = true;
+    } else if (argument == "--mapping") {
+      print_mapping = true;
+    } else if (argument == "--memory-budget-mb" && i + 1 < argc) {
+      // Shifting is defined for positive values that do not overflow.
+      char* end = nullptr;
+      errno = 0;
+      const long long kMegabytes = std::strtoll(argv[++i], &end, 10);
+      if (errno != 0 || end == argv[i] || *end != '\0' || kMegabytes <= 0 ||
+          kMegabytes > (LLONG_MAX >> 20)) {
+        std::cerr << "Invalid memory budget: " << argv[i] << std::endl;
+        print_usage();
+        return -1;
+      }
+      memory_budget = kMegabytes << 20;
+    } else if (argument == "--cache" && i + 1 < argc) {
+      cache_file = argv[++i];
+    } else if (argument == "--costs" && i + 1 < argc) {
+      costs_file = argv[++i];
+    } else if (argument == "--server" && i + 1 < argc) {
+      server_mode = true;
+      server_options.corpus_file = argv[++i];
+    } else if (argument == "--socket" && i + 1 < argc) {
+      server_options.socket_path = argv[++i];
+    } else if (argument == "--threads" && i + 1 < argc) {
+      if (!parse_int(argv[++i], 1, server_options.threads)) {
+        std::cerr << "Invalid number of threads: " << argv[i] << std::endl;
+        print_usage();
+        return -1;
+      }
+    } else if (argument == "--deadline-ms" && i + 1 < argc) {
+      if (!parse_int(argv[++i], 0, server_options.deadline_ms)) {
+        std::cerr << "Invalid deadline: " << argv[i] << std::endl;
+        print_usage();
+        return -1;
+      }
+    } else if (argument == "--max-in-flight" && i + 1 < argc) {
+      if (!parse_int(argv[++i], 1, server_options.max_in_flight)) {
+        std::cerr << "Invalid maximum of in-flight requests: " << argv[i]
+                  << std::endl;
+        print_usage();
+        return -1;
+      }
+    } else if (argument == "--collection" && i + 1 < argc) {
+      shard_options.collection_file = argv[++i];
+    } else if (argument == "--shard" && i + 1 < argc) {
+      // S/N, a shard outside of 0..N-1 is reported by run_shard.
+      const std::string kShard(argv[++i]);
+      const std::size_t kSlash = kShard.find('/');
+      if (kSlash == std::string::npos ||
+          !parse_int(kShard.substr(0, kSlash).c_str(), 0, shard_options.shard) ||
+          !parse_int(kShard.c_str() + kSlash + 1, 1, shard_options.shards)) {
+        std::cerr << "Invalid shard: " << argv[i] << std::endl;
+        print_usage();
+        return -1;
+      }
+    } else if (argument == "--threshold" && i + 1 < argc) {
+      char* end = nullptr;
+      errno = 0;
+      const double kThreshold = std::strtod(argv[++i], &end);
+      if (errno != 0 || end == argv[i] || *end != '\0' ||
+          !std::isfinite(kThreshold) || kThreshold < 0) {
+        std::cerr << "Invalid threshold: " << argv[i] << std::endl;
+        print_usage();
+        return -1;
+      }
+      shard_options.threshold = kThreshold;
+    } else if (argument == "--output" && i + 1 < argc) {
+      shard_options.output_file = argv[++i];
+    } else if (argument == "--merge") {
+      merge_mode = true;
+    } else {
+      trees.push_back(argument);
+    }
+  }
+
+  if (server_mode) {
+    // The trees of the server are read from the corpus and the requests.
+    if (!trees.empty()) {
+      std::cerr << "Unexpected argument with --server: " << trees[0] << std::endl;
+      print_usage();
+      return -1;
+    }
+    // The server computes unit-cost distances without a cache or planner.
+    if (!check_options("--server", options,
+                       {"--server", "--socket", "--threads", "--deadline-ms",
+                        "--max-in-flight"})) {
+      return -1;
+    }
+    return ted_server::run_server(server_options);
+  }
+
+  if (merge_mode) {
+    if (!check_options("--merge", options, {"--merge", "--output"})) {
+      return -1;
+    }
+    return ted_shard::run_merge(trees, shard_options.output_file);
+  }
+
+  if (!shard_options.collection_file.empty()) {
+    // The trees of a shard are read from the collection.
+    if (!trees.empty()) {
+      std::cerr << "Unexpected argument with --collection: " << trees[0] << std::endl;
+      print_usage();
+      return -1;
+    }
+    // Shards compute all distances exactly, without a cache or planner.
+    if (!check_options("--collection", options,
+                       {"--collection", "--shard", "--threshold", "--costs",
+                        "--output"})) {
+      return -1;
+    }
+    shard_options.costs_file = costs_file;
+    return ted_shard::run_shard(shard_options);
+  }
 
   // Verify parameters.
-  if (argc != 3) {
+  if (trees.size() != 2) {
     std::cerr << "Incorrect number of parameters." << std::endl;
+    print_usage();
     return -1;
   }
 
   // TODO: Trees passed as command-line arguments must be sorrounded with ''.
 
-  std::cout << "Source tree: " << argv[1] << std::endl;
-  std::cout << "Destination tree: " << argv[2] << std::endl;
-
-  // TODO: Implement verification of the input format!
+  std::cout << "Source tree: " << trees[0] << std::endl;
+  std::cout << "Destination tree: " << trees[1] << std::endl;
 
-  parser::BracketNotationParser bnp;
-  const node::Node<Label> source_tree = bnp.parse_string(argv[1]);
-  const node::Node<Label> destination_tree = bnp.parse_string(argv[2]);
-
-  zhang_shasha::Algorithm<Label, CostModel> zs_ted;
-  std::cout << "TED = " << zs_ted.zhang_shasha_ted(source_tree, destination_tree) << std::endl;
-
-  return 0;
+  if (costs_file.empty()) {
+    return execute_ted<Label>(cost_model::UnitCostModel<Label>(), trees,
+                              print_statistics, print_mapping, memory_budget,
+                              cache_file,
+                              zhang_shasha::PersistentDistanceCache::fingerprint("unit"));
+  } else {
+    cost_model::WeightedCostModel<Label> weighted_costs;
+    if (!weighted_costs.read_from_file(costs_file)) {
+      std::cerr << "Error while reading costs: " << weighted_costs.get_error() << std::endl;
+      return -1;
+    }
+    // Cached distances are valid as long as the costs file is unchanged.
+    std::ostringstream costs;
+    costs << std::ifstream(costs_file).rdbuf();
+    return execute_ted<Label>(weighted_costs, trees, print_statistics,
+                              print_mapping, memory_budget, cache_file,
+                              zhang_shasha::PersistentDistanceCache::fingerprint(costs.str()));
+  }
 }
@@ -30,8 +30,22 @@
 #include "node.h"
 #include "string_label.h"
 #include "unit_cost_model.h"
+#include "weighted_cost_model.h"
 #include "zhang_shasha.h"
+#include "persistent_distance_cache.h"
 #include "bracket_notation_parser.h"
+#include "server.h"
+#include "shard.h"
+#include "ted_planner.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
 
 #endif // TREE_SIMILARITY_TED_H
@@ -0,0 +1,635 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file ted/server.cc
+///
+/// \details
+/// Implementation of the long-running TED server.
+
+#include "server.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <csignal>
+#include <exception>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <sstream>
+#include <streambuf>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <pthread.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "node.h"
+#include "string_label.h"
+#include "unit_cost_model.h"
+#include "zhang_shasha.h"
+#include "bracket_notation_parser.h"
+#include "worker_pool.h"
+
+namespace ted_server {
+
+namespace {
+
+using Label = label::StringLabel;
+// The bounded and top-k requests prune by the size difference of the trees,
+// which is a lower bound of the distance for unit costs only. Another cost
+// model needs another bound in Server::handle.
+using CostModel = cost_model::UnitCostModel<Label>;
+using Tree = node::Node<Label>;
+using Algorithm = zhang_shasha::Algorithm<Label, CostModel>;
+using Clock = std::chrono::steady_clock;
+using Interval = Algorithm::Interval;
+
+/// A corpus tree together with its size (used for size-based pruning).
+struct CorpusTree {
+  Tree tree;
+  int size;
+};
+
+/// Stream buffer over a file descriptor (used for socket connections). A
+/// failed write, e.g., to a connection closed by the client, sets badbit on
+/// the stream instead of raising SIGPIPE.
+class FdStreamBuf : public std::streambuf {
+public:
+  FdStreamBuf(int fd) : fd_(fd) {
+    setg(in_buffer_, in_buffer_, in_buffer_);
+    setp(out_buffer_, out_buffer_ + kBufferSize);
+  }
+  ~FdStreamBuf() { sync(); }
+
+protected:
+  int_type underflow() override {
+    ssize_t n = ::read(fd_, in_buffer_, kBufferSize);
+    if (n <= 0) {
+      return traits_type::eof();
+    }
+    setg(in_buffer_, in_buffer_, in_buffer_ + n);
+    return traits_type::to_int_type(in_buffer_[0]);
+  }
+  int_type overflow(int_type c) override {
+    if (sync() != 0) {
+      return traits_type::eof();
+    }
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+      *pptr() = traits_type::to_char_type(c);
+      pbump(1);
+    }
+    return traits_type::not_eof(c);
+  }
+  int sync() override {
+    const char* data = pbase();
+    while (data < pptr()) {
+#ifdef MSG_NOSIGNAL
+      ssize_t n = ::send(fd_, data, pptr() - data, MSG_NOSIGNAL);
+#else
+      ssize_t n = ::write(fd_, data, pptr() - data);
+#endif
+      if (n <= 0) {
+        return -1;
+      }
+      data += n;
+    }
+    setp(out_buffer_, out_buffer_ + kBufferSize);
+    return 0;
+  }
+
+private:
+  static const int kBufferSize = 4096;
+  int fd_;
+  char in_buffer_[kBufferSize];
+  char out_buffer_[kBufferSize];
+};
+
+/// Formats a distance, or its bounds if it is not exact.
+std::string format_distance(const Interval& d) {
+  std::ostringstream out;
+  out << d.lower;
+  if (!d.exact) {
+    out << ".." << d.upper;
+  }
+  return out.str();
+}
+
+class Server {
+public:
+  Server(std::vector<CorpusTree> corpus, int threads, int deadline_ms,
+         int max_in_flight)
+      : corpus_(std::move(corpus)), deadline_ms_(deadline_ms),
+        max_in_flight_(std::max(1, max_in_flight)), latencies_(100000),
+        pool_(threads) {}
+
+  /// Serves requests of one connection. Returns when the input ends and all
+  /// its responses are written. Stops reading while max_in_flight requests
+  /// wait for their responses to be written.
+  void serve(std::istream& in, std::ostream& out) {
+    std::queue<std::future<std::string>> responses;
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool input_done = false;
+    // Set when a response cannot be written, e.g., the client closed the
+    // connection. Ends this connection only.
+    bool output_failed = false;
+
+    // Writes responses in the order of requests.
+    std::thread writer([&] {
+      while (true) {
+        std::future<std::string> response;
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          condition.wait(lock, [&] { return input_done || !responses.empty(); });
+          if (responses.empty()) {
+            return;
+          }
+          response = std::move(responses.front());
+          if (output_failed) {
+            responses.pop();
+            condition.notify_all();
+            continue;
+          }
+        }
+        out << response.get() << '\n';
+        out.flush();
+        {
+          // The request leaves the queue only when its response is written,
+          // such that the queue bounds the unanswered requests.
+          std::lock_guard<std::mutex> lock(mutex);
+          responses.pop();
+          if (!out) {
+            output_failed = true;
+          }
+        }
+        condition.notify_all();
+      }
+    });
+
+    for (std::string line; std::getline(in, line);) {
+      if (!line.empty() && line.back() == '\r') {
+        line.pop_back();
+      }
+      if (line.empty()) {
+        continue;
+      }
+      if (line == "quit") {
+        break;
+      }
+      auto promise = std::make_shared<std::promise<std::string>>();
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [&] {
+          return output_failed ||
+                 static_cast<int>(responses.size()) < max_in_flight_;
+        });
+        if (output_failed) {
+          break;
+        }
+        responses.push(promise->get_future());
+      }
+      condition.notify_all();
+      const auto received = Clock::now();
+      if (line == "stats") {
+        // Answered without a worker, it does not contribute to latencies.
+        promise->set_value("OK " + latencies_.summary());
+        continue;
+      }
+      pool_.submit([this, line, promise, received](Algorithm& ted) {
+        // Every request is answered, also if it fails, e.g., with bad_alloc
+        // on a large query.
+        std::string response;
+        try {
+          response = handle(line, received, ted);
+        } catch (const std::exception& e) {
+          response = std::string("ERR ") + e.what();
+        } catch (...) {
+          response = "ERR internal error";
+        }
+        // Recorded before the response is released, such that a summary
+        // printed after the last response counts every request.
+        latencies_.record(std::chrono::duration<double, std::milli>(
+            Clock::now() - received).count());
+        promise->set_value(std::move(response));
+      });
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      input_done = true;
+    }
+    condition.notify_all();
+    writer.join();
+  }
+
+  /// Returns latency percentiles of all requests served so far.
+  std::string latency_summary() const {
+    return latencies_.summary();
+  }
+
+private:
+  /// Computes the distance between two trees, or its bounds if the deadline
+  /// passes first.
+  Interval distance(const Tree& query, const Tree& tree, Clock::time_point deadline,
+                    Algorithm& ted) const {
+    if (deadline_ms_ > 0) {
+      return ted.zhang_shasha_ted_anytime(query, tree, deadline);
+    }
+    Interval d;
+    d.lower = d.upper = ted.zhang_shasha_ted(query, tree);
+    d.exact = true;
+    return d;
+  }
+
+  /// Parses and executes one request using the worker's TED workspace.
+  std::string handle(const std::string& request, Clock::time_point received,
+                     Algorithm& ted) {
+    const Clock::time_point deadline =
+        received + std::chrono::milliseconds(deadline_ms_);
+    std::istringstream tokens(request);
+    std::string command;
+    tokens >> command;
+    double tau = 0.0;
+    long long k = 0;
+    if (command == "bounded") {
+      if (!(tokens >> tau) || tau < 0) {
+        return "ERR bounded expects a non-negative threshold";
+      }
+    } else if (command == "topk") {
+      if (!(tokens >> k) || k <= 0) {
+        return "ERR topk expects a positive k";
+      }
+    } else if (command != "distance") {
+      return "ERR unknown command '" + command + "'";
+    }
+    std::string tree_string;
+    std::getline(tokens >> std::ws, tree_string);
+    if (!is_bracket_notation(tree_string)) {
+      return "ERR malformed tree";
+    }
+    parser::BracketNotationParser bnp;
+    const Tree query = bnp.parse_string(tree_string);
+    const int query_size = query.get_tree_size();
+
+    std::ostringstream out;
+    out << "OK";
+    if (command == "distance") {
+      for (const auto& c : corpus_) {
+        out << " " << format_distance(distance(query, c.tree, deadline, ted));
+      }
+      return out.str();
+    }
+
+    // With unit costs, the size difference is a lower bound for TED. Visit
+    // the corpus in the order of this bound to prune early.
+    std::vector<std::pair<int, int>> order; // (lower bound, corpus id)
+    order.reserve(corpus_.size());
+    for (int id = 0; id < static_cast<int>(corpus_.size()); ++id) {
+      order.emplace_back(std::abs(query_size - corpus_[id].size), id);
+    }
+    std::sort(order.begin(), order.end());
+
+    // Results are ranked by upper bounds, equal to the distances if exact.
+    std::vector<std::pair<Interval, int>> results; // (distance, corpus id)
+    auto by_upper_bound = [](const std::pair<Interval, int>& a,
+                             const std::pair<Interval, int>& b) {
+      return a.first.upper < b.first.upper ||
+             (a.first.upper == b.first.upper && a.second < b.second);
+    };
+    for (const auto& candidate : order) {
+      if (command == "bounded") {
+        if (candidate.first > tau) {
+          break;
+        }
+        Interval d = distance(query, corpus_[candidate.second].tree, deadline,
+                              ted);
+        if (d.lower <= tau) {
+          results.emplace_back(d, candidate.second);
+        }
+      } else { // topk
+        if (static_cast<long long>(results.size()) == k &&
+            candidate.first > results.back().first.upper) {
+          break;
+        }
+        results.emplace_back(
+            distance(query, corpus_[candidate.second].tree, deadline, ted),
+            candidate.second);
+        std::sort(results.begin(), results.end(), by_upper_bound);
+        if (static_cast<long long>(results.size()) > k) {
+          results.pop_back();
+        }
+      }
+    }
+    std::sort(results.begin(), results.end(), by_upper_bound);
+    for (const auto& r : results) {
+      out << " " << r.second << ":" << format_distance(r.first);
+    }
+    return out.str();
+  }
+
+  /// The loaded corpus; read-only while serving.
+  const std::vector<CorpusTree> corpus_;
+  /// Request deadline in milliseconds, or 0 for exact distances only.
+  const int deadline_ms_;
+  /// Maximum number of unanswered requests of one connection.
+  const int max_in_flight_;
+  /// Latencies of served requests.
+  LatencyRecorder latencies_;
+  /// Workers owning the TED workspaces. Declared last to be destroyed first.
+  WorkerPool<Algorithm> pool_;
+};
+
+} // namespace
+
+LatencyRecorder::LatencyRecorder(std::size_t capacity) : capacity_(capacity) {}
+
+void LatencyRecorder::record(double milliseconds) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (samples_.size() < capacity_) {
+    samples_.push_back(milliseconds);
+  } else {
+    samples_[count_ % capacity_] = milliseconds;
+  }
+  ++count_;
+}
+
+std::string LatencyRecorder::summary() const {
+  std::vector<double> sorted;
+  long long count;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sorted = samples_;
+    count = count_;
+  }
+  std::sort(sorted.begin(), sorted.end());
+  std::ostringstream out;
+  out << "requests=" << count;
+  const double percentiles[] = {50.0, 90.0, 99.0, 100.0};
+  const char* names[] = {"p50_ms", "p90_ms", "p99_ms", "max_ms"};
+  for (int i = 0; i < 4; ++i) {
+    double value = 0.0;
+    if (!sorted.empty()) {
+      // Nearest-rank percentile.
+      std::size_t rank = static_cast<std::size_t>(
+          std::ceil(percentiles[i] / 100.0 * sorted.size()));
+      value = sorted[std::max<std::size_t>(rank, 1) - 1];
+    }
+    out << " " << names[i] << "=" << value;
+  }
+  return out.str();
+}
+
+bool is_bracket_notation(const std::string& s) {
+  // Every '{' opens a node and must be followed by its quoted label. After a
+  // label or a closing '}', only a child '{' or the closing '}' of the
+  // current node may follow.
+  int depth = 0;
+  std::size_t i = 0;
+  while (i < s.size()) {
+    if (s[i] == '{') {
+      ++depth;
+      if (++i == s.size() || s[i] != '"') {
+        return false;
+      }
+      // Skip the label up to its closing quote. Quotes and braces in labels
+      // must be escaped.
+      for (++i; i < s.size() && s[i] != '"'; ++i) {
+        if (s[i] == '\\') {
+          ++i;
+        } else if (s[i] == '{' || s[i] == '}') {
+          return false;
+        }
+      }
+      if (i >= s.size()) {
+        return false;
+      }
+      ++i;
+    } else if (s[i] == '}') {
+      ++i;
+      if (--depth < 0) {
+        return false;
+      }
+      if (depth == 0) {
+        return i == s.size();
+      }
+    } else {
+      return false;
+    }
+  }
+  return false;
+}
+
+namespace {
+
+/// Loads the corpus file of the server.
+bool load_corpus(const std::string& corpus_file_name,
+                 std::vector<CorpusTree>& corpus) {
+  std::ifstream corpus_file(corpus_file_name);
+  if (!corpus_file.is_open()) {
+    std::cerr << "Error while opening file: " << corpus_file_name << std::endl;
+    return false;
+  }
+  int line_number = 0;
+  for (std::string line; std::getline(corpus_file, line);) {
+    ++line_number;
+    if (!is_bracket_notation(line)) {
+      std::cerr << "Malformed tree on line " << line_number << " of "
+                << corpus_file_name << std::endl;
+      return false;
+    }
+    parser::BracketNotationParser bnp;
+    Tree tree = bnp.parse_string(line);
+    const int size = tree.get_tree_size();
+    corpus.push_back({std::move(tree), size});
+  }
+  std::cerr << "Loaded " << corpus.size() << " trees." << std::endl;
+  return true;
+}
+
+/// A socket connection served by its own thread.
+struct Connection {
+  /// Socket of the connection, closed after the thread is joined.
+  int fd = -1;
+  /// Thread reading the requests of the connection.
+  std::thread thread;
+  /// Set by the thread when it has written its last response. Guarded by the
+  /// mutex of the connection list.
+  bool done = false;
+};
+
+/// Set by SIGINT and SIGTERM to stop the socket server.
+volatile std::sig_atomic_t stop_requested = 0;
+
+/// Signal handler stopping the socket server.
+void request_stop(int) {
+  stop_requested = 1;
+}
+
+/// Returns the number of worker threads of the server.
+int worker_threads(const ServerOptions& options) {
+  if (options.threads > 0) {
+    return options.threads;
+  }
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+} // namespace
+
+int serve_stream(const ServerOptions& options, std::istream& in,
+                 std::ostream& out) {
+  std::vector<CorpusTree> corpus;
+  if (!load_corpus(options.corpus_file, corpus)) {
+    return -1;
+  }
+  Server server(std::move(corpus), worker_threads(options),
+                std::max(0, options.deadline_ms), options.max_in_flight);
+  server.serve(in, out);
+  std::cerr << "LATENCY " << server.latency_summary() << std::endl;
+  return 0;
+}
+
+int run_server(const ServerOptions& options) {
+  // A client closing its connection early must not terminate the server.
+  std::signal(SIGPIPE, SIG_IGN);
+  if (options.socket_path.empty()) {
+    return serve_stream(options, std::cin, std::cout);
+  }
+  std::vector<CorpusTree> corpus;
+  if (!load_corpus(options.corpus_file, corpus)) {
+    return -1;
+  }
+  // SIGINT and SIGTERM must interrupt accept in this thread. Every other
+  // thread, starting with the workers, blocks them.
+  sigset_t stop_signals;
+  sigemptyset(&stop_signals);
+  sigaddset(&stop_signals, SIGINT);
+  sigaddset(&stop_signals, SIGTERM);
+  ::pthread_sigmask(SIG_BLOCK, &stop_signals, nullptr);
+  Server server(std::move(corpus), worker_threads(options),
+                std::max(0, options.deadline_ms), options.max_in_flight);
+
+  int listen_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un address = {};
+  address.sun_family = AF_UNIX;
+  if (listen_fd < 0 ||
+      options.socket_path.size() >= sizeof(address.sun_path)) {
+    std::cerr << "Cannot create socket: " << options.socket_path << std::endl;
+    ::pthread_sigmask(SIG_UNBLOCK, &stop_signals, nullptr);
+    return -1;
+  }
+  options.socket_path.copy(address.sun_path, options.socket_path.size());
+  ::unlink(options.socket_path.c_str());
+  if (::bind(listen_fd, reinterpret_cast<sockaddr*>(&address),
+             sizeof(address)) != 0 ||
+      ::listen(listen_fd, 64) != 0) {
+    std::cerr << "Cannot listen on socket: " << options.socket_path << std::endl;
+    ::close(listen_fd);
+    ::pthread_sigmask(SIG_UNBLOCK, &stop_signals, nullptr);
+    return -1;
+  }
+  std::cerr << "Listening on " << options.socket_path << std::endl;
+
+  // The signals interrupt accept (no SA_RESTART) and end the loop.
+  struct sigaction action = {};
+  action.sa_handler = request_stop;
+  sigemptyset(&action.sa_mask);
+  ::sigaction(SIGINT, &action, nullptr);
+  ::sigaction(SIGTERM, &action, nullptr);
+  ::pthread_sigmask(SIG_UNBLOCK, &stop_signals, nullptr);
+
+  std::list<Connection> connections;
+  std::mutex connections_mutex;
+  // Joins the threads of finished connections and closes their sockets. A
+  // connection thread only shuts its socket down, such that a socket shut
+  // down by the stop below cannot be a reused descriptor.
+  auto reap = [&connections, &connections_mutex](bool all) {
+    std::list<Connection> finished;
+    {
+      std::lock_guard<std::mutex> lock(connections_mutex);
+      for (auto it = connections.begin(); it != connections.end();) {
+        if (all || it->done) {
+          if (!it->done) {
+            ::shutdown(it->fd, SHUT_RDWR);
+          }
+          auto next = std::next(it);
+          finished.splice(finished.end(), connections, it);
+          it = next;
+        } else {
+          ++it;
+        }
+      }
+    }
+    for (auto& connection : finished) {
+      connection.thread.join();
+      ::close(connection.fd);
+    }
+  };
+
+  while (!stop_requested) {
+    int connection_fd = ::accept(listen_fd, nullptr, nullptr);
+    reap(false);
+    if (connection_fd < 0) {
+      continue;
+    }
+    // Every connection is read by its own thread; the computations of all
+    // connections share the worker pool.
+    std::lock_guard<std::mutex> lock(connections_mutex);
+    connections.emplace_back();
+    Connection& connection = connections.back();
+    connection.fd = connection_fd;
+    connection.thread = std::thread(
+        [&server, &connection, &connections_mutex, stop_signals] {
+          ::pthread_sigmask(SIG_BLOCK, &stop_signals, nullptr);
+          {
+            FdStreamBuf in_buffer(connection.fd);
+            FdStreamBuf out_buffer(connection.fd);
+            std::istream in(&in_buffer);
+            std::ostream out(&out_buffer);
+            server.serve(in, out);
+          }
+          // Ends the connection for the client now, the socket is closed
+          // when the thread is joined.
+          ::shutdown(connection.fd, SHUT_RDWR);
+          std::lock_guard<std::mutex> lock(connections_mutex);
+          connection.done = true;
+        });
+  }
+
+  ::close(listen_fd);
+  ::unlink(options.socket_path.c_str());
+  reap(true);
+  std::cerr << "LATENCY " << server.latency_summary() << std::endl;
+  return 0;
+}
+
+} // namespace ted_server
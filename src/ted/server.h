@@ -0,0 +1,128 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file ted/server.h
+///
+/// \details
+/// Long-running TED server. The server loads a corpus of trees once and
+/// answers queries read line by line from stdin or from a Unix domain socket.
+/// Every request is one line of the form:
+///
+///   distance TREE        -> OK d_0 d_1 ... d_{n-1}
+///   bounded TAU TREE     -> OK id:d id:d ...   (all corpus trees with d <= TAU)
+///   topk K TREE          -> OK id:d id:d ...   (K nearest, ascending distance)
+///   stats                -> OK requests=... p50_ms=... p90_ms=... p99_ms=...
+///
+/// where TREE is in bracket notation and ids are 0-based line numbers of the
+/// corpus file. Malformed requests are answered with "ERR message". Requests
+/// of one connection are processed concurrently on a pool of workers, each
+/// owning a reusable TED workspace, and answered in the order of arrival.
+///
+/// If a request deadline is configured, distances not computed before the
+/// deadline of their request are reported as bounds "lower..upper" in place
+/// of d. Bounded results then include every tree whose lower bound is within
+/// TAU, and top-k results are ranked by upper bounds.
+
+#ifndef TREE_SIMILARITY_TED_SERVER_H
+#define TREE_SIMILARITY_TED_SERVER_H
+
+#include <cstddef>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ted_server {
+
+/// Configuration of the server.
+struct ServerOptions {
+  /// File with one tree in bracket notation per line.
+  std::string corpus_file;
+  /// Path of the Unix domain socket to listen on. If empty, requests are read
+  /// from stdin and answered on stdout.
+  std::string socket_path;
+  /// Number of worker threads. If not positive, the number of hardware
+  /// threads is used.
+  int threads = 0;
+  /// Time in milliseconds after its arrival within which a request is
+  /// answered, possibly with distance bounds. If not positive, distances are
+  /// always computed exactly.
+  int deadline_ms = 0;
+  /// Maximum number of requests of one connection that are read but not
+  /// answered yet. Reading a connection blocks while it has that many, such
+  /// that a client sending requests faster than it reads the responses is
+  /// throttled. If not positive, 1 is used.
+  int max_in_flight = 64;
+};
+
+/// Keeps the latencies of the most recent requests and computes percentiles.
+/// Thread-safe.
+class LatencyRecorder {
+public:
+  /// \param capacity Maximum number of recent samples kept.
+  LatencyRecorder(std::size_t capacity);
+  /// Records the latency of one request.
+  ///
+  /// \param milliseconds Latency in milliseconds.
+  void record(double milliseconds);
+  /// Returns the number of requests and the nearest-rank latency percentiles
+  /// over the recent samples as key=value pairs:
+  /// "requests=N p50_ms=... p90_ms=... p99_ms=... max_ms=...".
+  std::string summary() const;
+
+private:
+  const std::size_t capacity_;
+  mutable std::mutex mutex_;
+  std::vector<double> samples_;
+  long long count_ = 0;
+};
+
+/// Verifies that a string is a tree in bracket notation: a node is a quoted
+/// label between braces followed by its children, which are nodes again, and
+/// nothing follows the root node. Quotes and braces in labels are escaped
+/// with a backslash. The parser itself does not validate its input.
+///
+/// \param s The string.
+/// \return True if the string is a tree.
+bool is_bracket_notation(const std::string& s);
+
+/// Loads the corpus and serves the requests of one stream until it ends or
+/// a "quit" request arrives. Prints the latency summary to stderr.
+///
+/// \param options Server configuration. The socket path is ignored.
+/// \param in Stream of requests.
+/// \param out Stream of responses.
+/// \return 0 on success, -1 on error.
+int serve_stream(const ServerOptions& options, std::istream& in,
+                 std::ostream& out);
+
+/// Loads the corpus and serves requests until the input ends (stdin mode) or
+/// SIGINT or SIGTERM arrives (socket mode). On a signal, the server stops
+/// accepting connections, shuts down the open ones, and joins their threads.
+///
+/// \param options Server configuration.
+/// \return 0 on success, -1 on error.
+int run_server(const ServerOptions& options);
+
+} // namespace ted_server
+
+#endif // TREE_SIMILARITY_TED_SERVER_H
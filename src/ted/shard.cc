@@ -0,0 +1,432 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file ted/shard.cc
+///
+/// \details
+/// Implements the sharded all-pairs computation and the merge of its shard
+/// files (see shard.h).
+
+#include "shard.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "node.h"
+#include "string_label.h"
+#include "unit_cost_model.h"
+#include "weighted_cost_model.h"
+#include "zhang_shasha.h"
+#include "persistent_distance_cache.h"
+#include "bracket_notation_parser.h"
+#include "server.h"
+
+namespace ted_shard {
+
+namespace {
+
+using Label = label::StringLabel;
+using Tree = node::Node<Label>;
+using Fingerprint = zhang_shasha::PersistentDistanceCache;
+
+/// The first line of a shard file.
+struct ShardHeader {
+  int shard = -1;
+  int shards = 0;
+  long long trees = 0;
+  /// "matrix" or "join".
+  std::string mode;
+  /// The join threshold, "-" for a matrix.
+  std::string threshold;
+  /// 1 for symmetric costs, 2 if both distances of a pair are written.
+  int directions = 1;
+  TreePair begin = {0, 0};
+  TreePair end = {0, 0};
+  /// Fingerprints of the collection file and of the costs.
+  std::string collection;
+  std::string costs;
+};
+
+std::string to_string(const ShardHeader& h) {
+  std::ostringstream out;
+  out << "# ted shard=" << h.shard << "/" << h.shards
+      << " trees=" << h.trees
+      << " mode=" << h.mode
+      << " threshold=" << h.threshold
+      << " directions=" << h.directions
+      << " begin=" << h.begin.i << "," << h.begin.j
+      << " end=" << h.end.i << "," << h.end.j
+      << " collection=" << h.collection
+      << " costs=" << h.costs;
+  return out.str();
+}
+
+bool parse_header(const std::string& line, ShardHeader& h) {
+  std::istringstream in(line);
+  std::string token;
+  if (!(in >> token) || token != "#" || !(in >> token) || token != "ted") {
+    return false;
+  }
+  int fields = 0;
+  while (in >> token) {
+    const std::size_t kEquals = token.find('=');
+    if (kEquals == std::string::npos) {
+      return false;
+    }
+    const std::string kKey = token.substr(0, kEquals);
+    std::istringstream value(token.substr(kEquals + 1));
+    char separator = 0;
+    bool parsed = true;
+    if (kKey == "shard") {
+      parsed = (value >> h.shard >> separator >> h.shards) && separator == '/';
+    } else if (kKey == "trees") {
+      parsed = static_cast<bool>(value >> h.trees);
+    } else if (kKey == "mode") {
+      h.mode = value.str();
+    } else if (kKey == "threshold") {
+      h.threshold = value.str();
+    } else if (kKey == "directions") {
+      parsed = (value >> h.directions) &&
+               (h.directions == 1 || h.directions == 2);
+    } else if (kKey == "begin") {
+      parsed = (value >> h.begin.i >> separator >> h.begin.j) && separator == ',';
+    } else if (kKey == "end") {
+      parsed = (value >> h.end.i >> separator >> h.end.j) && separator == ',';
+    } else if (kKey == "collection") {
+      h.collection = value.str();
+    } else if (kKey == "costs") {
+      h.costs = value.str();
+    } else {
+      return false;
+    }
+    if (!parsed) {
+      return false;
+    }
+    ++fields;
+  }
+  return fields == 9;
+}
+
+std::string to_hex(std::uint64_t fingerprint) {
+  std::ostringstream out;
+  out << std::hex << std::setw(16) << std::setfill('0') << fingerprint;
+  return out.str();
+}
+
+/// Computes the pairs of a shard and writes the results and the footer. With
+/// two directions, the distance of (j, i) is computed as well and a pair is
+/// written if one of its distances is within the threshold.
+template <typename CostModel>
+bool compute_shard(const CostModel& c, const std::vector<Tree>& trees,
+                   const ShardHeader& header, double threshold,
+                   std::ostream& out, long long& results) {
+  const long long n = trees.size();
+  zhang_shasha::Algorithm<Label, CostModel> zs_ted(c);
+  long long evaluated = 0;
+  results = 0;
+  out << std::setprecision(std::numeric_limits<double>::max_digits10);
+  for (TreePair p = header.begin;
+       pair_position(p, n) < pair_position(header.end, n);) {
+    const double kDistance = zs_ted.zhang_shasha_ted(trees[p.i], trees[p.j]);
+    const double kReverse = header.directions == 1 ? kDistance :
+        zs_ted.zhang_shasha_ted(trees[p.j], trees[p.i]);
+    ++evaluated;
+    if (threshold < 0 || std::min(kDistance, kReverse) <= threshold) {
+      out << p.i << " " << p.j << " " << kDistance;
+      if (header.directions == 2) {
+        out << " " << kReverse;
+      }
+      out << "\n";
+      ++results;
+    }
+    if (++p.j == n) {
+      ++p.i;
+      p.j = p.i + 1;
+    }
+  }
+  out << "# end evaluated=" << evaluated << " results=" << results << "\n";
+  out.flush();
+  return static_cast<bool>(out);
+}
+
+/// Reads a shard file and verifies that its results lie in its pair range
+/// in ascending order and that its footer confirms all pairs.
+bool scan_shard(const std::string& file, ShardHeader& header,
+                long long& results) {
+  std::ifstream in(file);
+  std::string line;
+  if (!in.is_open() || !std::getline(in, line) || !parse_header(line, header)) {
+    std::cerr << "Not a shard file: " << file << std::endl;
+    return false;
+  }
+  const long long kBegin = pair_position(header.begin, header.trees);
+  const long long kEnd = pair_position(header.end, header.trees);
+  long long previous = kBegin - 1;
+  long long evaluated = -1;
+  long long footer_results = -1;
+  results = 0;
+  while (std::getline(in, line)) {
+    if (evaluated >= 0) {
+      std::cerr << "Data after the footer of shard file: " << file << std::endl;
+      return false;
+    }
+    std::istringstream fields(line);
+    if (line.compare(0, 6, "# end ") == 0) {
+      std::string evaluated_field;
+      std::string results_field;
+      fields.ignore(6);
+      fields >> evaluated_field >> results_field;
+      if (evaluated_field.compare(0, 10, "evaluated=") != 0 ||
+          results_field.compare(0, 8, "results=") != 0) {
+        break;
+      }
+      evaluated = std::atoll(evaluated_field.c_str() + 10);
+      footer_results = std::atoll(results_field.c_str() + 8);
+      continue;
+    }
+    TreePair p;
+    double distance;
+    std::string rest;
+    if (!(fields >> p.i >> p.j) || p.i < 0 || p.j <= p.i ||
+        p.j >= header.trees ||
+        (header.directions == 2 && !(fields >> distance)) ||
+        !(fields >> distance) || fields >> rest) {
+      std::cerr << "Malformed result '" << line << "' in shard file: " << file << std::endl;
+      return false;
+    }
+    const long long kPosition = pair_position(p, header.trees);
+    if (kPosition <= previous || kPosition >= kEnd) {
+      std::cerr << "Result out of order or range '" << line << "' in shard file: " << file << std::endl;
+      return false;
+    }
+    previous = kPosition;
+    ++results;
+  }
+  if (evaluated != kEnd - kBegin || footer_results != results) {
+    std::cerr << "Incomplete shard file: " << file << std::endl;
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+long long pair_position(const TreePair& p, long long n) {
+  return p.i * (2 * n - p.i - 1) / 2 + (p.j - p.i - 1);
+}
+
+TreePair first_pair(const std::vector<int>& sizes, double bound) {
+  const long long n = sizes.size();
+  std::vector<double> rest(n + 1, 0.0); // Sum of the sizes from i on.
+  for (long long i = n - 1; i >= 0; --i) {
+    rest[i] = rest[i + 1] + sizes[i];
+  }
+  double start = 0.0;
+  for (long long i = 0; i + 1 < n; ++i) {
+    const double kRowCost = sizes[i] * rest[i + 1];
+    if (start + kRowCost <= bound) {
+      start += kRowCost;
+      continue;
+    }
+    for (long long j = i + 1; j < n; ++j) {
+      if (start >= bound) {
+        return {i, j};
+      }
+      start += static_cast<double>(sizes[i]) * sizes[j];
+    }
+  }
+  return {n - 1, n};
+}
+
+int run_shard(const ShardOptions& options) {
+  if (options.shards < 1 || options.shard < 0 ||
+      options.shard >= options.shards || options.output_file.empty()) {
+    std::cerr << "Invalid shard " << options.shard << "/" << options.shards
+              << " or missing output file." << std::endl;
+    return -1;
+  }
+  std::ifstream collection_file(options.collection_file);
+  if (!collection_file.is_open()) {
+    std::cerr << "Error while opening file: " << options.collection_file << std::endl;
+    return -1;
+  }
+  std::ostringstream collection;
+  collection << collection_file.rdbuf();
+
+  std::vector<Tree> trees;
+  std::vector<int> sizes;
+  std::istringstream lines(collection.str());
+  for (std::string line; std::getline(lines, line);) {
+    if (!ted_server::is_bracket_notation(line)) {
+      std::cerr << "Malformed tree on line " << trees.size() + 1 << " of "
+                << options.collection_file << std::endl;
+      return -1;
+    }
+    parser::BracketNotationParser bnp;
+    trees.push_back(bnp.parse_string(line));
+    sizes.push_back(trees.back().get_tree_size());
+  }
+
+  std::string costs = "unit";
+  int directions = 1;
+  cost_model::WeightedCostModel<Label> weighted_costs;
+  if (!options.costs_file.empty()) {
+    if (!weighted_costs.read_from_file(options.costs_file)) {
+      std::cerr << "Error while reading costs: " << weighted_costs.get_error() << std::endl;
+      return -1;
+    }
+    std::ostringstream costs_contents;
+    costs_contents << std::ifstream(options.costs_file).rdbuf();
+    costs = costs_contents.str();
+    if (!weighted_costs.is_symmetric()) {
+      directions = 2;
+    }
+  }
+
+  // Cut the cost range of all pairs into equal parts.
+  const long long n = trees.size();
+  double total_cost = 0.0;
+  double rest = 0.0;
+  for (long long i = n - 1; i >= 0; --i) {
+    total_cost += sizes[i] * rest;
+    rest += sizes[i];
+  }
+  ShardHeader header;
+  header.shard = options.shard;
+  header.shards = options.shards;
+  header.trees = n;
+  header.mode = options.threshold < 0 ? "matrix" : "join";
+  std::ostringstream threshold;
+  threshold << std::setprecision(std::numeric_limits<double>::max_digits10)
+            << options.threshold;
+  header.threshold = options.threshold < 0 ? "-" : threshold.str();
+  header.directions = directions;
+  header.begin = first_pair(sizes, total_cost * options.shard / options.shards);
+  header.end = options.shard + 1 == options.shards ? TreePair{n - 1, n} :
+      first_pair(sizes, total_cost * (options.shard + 1) / options.shards);
+  header.collection = to_hex(Fingerprint::fingerprint(collection.str()));
+  header.costs = to_hex(Fingerprint::fingerprint(costs));
+
+  std::ofstream out(options.output_file);
+  out << to_string(header) << "\n";
+  long long results = 0;
+  const bool kWritten = options.costs_file.empty() ?
+      compute_shard(cost_model::UnitCostModel<Label>(), trees, header,
+                    options.threshold, out, results) :
+      compute_shard(weighted_costs, trees, header, options.threshold, out,
+                    results);
+  if (!kWritten) {
+    std::cerr << "Error while writing file: " << options.output_file << std::endl;
+    return -1;
+  }
+  std::cerr << "Shard " << options.shard << "/" << options.shards << ": "
+            << pair_position(header.end, n) - pair_position(header.begin, n)
+            << " pairs, " << results << " results." << std::endl;
+  return 0;
+}
+
+int run_merge(const std::vector<std::string>& shard_files,
+              const std::string& output_file) {
+  // Validate all files before writing anything.
+  std::vector<std::pair<ShardHeader, std::string>> shards;
+  long long results = 0;
+  for (const std::string& file : shard_files) {
+    ShardHeader header;
+    long long shard_results = 0;
+    if (!scan_shard(file, header, shard_results)) {
+      return -1;
+    }
+    shards.emplace_back(header, file);
+    results += shard_results;
+  }
+  if (shards.empty()) {
+    std::cerr << "No shard files." << std::endl;
+    return -1;
+  }
+  std::sort(shards.begin(), shards.end(),
+            [](const std::pair<ShardHeader, std::string>& a,
+               const std::pair<ShardHeader, std::string>& b) {
+              return a.first.shard < b.first.shard;
+            });
+  const ShardHeader& first = shards.front().first;
+  const long long n = first.trees;
+  for (std::size_t s = 0; s < shards.size(); ++s) {
+    const ShardHeader& h = shards[s].first;
+    if (h.shards != first.shards || h.trees != n || h.mode != first.mode ||
+        h.threshold != first.threshold || h.directions != first.directions ||
+        h.collection != first.collection ||
+        h.costs != first.costs) {
+      std::cerr << "Shard file of another computation: " << shards[s].second << std::endl;
+      return -1;
+    }
+    if (h.shard != static_cast<int>(s)) {
+      std::cerr << "Shard " << s << "/" << first.shards << " is missing or given twice." << std::endl;
+      return -1;
+    }
+    const long long kExpectedBegin =
+        s == 0 ? 0 : pair_position(shards[s - 1].first.end, n);
+    if (pair_position(h.begin, n) != kExpectedBegin) {
+      std::cerr << "Pair range of shard " << s << " does not follow shard " << s - 1 << "." << std::endl;
+      return -1;
+    }
+  }
+  if (static_cast<int>(shards.size()) != first.shards) {
+    std::cerr << "Expected " << first.shards << " shard files, got " << shards.size() << "." << std::endl;
+    return -1;
+  }
+  if (pair_position(shards.back().first.end, n) != n * (n - 1) / 2) {
+    std::cerr << "The shards do not cover all pairs." << std::endl;
+    return -1;
+  }
+
+  std::ofstream output;
+  if (!output_file.empty()) {
+    output.open(output_file);
+  }
+  std::ostream& out = output_file.empty() ? std::cout : output;
+  for (const auto& shard : shards) {
+    std::ifstream in(shard.second);
+    for (std::string line; std::getline(in, line);) {
+      if (line[0] != '#') {
+        out << line << "\n";
+      }
+    }
+  }
+  out.flush();
+  if (!out) {
+    std::cerr << "Error while writing the merged results." << std::endl;
+    return -1;
+  }
+  std::cerr << "Merged " << shards.size() << " shards: " << n * (n - 1) / 2
+            << " pairs, " << results << " results." << std::endl;
+  return 0;
+}
+
+} // namespace ted_shard
@@ -0,0 +1,118 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file ted/shard.h
+///
+/// \details
+/// Sharded all-pairs computation over a collection of trees. The pairs
+/// (i, j), i < j, of the collection are ordered row by row and cut into N
+/// contiguous ranges of about equal cost, where a pair costs |T_i| * |T_j|.
+/// The partitioning depends only on the tree sizes, so every shard can be
+/// computed by an independent process on any machine:
+///
+///   ted --collection FILE --shard S/N [--threshold TAU] [--costs COSTS_FILE]
+///       --output SHARD_FILE
+///
+/// A shard file starts with a header line describing the collection, the
+/// shard, and its pair range, followed by one line "i j d" per result and a
+/// footer line with the number of evaluated pairs. Without a threshold all
+/// pairs are written (the upper triangle of the distance matrix), otherwise
+/// only the pairs within the threshold (a similarity join).
+///
+/// If the costs are asymmetric (see WeightedCostModel::is_symmetric), the
+/// distance from T_j to T_i may differ from the one from T_i to T_j. Then
+/// both are computed and a result line reads "i j d(T_i, T_j) d(T_j, T_i)";
+/// a join writes a pair if one of its distances is within the threshold.
+///
+///   ted --merge [--output FILE] SHARD_FILE...
+///
+/// validates that the shard files belong to one computation, are complete,
+/// and cover all pairs exactly once, and writes their results in pair order.
+/// Merging streams the files and does not hold the results in memory.
+
+#ifndef TREE_SIMILARITY_TED_SHARD_H
+#define TREE_SIMILARITY_TED_SHARD_H
+
+#include <string>
+#include <vector>
+
+namespace ted_shard {
+
+/// Configuration of a shard computation.
+struct ShardOptions {
+  /// File with one tree in bracket notation per line.
+  std::string collection_file;
+  /// Number of this shard, 0-based.
+  int shard = 0;
+  /// Number of shards.
+  int shards = 1;
+  /// If not negative, only pairs with a distance of at most threshold are
+  /// written.
+  double threshold = -1.0;
+  /// File with weighted costs. If empty, unit costs are used.
+  std::string costs_file;
+  /// File the shard results are written to.
+  std::string output_file;
+};
+
+/// A pair of trees (i, j), i < j. For a collection of n trees, the pair
+/// (n - 1, n) follows the last pair.
+struct TreePair {
+  long long i;
+  long long j;
+};
+
+/// Returns the position of a pair in the row-by-row order of all pairs of a
+/// collection of n trees.
+///
+/// \param p The pair.
+/// \param n Number of trees.
+/// \return Position of p, n * (n - 1) / 2 for the pair after the last one.
+long long pair_position(const TreePair& p, long long n);
+
+/// Lays out the costs |T_i| * |T_j| of all pairs row by row from 0 and
+/// returns the first pair whose cost range starts at or after bound. Every
+/// process computes the same pair for the same sizes and bound, so adjacent
+/// shards agree on their common boundary.
+///
+/// \param sizes Sizes of the trees.
+/// \param bound Cost at which the range of pairs starts.
+/// \return The first pair of the range, or the pair after the last one.
+TreePair first_pair(const std::vector<int>& sizes, double bound);
+
+/// Computes the distances of one shard of the pairs of a collection.
+///
+/// \param options Shard configuration.
+/// \return 0 on success, -1 on error.
+int run_shard(const ShardOptions& options);
+
+/// Validates shard files and merges their results.
+///
+/// \param shard_files The shard files of all shards, in any order.
+/// \param output_file File the results are written to, stdout if empty.
+/// \return 0 on success, -1 on error.
+int run_merge(const std::vector<std::string>& shard_files,
+              const std::string& output_file);
+
+} // namespace ted_shard
+
+#endif // TREE_SIMILARITY_TED_SHARD_H
@@ -0,0 +1,136 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file ted/worker_pool.h
+///
+/// \details
+/// A fixed-size pool of worker threads. Every worker owns a workspace object
+/// (e.g., an instance of a TED algorithm with its matrices) that is reused by
+/// all tasks executed on that worker.
+
+#ifndef TREE_SIMILARITY_TED_WORKER_POOL_H
+#define TREE_SIMILARITY_TED_WORKER_POOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace ted_server {
+
+template <typename Workspace>
+class WorkerPool {
+// Types and type aliases
+public:
+  using Task = std::function<void(Workspace&)>;
+
+// Member functions
+public:
+  /// Starts the worker threads. Each worker default-constructs its workspace.
+  ///
+  /// \param workers Number of worker threads.
+  WorkerPool(int workers);
+  /// Finishes all submitted tasks and joins the worker threads.
+  ~WorkerPool();
+  /// Enqueues a task. The task is executed by the first idle worker.
+  /// Exceptions escaping the task are discarded, the task must handle them
+  /// to report errors.
+  ///
+  /// \param task The task to execute.
+  void submit(Task task);
+
+// Member functions
+private:
+  /// Main loop of a worker thread.
+  void work();
+
+// Member variables
+private:
+  /// Worker threads.
+  std::vector<std::thread> threads_;
+  /// Tasks waiting for execution.
+  std::queue<Task> tasks_;
+  /// Guards tasks_ and stopping_.
+  std::mutex mutex_;
+  /// Signals new tasks and stopping to the workers.
+  std::condition_variable condition_;
+  /// Set when the pool is being destroyed.
+  bool stopping_ = false;
+};
+
+template <typename Workspace>
+WorkerPool<Workspace>::WorkerPool(int workers) {
+  for (int i = 0; i < workers; ++i) {
+    threads_.emplace_back(&WorkerPool<Workspace>::work, this);
+  }
+}
+
+template <typename Workspace>
+WorkerPool<Workspace>::~WorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  condition_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+template <typename Workspace>
+void WorkerPool<Workspace>::submit(Task task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push(std::move(task));
+  }
+  condition_.notify_one();
+}
+
+template <typename Workspace>
+void WorkerPool<Workspace>::work() {
+  Workspace workspace;
+  while (true) {
+    Task task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      condition_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+      // Remaining tasks are executed before stopping.
+      if (tasks_.empty()) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop();
+    }
+    // A task reports its own errors. An exception escaping it must not
+    // terminate the process from this thread.
+    try {
+      task(workspace);
+    } catch (...) {
+    }
+  }
+}
+
+} // namespace ted_server
+
+#endif // TREE_SIMILARITY_TED_WORKER_POOL_H
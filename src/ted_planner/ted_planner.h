@@ -0,0 +1,224 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file ted_planner/ted_planner.h
+///
+/// \details
+/// Predicts the running time (number of subproblems) and the peak memory of
+/// the tree edit distance engines for a pair of trees before running any of
+/// them, and plans which engine to run within a memory budget.
+///
+/// The estimates are computed from the indexed trees in linear time: the
+/// sizes, the key-root subtrees of the left and right decompositions, the
+/// maximum fanouts, and the number of distinct labels. Matrix sizes are
+/// exact; the per-node bookkeeping of the engines is approximated.
+
+#ifndef TREE_SIMILARITY_TED_PLANNER_TED_PLANNER_H
+#define TREE_SIMILARITY_TED_PLANNER_TED_PLANNER_H
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "node.h"
+#include "tree_index.h"
+#include "label_dictionary.h"
+#include "matrix.h"
+#include "cost_model_traits.h"
+#include "zhang_shasha.h"
+#include "constrained_ted.h"
+#include "top_down_ted.h"
+
+namespace ted_planner {
+
+/// Engines a Planner chooses from.
+enum class Engine {
+  /// Zhang and Shasha, computes the tree edit distance.
+  kZhangShasha,
+  /// Constrained tree edit distance, an upper bound of the tree edit distance.
+  kConstrained,
+  /// Top-down distance, an upper bound of the constrained distance.
+  kTopDown,
+  /// No engine fits the memory budget.
+  kRejected
+};
+
+/// Returns the name of an engine.
+///
+/// \param engine The engine.
+/// \return Name in lower case with underscores.
+inline const char* engine_name(Engine engine) {
+  switch (engine) {
+    case Engine::kZhangShasha: return "zhang_shasha";
+    case Engine::kConstrained: return "constrained";
+    case Engine::kTopDown: return "top_down";
+    default: return "rejected";
+  }
+}
+
+/// Predicted cost of running one engine on a pair of trees.
+struct Estimate {
+  /// The engine.
+  Engine engine = Engine::kRejected;
+  /// True if both trees are mirrored (children in reverse order) before
+  /// running the engine. Mirroring preserves all distances, for Zhang and
+  /// Shasha it replaces the left paths by the right paths.
+  bool mirrored = false;
+  /// True if the engine computes the tree edit distance, false if it computes
+  /// an upper bound.
+  bool exact = false;
+  /// Number of subproblems (distances between subforests or between children
+  /// sequences) the engine computes.
+  long long subproblems = 0;
+  /// Peak number of bytes the engine allocates for this pair.
+  long long peak_bytes = 0;
+};
+
+/// Returns a copy of a tree with the children of every node in reverse order.
+///
+/// \param root Root of the tree.
+/// \return The mirrored tree.
+template <typename Label>
+node::Node<Label> mirror(const node::Node<Label>& root);
+
+/// \class Planner
+///
+/// \details
+/// Estimates the costs of all engines for a pair of trees and runs the
+/// cheapest one fitting a memory budget. The Zhang and Shasha algorithm is
+/// preferred in the orientation with fewer subproblems. Upper-bound engines
+/// are chosen only if allowed and no exact computation fits.
+///
+/// The workspaces of the engines are reused between pairs and keep the memory
+/// of the largest pair they ran. This retained memory counts against the
+/// budget: before running a plan, workspaces are released until the retained
+/// memory and the peak of the plan fit the budget.
+///
+/// \tparam Label Label type of the nodes.
+/// \tparam CostModel Cost model used by all engines.
+template <typename Label, typename CostModel>
+class Planner {
+// Member functions.
+public:
+  /// Constructor. Creates the cost model based on the template.
+  ///
+  /// \param memory_budget Maximum number of bytes an engine may allocate.
+  /// \param allow_upper_bounds Plan upper-bound engines if no exact
+  ///        computation fits the budget.
+  Planner(long long memory_budget, bool allow_upper_bounds = false);
+  /// Constructor. Uses a copy of a configured cost model.
+  ///
+  /// \param c The cost model.
+  /// \param memory_budget Maximum number of bytes an engine may allocate.
+  /// \param allow_upper_bounds Plan upper-bound engines if no exact
+  ///        computation fits the budget.
+  Planner(const CostModel& c, long long memory_budget,
+          bool allow_upper_bounds = false);
+  /// Estimates the costs of every engine and orientation for a pair of trees.
+  ///
+  /// \param t1 Source tree.
+  /// \param t2 Destination tree.
+  /// \return Estimates, exact engines first, upper-bound engines from the
+  ///         tightest bound.
+  std::vector<Estimate> estimate(const node::Node<Label>& t1,
+                                 const node::Node<Label>& t2);
+  /// Chooses the engine to run for a pair of trees: the exact estimate with
+  /// the fewest subproblems that fits the budget, otherwise, if allowed, the
+  /// tightest upper-bound engine that fits.
+  ///
+  /// \param t1 Source tree.
+  /// \param t2 Destination tree.
+  /// \return The chosen estimate. If nothing fits, its engine is kRejected
+  ///         and its costs are those of the cheapest exact estimate.
+  Estimate plan(const node::Node<Label>& t1, const node::Node<Label>& t2);
+  /// Runs the engine of a plan on a pair of trees.
+  ///
+  /// \param plan A plan returned by plan for these trees.
+  /// \param t1 Source tree.
+  /// \param t2 Destination tree.
+  /// \return The distance computed by the engine, or -1 if the plan is
+  ///         rejected.
+  double execute(const Estimate& plan, const node::Node<Label>& t1,
+                 const node::Node<Label>& t2);
+  /// Returns the number of bytes retained by the workspaces of the engines,
+  /// the sum of the largest peak each workspace ran since its creation.
+  long long retained_bytes() const;
+// Types and type aliases.
+private:
+  /// Type of the distances stored by the engines (see CostModelTraits).
+  using CostType = typename cost_model::CostModelTraits<CostModel>::CostType;
+  /// Properties of a tree the estimates depend on.
+  struct Profile {
+    /// Number of nodes.
+    long long size = 0;
+    /// Sum of the subtree sizes of the key roots of the left decomposition.
+    long long left_key_root_nodes = 0;
+    /// Sum of the subtree sizes of the key roots of the right decomposition.
+    long long right_key_root_nodes = 0;
+    /// Maximum number of children of a node.
+    long long max_fanout = 0;
+    /// Number of distinct labels.
+    long long labels = 0;
+  };
+// Member variables.
+private:
+  /// Maximum number of bytes an engine may allocate.
+  const long long memory_budget_;
+  /// True if upper-bound engines may be planned.
+  const bool allow_upper_bounds_;
+  /// Index used to profile the trees.
+  tree_index::TreeIndex<Label> index_;
+  /// Labels of the profiled tree.
+  label::LabelDictionary<Label> labels_;
+  /// Cost model the engines are created with.
+  const CostModel c_;
+  /// Zhang and Shasha workspace, created on first use.
+  std::unique_ptr<zhang_shasha::Algorithm<Label, CostModel>> zhang_shasha_;
+  /// Constrained tree edit distance workspace, created on first use.
+  std::unique_ptr<constrained_ted::Algorithm<Label, CostModel>> constrained_;
+  /// Top-down distance workspace, created on first use.
+  std::unique_ptr<top_down_ted::Algorithm<Label, CostModel>> top_down_;
+  /// Bytes retained by the workspace of each engine. Indexed by Engine.
+  long long retained_bytes_[3] = {0, 0, 0};
+// Member functions.
+private:
+  /// Indexes a tree and computes its profile.
+  ///
+  /// \param root Root of the tree.
+  /// \return The profile.
+  Profile profile(const node::Node<Label>& root);
+  /// Releases workspaces until the retained memory and the peak of a plan fit
+  /// the budget, the workspaces of other engines first.
+  ///
+  /// \param plan The plan to run next.
+  void make_room(const Estimate& plan);
+  /// Releases the workspace of an engine.
+  ///
+  /// \param engine The engine.
+  void release(Engine engine);
+};
+
+// Implementation details.
+#include "ted_planner_impl.h"
+
+}
+
+#endif // TREE_SIMILARITY_TED_PLANNER_TED_PLANNER_H
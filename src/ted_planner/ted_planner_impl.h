@@ -0,0 +1,249 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file ted_planner/ted_planner_impl.h
+///
+/// \details
+/// Contains the implementation of the engine planner.
+
+#ifndef TREE_SIMILARITY_TED_PLANNER_TED_PLANNER_IMPL_H
+#define TREE_SIMILARITY_TED_PLANNER_TED_PLANNER_IMPL_H
+
+template <typename Label>
+node::Node<Label> mirror(const node::Node<Label>& root) {
+  node::Node<Label> mirrored(root.label());
+  const auto& children = root.get_children();
+  for (auto it = children.rbegin(); it != children.rend(); ++it) {
+    mirrored.add_child(mirror(*it));
+  }
+  return mirrored;
+}
+
+template <typename Label, typename CostModel>
+Planner<Label, CostModel>::Planner(long long memory_budget,
+                                   bool allow_upper_bounds)
+    : memory_budget_(memory_budget), allow_upper_bounds_(allow_upper_bounds),
+      c_() {}
+
+template <typename Label, typename CostModel>
+Planner<Label, CostModel>::Planner(const CostModel& c, long long memory_budget,
+                                   bool allow_upper_bounds)
+    : memory_budget_(memory_budget), allow_upper_bounds_(allow_upper_bounds),
+      c_(c) {}
+
+template <typename Label, typename CostModel>
+typename Planner<Label, CostModel>::Profile
+Planner<Label, CostModel>::profile(const node::Node<Label>& root) {
+  index_.index(root);
+  labels_.clear();
+  Profile p;
+  p.size = index_.size();
+  // The root is a key root of both decompositions. Every other node is a key
+  // root of the left (right) decomposition unless it is the leftmost
+  // (rightmost) child of its parent.
+  p.left_key_root_nodes = p.right_key_root_nodes = p.size;
+  for (int i = 1; i <= index_.size(); ++i) {
+    labels_.insert(index_.node(i).label());
+    const int kChildren = index_.children_count(i);
+    p.max_fanout = std::max<long long>(p.max_fanout, kChildren);
+    for (int k = 0; k < kChildren; ++k) {
+      const int kChild = index_.child(i, k);
+      const long long kChildSize = kChild - index_.lld(kChild) + 1;
+      if (k > 0) {
+        p.left_key_root_nodes += kChildSize;
+      }
+      if (k < kChildren - 1) {
+        p.right_key_root_nodes += kChildSize;
+      }
+    }
+  }
+  p.labels = labels_.size();
+  return p;
+}
+
+template <typename Label, typename CostModel>
+std::vector<Estimate> Planner<Label, CostModel>::estimate(
+    const node::Node<Label>& t1, const node::Node<Label>& t2) {
+  const Profile kP1 = profile(t1);
+  const Profile kP2 = profile(t2);
+  const long long kCell = sizeof(CostType);
+  const long long kCells = (kP1.size + 1) * (kP2.size + 1);
+  // The td and fd matrices of Zhang and Shasha pad their rows.
+  const long long kPaddedCells = (kP1.size + 1) *
+      static_cast<long long>(data_structures::AlignedMatrixPolicy::row_stride<
+          CostType>(kP2.size + 1));
+  const long long kNodes = kP1.size + kP2.size;
+  // Approximate bytes per node of the indexes, costs, and subtree ids kept by
+  // Zhang and Shasha, and of a TreeIndex with subtree costs.
+  const long long kZhangShashaNodeBytes = 96 + kCell;
+  const long long kTreeIndexNodeBytes = 24 + 2 * kCell;
+  // Fanout-sized matrix of the children-sequence alignments.
+  const long long kSequenceBytes =
+      (kP1.max_fanout + 1) * (kP2.max_fanout + 1) * kCell;
+  // Rename costs between the distinct source labels and all distinct labels
+  // of both trees, only for label-based costs. The union of the label sets
+  // is bounded by the sum of their sizes.
+  const bool kLabelBased = cost_model::CostModelTraits<CostModel>::kLabelBased &&
+      !cost_model::CostModelTraits<CostModel>::kConstantCosts;
+  const long long kRenameBytes =
+      kLabelBased ? kP1.labels * (kP1.labels + kP2.labels) * kCell : 0;
+
+  std::vector<Estimate> estimates;
+  Estimate e;
+  // Zhang and Shasha computes one subforest distance for every pair of nodes
+  // in the subtrees of every pair of key roots.
+  e.engine = Engine::kZhangShasha;
+  e.exact = true;
+  e.mirrored = false;
+  e.subproblems = kP1.left_key_root_nodes * kP2.left_key_root_nodes;
+  e.peak_bytes = 2 * kPaddedCells * kCell + kRenameBytes +
+                 kNodes * kZhangShashaNodeBytes;
+  estimates.push_back(e);
+  // Mirrored copies of both trees are allocated in addition.
+  e.mirrored = true;
+  e.subproblems = kP1.right_key_root_nodes * kP2.right_key_root_nodes;
+  e.peak_bytes += kNodes * static_cast<long long>(sizeof(node::Node<Label>));
+  estimates.push_back(e);
+
+  // The other engines compute one distance for every pair of nodes and align
+  // the children of every pair of nodes. Each node except the root is a
+  // child.
+  e.exact = false;
+  e.mirrored = false;
+  e.subproblems = kP1.size * kP2.size + (kP1.size - 1) * (kP2.size - 1);
+  e.engine = Engine::kConstrained;
+  e.peak_bytes = 2 * kCells * kCell + kSequenceBytes +
+                 kNodes * (kTreeIndexNodeBytes + 2 * kCell);
+  estimates.push_back(e);
+  e.engine = Engine::kTopDown;
+  e.peak_bytes = kCells * kCell + kSequenceBytes +
+                 kNodes * (kTreeIndexNodeBytes + 2 * kCell);
+  estimates.push_back(e);
+  return estimates;
+}
+
+template <typename Label, typename CostModel>
+Estimate Planner<Label, CostModel>::plan(const node::Node<Label>& t1,
+                                         const node::Node<Label>& t2) {
+  const std::vector<Estimate> kEstimates = estimate(t1, t2);
+  const Estimate* exact = nullptr;
+  const Estimate* cheapest_exact = nullptr;
+  const Estimate* bound = nullptr;
+  for (const Estimate& e : kEstimates) {
+    if (e.exact) {
+      if (!cheapest_exact || e.subproblems < cheapest_exact->subproblems) {
+        cheapest_exact = &e;
+      }
+      if (e.peak_bytes <= memory_budget_ &&
+          (!exact || e.subproblems < exact->subproblems)) {
+        exact = &e;
+      }
+    } else if (!bound && allow_upper_bounds_ &&
+               e.peak_bytes <= memory_budget_) {
+      bound = &e;
+    }
+  }
+  if (exact) {
+    return *exact;
+  }
+  if (bound) {
+    return *bound;
+  }
+  Estimate rejected = *cheapest_exact;
+  rejected.engine = Engine::kRejected;
+  return rejected;
+}
+
+template <typename Label, typename CostModel>
+double Planner<Label, CostModel>::execute(const Estimate& plan,
+                                          const node::Node<Label>& t1,
+                                          const node::Node<Label>& t2) {
+  if (plan.engine == Engine::kRejected) {
+    return -1;
+  }
+  if (plan.mirrored) {
+    const node::Node<Label> kMirrored1 = mirror(t1);
+    const node::Node<Label> kMirrored2 = mirror(t2);
+    Estimate unmirrored = plan;
+    unmirrored.mirrored = false;
+    return execute(unmirrored, kMirrored1, kMirrored2);
+  }
+  make_room(plan);
+  switch (plan.engine) {
+    case Engine::kZhangShasha:
+      if (!zhang_shasha_) {
+        zhang_shasha_.reset(new zhang_shasha::Algorithm<Label, CostModel>(c_));
+      }
+      return zhang_shasha_->zhang_shasha_ted(t1, t2);
+    case Engine::kConstrained:
+      if (!constrained_) {
+        constrained_.reset(new constrained_ted::Algorithm<Label, CostModel>(c_));
+      }
+      return constrained_->constrained_ted(t1, t2);
+    default:
+      if (!top_down_) {
+        top_down_.reset(new top_down_ted::Algorithm<Label, CostModel>(c_));
+      }
+      return top_down_->top_down_ted(t1, t2);
+  }
+}
+
+template <typename Label, typename CostModel>
+long long Planner<Label, CostModel>::retained_bytes() const {
+  return retained_bytes_[0] + retained_bytes_[1] + retained_bytes_[2];
+}
+
+template <typename Label, typename CostModel>
+void Planner<Label, CostModel>::make_room(const Estimate& plan) {
+  for (Engine other : {Engine::kZhangShasha, Engine::kConstrained,
+                       Engine::kTopDown}) {
+    if (other != plan.engine &&
+        retained_bytes() + plan.peak_bytes > memory_budget_) {
+      release(other);
+    }
+  }
+  // The workspace of the plan grows to at most the sum of its retained memory
+  // and the peak of the plan.
+  long long& retained = retained_bytes_[static_cast<int>(plan.engine)];
+  if (retained_bytes() + plan.peak_bytes > memory_budget_) {
+    release(plan.engine);
+  }
+  retained = std::max(retained, plan.peak_bytes);
+}
+
+template <typename Label, typename CostModel>
+void Planner<Label, CostModel>::release(Engine engine) {
+  switch (engine) {
+    case Engine::kZhangShasha:
+      zhang_shasha_.reset();
+      break;
+    case Engine::kConstrained:
+      constrained_.reset();
+      break;
+    default:
+      top_down_.reset();
+      break;
+  }
+  retained_bytes_[static_cast<int>(engine)] = 0;
+}
+
+#endif // TREE_SIMILARITY_TED_PLANNER_TED_PLANNER_IMPL_H
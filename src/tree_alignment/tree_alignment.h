@@ -0,0 +1,144 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+/// \file tree_alignment/tree_alignment.h
+///
+/// \details
+/// Implements the tree alignment distance by Jiang, Wang, and Zhang. T.Jiang,
+/// L.Wang, K.Zhang. Alignment of trees - an alternative to tree edit.
+/// Theoretical Computer Science 1995.
+///
+/// An alignment inserts nodes into both trees such that they become
+/// isomorphic, which corresponds to an edit script where all insertions
+/// precede all deletions. The alignment distance is thus an upper bound of
+/// the tree edit distance and a lower bound of the top-down distance. It is
+/// computed in O(|T1||T2|(deg(T1)+deg(T2))^2) time. As in the paper, the
+/// cost model must satisfy ren(a, b) <= del(a) + ins(b).
+
+#ifndef TREE_SIMILARITY_TREE_ALIGNMENT_TREE_ALIGNMENT_H
+#define TREE_SIMILARITY_TREE_ALIGNMENT_TREE_ALIGNMENT_H
+
+#include <algorithm>
+#include <vector>
+#include "node.h"
+#include "matrix.h"
+#include "tree_index.h"
+#include "cost_model_traits.h"
+
+namespace tree_alignment {
+
+template <typename Label, typename CostModel>
+class Algorithm {
+// Member functions.
+public:
+  /// Constructor. Creates the cost model based on the template.
+  Algorithm();
+  /// Constructor. Uses a copy of a configured cost model.
+  ///
+  /// \param c The cost model.
+  Algorithm(const CostModel& c);
+  /// Computes the alignment distance between two trees.
+  ///
+  /// \param t1 Source tree.
+  /// \param t2 Destination tree.
+  /// \return Tree alignment distance value.
+  double tree_alignment_distance(const node::Node<Label>& t1,
+                                 const node::Node<Label>& t2);
+  /// Computes the alignment distance between the trees rooted at two DAG nodes.
+  /// The trees are indexed directly from the DAGs without materializing them as
+  /// nodes.
+  ///
+  /// \param dag1 DAG holding the source tree.
+  /// \param root1 Id of the source tree root in dag1.
+  /// \param dag2 DAG holding the destination tree.
+  /// \param root2 Id of the destination tree root in dag2.
+  /// \return Tree alignment distance value.
+  double tree_alignment_distance(const tree_index::TreeDag<Label>& dag1,
+                                 int root1,
+                                 const tree_index::TreeDag<Label>& dag2,
+                                 int root2);
+// Types and type aliases.
+private:
+  /// Type of the stored distances (see CostModelTraits).
+  using CostType = typename cost_model::CostModelTraits<CostModel>::CostType;
+// Member variables.
+private:
+  /// Index of the source tree.
+  tree_index::TreeIndex<Label> t1_;
+  /// Index of the destination tree.
+  tree_index::TreeIndex<Label> t2_;
+  /// Cost of deleting each source node. Indexed in postorder-1.
+  std::vector<CostType> t1_del_;
+  /// Cost of inserting each destination node. Indexed in postorder-1.
+  std::vector<CostType> t2_ins_;
+  /// Cost of deleting the subtree rooted at each source node. Indexed in
+  /// postorder-1.
+  std::vector<CostType> t1_del_tree_;
+  /// Cost of inserting the subtree rooted at each destination node. Indexed in
+  /// postorder-1.
+  std::vector<CostType> t2_ins_tree_;
+  /// Alignment distances between subtrees.
+  data_structures::Matrix<CostType> dt_;
+  /// Position of the block of each destination node in the vectors of
+  /// t1_forest_to_subforests_. The block of node j has m*m entries, where m
+  /// is the number of children of j. Indexed in postorder-1.
+  std::vector<int> t2_block_start_;
+  /// For each source node i, the distances A(F1[i], F2[j][k..t]) between its
+  /// children forest and every consecutive subsequence k..t of the children
+  /// of every destination node j, at t2_block_start_[j-1] + (k-1)*m + t-1.
+  /// Kept until the parent of i is processed. Indexed in postorder-1.
+  std::vector<std::vector<CostType>> t1_forest_to_subforests_;
+  /// For each destination node j and the current source node i, the
+  /// distances A(F1[i][r..s], F2[j]) between every consecutive subsequence
+  /// r..s of the children of i and the children forest of j, at (r-1)*m + s-1
+  /// where m is the number of children of i. Kept until the parent of j is
+  /// processed. Indexed in postorder-1.
+  std::vector<std::vector<CostType>> t2_forest_to_subforests_;
+  /// Distances between prefixes of children sequences (see align_children).
+  data_structures::Matrix<CostType> d_;
+  /// Cost model.
+  const CostModel c_;
+// Member functions.
+private:
+  /// Computes the alignment distance between the indexed trees t1_ and t2_.
+  ///
+  /// \return Tree alignment distance value.
+  double compute_distance();
+  /// Aligns the children of i starting at s_begin with the children of j
+  /// starting at t_begin. Afterwards, d_.at(s - s_begin + 1, t - t_begin + 1)
+  /// holds the distance A(F1[i][s_begin..s], F2[j][t_begin..t]) for all
+  /// s_begin-1 <= s <= deg(i) and t_begin-1 <= t <= deg(j).
+  ///
+  /// \param i Postorder id of the source node.
+  /// \param j Postorder id of the destination node.
+  /// \param s_begin Position of the first child of i, starting with 1.
+  /// \param t_begin Position of the first child of j, starting with 1.
+  void align_children(int i, int j, int s_begin, int t_begin);
+};
+
+// Implementation details.
+#include "tree_alignment_impl.h"
+
+}
+
+#endif // TREE_SIMILARITY_TREE_ALIGNMENT_TREE_ALIGNMENT_H
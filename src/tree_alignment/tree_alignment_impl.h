@@ -0,0 +1,202 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+/// \file tree_alignment/tree_alignment_impl.h
+///
+/// \details
+/// Contains the implementation of the tree alignment distance.
+
+#ifndef TREE_SIMILARITY_TREE_ALIGNMENT_TREE_ALIGNMENT_IMPL_H
+#define TREE_SIMILARITY_TREE_ALIGNMENT_TREE_ALIGNMENT_IMPL_H
+
+template <typename Label, typename CostModel>
+Algorithm<Label, CostModel>::Algorithm() : c_() {}
+
+template <typename Label, typename CostModel>
+Algorithm<Label, CostModel>::Algorithm(const CostModel& c) : c_(c) {}
+
+template <typename Label, typename CostModel>
+double Algorithm<Label, CostModel>::tree_alignment_distance(
+    const node::Node<Label>& t1, const node::Node<Label>& t2) {
+  t1_.index(t1);
+  t2_.index(t2);
+  return compute_distance();
+}
+
+template <typename Label, typename CostModel>
+double Algorithm<Label, CostModel>::tree_alignment_distance(
+    const tree_index::TreeDag<Label>& dag1, int root1,
+    const tree_index::TreeDag<Label>& dag2, int root2) {
+  t1_.index(dag1, root1);
+  t2_.index(dag2, root2);
+  return compute_distance();
+}
+
+template <typename Label, typename CostModel>
+double Algorithm<Label, CostModel>::compute_distance() {
+  const int kT1Size = t1_.size();
+  const int kT2Size = t2_.size();
+  std::vector<CostType> forest;
+  tree_index::subtree_costs(
+      t1_, [this](const node::Node<Label>& n) { return c_.del(n); },
+      t1_del_tree_, forest);
+  tree_index::subtree_costs(
+      t2_, [this](const node::Node<Label>& n) { return c_.ins(n); },
+      t2_ins_tree_, forest);
+  t1_del_.resize(kT1Size);
+  for (int i = 1; i <= kT1Size; ++i) {
+    t1_del_[i - 1] = c_.del(t1_.node(i));
+  }
+  t2_ins_.resize(kT2Size);
+  t2_block_start_.resize(kT2Size);
+  int blocks_size = 0;
+  for (int j = 1; j <= kT2Size; ++j) {
+    t2_ins_[j - 1] = c_.ins(t2_.node(j));
+    t2_block_start_[j - 1] = blocks_size;
+    blocks_size += t2_.children_count(j) * t2_.children_count(j);
+  }
+  dt_.resize(kT1Size+1, kT2Size+1);
+  t1_forest_to_subforests_.assign(kT1Size, std::vector<CostType>());
+  t2_forest_to_subforests_.assign(kT2Size, std::vector<CostType>());
+
+  // Both loops in postorder, thus the distances of all pairs of children are
+  // known.
+  for (int i = 1; i <= kT1Size; ++i) {
+    const int kIChildren = t1_.children_count(i);
+    std::vector<CostType>& x = t1_forest_to_subforests_[i - 1];
+    x.resize(blocks_size);
+    for (int j = 1; j <= kT2Size; ++j) {
+      const int kJChildren = t2_.children_count(j);
+      const int kBlock = t2_block_start_[j - 1];
+      std::vector<CostType>& y = t2_forest_to_subforests_[j - 1];
+      y.resize(kIChildren * kIChildren);
+
+      // Forest of i to every subforest of the children of j.
+      for (int k = 1; k <= kJChildren; ++k) {
+        align_children(i, j, 1, k);
+        for (int t = k; t <= kJChildren; ++t) {
+          x[kBlock + (k - 1) * kJChildren + t - 1] =
+              d_.at(kIChildren, t - k + 1);
+        }
+      }
+      // Every subforest of the children of i to the forest of j.
+      for (int r = 1; r <= kIChildren; ++r) {
+        align_children(i, j, r, 1);
+        for (int s = r; s <= kIChildren; ++s) {
+          y[(r - 1) * kIChildren + s - 1] = d_.at(s - r + 1, kJChildren);
+        }
+      }
+      CostType forests = 0;
+      if (kJChildren > 0) {
+        forests = x[kBlock + kJChildren - 1];
+      } else if (kIChildren > 0) {
+        forests = y[kIChildren - 1];
+      }
+
+      // Distance between the subtrees:
+      // (1) i is aligned with j, their forests are aligned,
+      // (2) j is inserted, the subtree of i is aligned with a child of j,
+      // (3) i is deleted, a child of i is aligned with the subtree of j.
+      CostType tree = forests + c_.ren(t1_.node(i), t2_.node(j));
+      for (int t = 0; t < kJChildren; ++t) {
+        const int kJt = t2_.child(j, t);
+        tree = std::min(tree, t2_ins_tree_[j - 1] + dt_.at(i, kJt) -
+                                  t2_ins_tree_[kJt - 1]);
+      }
+      for (int s = 0; s < kIChildren; ++s) {
+        const int kIs = t1_.child(i, s);
+        tree = std::min(tree, t1_del_tree_[i - 1] + dt_.at(kIs, j) -
+                                  t1_del_tree_[kIs - 1]);
+      }
+      dt_.at(i, j) = tree;
+
+      for (int t = 0; t < kJChildren; ++t) {
+        std::vector<CostType>().swap(
+            t2_forest_to_subforests_[t2_.child(j, t) - 1]);
+      }
+    }
+    for (int s = 0; s < kIChildren; ++s) {
+      std::vector<CostType>().swap(
+          t1_forest_to_subforests_[t1_.child(i, s) - 1]);
+    }
+  }
+
+  return dt_.at(kT1Size, kT2Size);
+}
+
+template <typename Label, typename CostModel>
+void Algorithm<Label, CostModel>::align_children(int i, int j, int s_begin,
+                                                 int t_begin) {
+  const int kIChildren = t1_.children_count(i);
+  const int kJChildren = t2_.children_count(j);
+  const int kRows = kIChildren - s_begin + 2;
+  const int kColumns = kJChildren - t_begin + 2;
+  if (d_.get_rows() < static_cast<std::size_t>(kRows) ||
+      d_.get_columns() < static_cast<std::size_t>(kColumns)) {
+    d_.resize(std::max<std::size_t>(d_.get_rows(), kRows),
+              std::max<std::size_t>(d_.get_columns(), kColumns));
+  }
+  // Row a and column b of d_ hold the subforests ending with the children
+  // s_begin+a-1 of i and t_begin+b-1 of j.
+  d_.at(0, 0) = 0;
+  for (int a = 1; a < kRows; ++a) {
+    const int kIs = t1_.child(i, s_begin + a - 2);
+    d_.at(a, 0) = d_.at(a - 1, 0) + t1_del_tree_[kIs - 1];
+  }
+  for (int b = 1; b < kColumns; ++b) {
+    const int kJt = t2_.child(j, t_begin + b - 2);
+    d_.at(0, b) = d_.at(0, b - 1) + t2_ins_tree_[kJt - 1];
+  }
+  for (int a = 1; a < kRows; ++a) {
+    const int kS = s_begin + a - 1;
+    const int kIs = t1_.child(i, kS - 1);
+    // A(F1[is], F2[j][k..t]) is in the block of j.
+    const std::vector<CostType>& x = t1_forest_to_subforests_[kIs - 1];
+    const int kBlock = t2_block_start_[j - 1];
+    for (int b = 1; b < kColumns; ++b) {
+      const int kT = t_begin + b - 1;
+      const int kJt = t2_.child(j, kT - 1);
+      // A(F1[i][r..s], F2[jt]) of the current source node.
+      const std::vector<CostType>& y = t2_forest_to_subforests_[kJt - 1];
+      CostType d = std::min({
+          d_.at(a - 1, b) + t1_del_tree_[kIs - 1],
+          d_.at(a, b - 1) + t2_ins_tree_[kJt - 1],
+          d_.at(a - 1, b - 1) + dt_.at(kIs, kJt)});
+      // is is deleted, its children are aligned with the children k..t of j.
+      for (int c = 1; c <= b; ++c) {
+        const int kK = t_begin + c - 1;
+        d = std::min(d, d_.at(a - 1, c - 1) + t1_del_[kIs - 1] +
+                        x[kBlock + (kK - 1) * kJChildren + kT - 1]);
+      }
+      // jt is inserted, its children are aligned with the children r..s of i.
+      for (int c = 1; c <= a; ++c) {
+        const int kR = s_begin + c - 1;
+        d = std::min(d, d_.at(c - 1, b - 1) + t2_ins_[kJt - 1] +
+                        y[(kR - 1) * kIChildren + kS - 1]);
+      }
+      d_.at(a, b) = d;
+    }
+  }
+}
+
+#endif // TREE_SIMILARITY_TREE_ALIGNMENT_TREE_ALIGNMENT_IMPL_H
@@ -0,0 +1,152 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file tree_index/tree_dag.h
+///
+/// \details
+/// Contains the declaration of the TreeDag class. It stores trees as a
+/// directed acyclic graph in which identical subtrees are shared, which
+/// compresses highly repetitive trees such as machine-generated documents.
+
+#ifndef TREE_SIMILARITY_TREE_INDEX_TREE_DAG_H
+#define TREE_SIMILARITY_TREE_INDEX_TREE_DAG_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include "node.h"
+#include "hash.h"
+
+namespace tree_index {
+
+/// \class TreeDag
+///
+/// \details
+/// Minimal DAG of one or more trees built by hash-consing: every distinct
+/// subtree (label and sequence of child subtrees) is stored once, also
+/// across the added trees. DAG nodes are identified by ids starting with 0,
+/// children precede their parents. The size, height, and structural hash of
+/// a subtree are computed once per DAG node.
+///
+/// The DAG copies the labels, the added trees need not outlive it. A
+/// TreeIndex can be built directly from a DAG node, so the TreeIndex-based
+/// algorithms (Zhang and Shasha, constrained, top-down, and alignment) run
+/// on DAG-compressed trees without expanding them to node::Node trees. The
+/// DAG saves the memory of the stored trees; an index of a tree still has
+/// one entry per tree node, as the dynamic programs of the algorithms have.
+///
+/// \tparam Label Label type of the nodes. A specialization of std::hash must
+///         be provided.
+template <class Label>
+class TreeDag {
+// Member struct.
+public:
+  /// Counters describing the compression.
+  struct Statistics {
+    /// Number of nodes of all added trees.
+    long long tree_nodes = 0;
+    /// Number of DAG nodes, i.e., of distinct subtrees.
+    long long dag_nodes = 0;
+    /// Number of DAG edges, i.e., of stored child references.
+    long long dag_edges = 0;
+  };
+// Member functions.
+public:
+  /// Adds a tree, sharing its subtrees with the trees added before.
+  ///
+  /// \param root Root of the tree.
+  /// \return Id of the DAG node of the root.
+  int add(const node::Node<Label>& root);
+  /// Returns the number of DAG nodes.
+  int size() const;
+  /// Returns a node holding the label of a DAG node. The node has no
+  /// children, it serves as the argument of cost model functions.
+  ///
+  /// \param id Id of the DAG node.
+  /// \return The label node.
+  const node::Node<Label>& node(int id) const;
+  /// Returns the number of children of a DAG node.
+  ///
+  /// \param id Id of the DAG node.
+  int children_count(int id) const;
+  /// Returns a child of a DAG node.
+  ///
+  /// \param id Id of the DAG node.
+  /// \param k Position of the child, 0 is the leftmost child.
+  /// \return Id of the child.
+  int child(int id, int k) const;
+  /// Returns the number of nodes of the subtree of a DAG node.
+  ///
+  /// \param id Id of the DAG node.
+  int tree_size(int id) const;
+  /// Returns the height of the subtree of a DAG node, 1 for a leaf.
+  ///
+  /// \param id Id of the DAG node.
+  int height(int id) const;
+  /// Returns the structural hash of the subtree of a DAG node.
+  ///
+  /// \param id Id of the DAG node.
+  std::uint64_t hash(int id) const;
+  /// Expands the subtree of a DAG node to a tree, e.g., to print it. The
+  /// algorithms do not need the expanded tree.
+  ///
+  /// \param id Id of the DAG node.
+  /// \return The tree.
+  node::Node<Label> to_tree(int id) const;
+  /// Returns the counters of the DAG.
+  Statistics get_statistics() const;
+// Member variables.
+private:
+  /// Label nodes. Indexed by DAG node id.
+  std::vector<node::Node<Label>> nodes_;
+  /// Position of the first child of each DAG node in children_, followed by
+  /// the total number of children.
+  std::vector<int> children_start_ = std::vector<int>(1, 0);
+  /// Ids of the children of all DAG nodes.
+  std::vector<int> children_;
+  /// Subtree sizes, heights, and hashes. Indexed by DAG node id.
+  std::vector<int> tree_size_;
+  std::vector<int> height_;
+  std::vector<std::uint64_t> hash_;
+  /// The first DAG node of each hash, and for each DAG node the next one
+  /// with the same hash or -1. More than one only on hash collisions.
+  std::unordered_map<std::uint64_t, int> first_with_hash_;
+  std::vector<int> next_with_hash_;
+  /// Number of nodes of all added trees.
+  long long tree_nodes_ = 0;
+// Member functions.
+private:
+  /// Adds a subtree bottom-up.
+  ///
+  /// \param root Root of the subtree.
+  /// \return Id of the DAG node of root.
+  int add_recursion(const node::Node<Label>& root);
+};
+
+// Implementation details.
+#include "tree_dag_impl.h"
+
+}
+
+#endif // TREE_SIMILARITY_TREE_INDEX_TREE_DAG_H
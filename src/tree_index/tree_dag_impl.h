@@ -0,0 +1,143 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file tree_index/tree_dag_impl.h
+///
+/// \details
+/// Contains the implementation of the TreeDag class.
+
+#ifndef TREE_SIMILARITY_TREE_INDEX_TREE_DAG_IMPL_H
+#define TREE_SIMILARITY_TREE_INDEX_TREE_DAG_IMPL_H
+
+template <class Label>
+int TreeDag<Label>::add(const node::Node<Label>& root) {
+  return add_recursion(root);
+}
+
+template <class Label>
+int TreeDag<Label>::add_recursion(const node::Node<Label>& root) {
+  std::vector<int> root_children;
+  root_children.reserve(root.get_children().size());
+  for (const auto& child : root.get_children()) {
+    root_children.push_back(add_recursion(child));
+  }
+  ++tree_nodes_;
+
+  // Merkle-style hash of the label and the children's hashes.
+  std::uint64_t h = data_structures::mix_hash(
+      std::hash<Label>()(root.label()) + root_children.size());
+  for (int c : root_children) {
+    h = data_structures::mix_hash(h + hash_[c]);
+  }
+
+  // Reuse an equal DAG node. Children are shared already, so comparing
+  // their ids suffices.
+  auto found = first_with_hash_.find(h);
+  if (found != first_with_hash_.end()) {
+    for (int id = found->second; id != -1; id = next_with_hash_[id]) {
+      if (children_count(id) == static_cast<int>(root_children.size()) &&
+          std::equal(root_children.begin(), root_children.end(),
+                     children_.begin() + children_start_[id]) &&
+          nodes_[id].label() == root.label()) {
+        return id;
+      }
+    }
+  }
+
+  const int kId = nodes_.size();
+  int size = 1;
+  int height = 0;
+  for (int c : root_children) {
+    size += tree_size_[c];
+    height = std::max(height, height_[c]);
+  }
+  nodes_.push_back(node::Node<Label>(root.label()));
+  children_.insert(children_.end(), root_children.begin(),
+                   root_children.end());
+  children_start_.push_back(children_.size());
+  tree_size_.push_back(size);
+  height_.push_back(height + 1);
+  hash_.push_back(h);
+  if (found != first_with_hash_.end()) {
+    next_with_hash_.push_back(found->second);
+    found->second = kId;
+  } else {
+    next_with_hash_.push_back(-1);
+    first_with_hash_.emplace(h, kId);
+  }
+  return kId;
+}
+
+template <class Label>
+int TreeDag<Label>::size() const {
+  return nodes_.size();
+}
+
+template <class Label>
+const node::Node<Label>& TreeDag<Label>::node(int id) const {
+  return nodes_[id];
+}
+
+template <class Label>
+int TreeDag<Label>::children_count(int id) const {
+  return children_start_[id + 1] - children_start_[id];
+}
+
+template <class Label>
+int TreeDag<Label>::child(int id, int k) const {
+  return children_[children_start_[id] + k];
+}
+
+template <class Label>
+int TreeDag<Label>::tree_size(int id) const {
+  return tree_size_[id];
+}
+
+template <class Label>
+int TreeDag<Label>::height(int id) const {
+  return height_[id];
+}
+
+template <class Label>
+std::uint64_t TreeDag<Label>::hash(int id) const {
+  return hash_[id];
+}
+
+template <class Label>
+node::Node<Label> TreeDag<Label>::to_tree(int id) const {
+  node::Node<Label> root(nodes_[id].label());
+  for (int k = 0; k < children_count(id); ++k) {
+    root.add_child(to_tree(child(id, k)));
+  }
+  return root;
+}
+
+template <class Label>
+typename TreeDag<Label>::Statistics TreeDag<Label>::get_statistics() const {
+  Statistics stats;
+  stats.tree_nodes = tree_nodes_;
+  stats.dag_nodes = nodes_.size();
+  stats.dag_edges = children_.size();
+  return stats;
+}
+
+#endif // TREE_SIMILARITY_TREE_INDEX_TREE_DAG_IMPL_H
@@ -0,0 +1,160 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+/// \file tree_index/tree_index.h
+///
+/// \details
+/// Contains the declaration of the TreeIndex class. It stores the nodes of a
+/// tree in postorder with their children and leftmost leaf descendants, such
+/// that the TED algorithms can traverse a tree by integer ids.
+
+#ifndef TREE_SIMILARITY_TREE_INDEX_TREE_INDEX_H
+#define TREE_SIMILARITY_TREE_INDEX_TREE_INDEX_H
+
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include "node.h"
+#include "tree_dag.h"
+
+namespace tree_index {
+
+/// \class TreeIndex
+///
+/// \details
+/// Postorder index of a tree. Nodes are identified by their postorder ids
+/// starting with 1. The children of all nodes are stored in one array, the
+/// children of a node are consecutive and ordered from left to right.
+///
+/// The index refers to the nodes of the indexed tree, which must outlive it
+/// (or the next call to index).
+///
+/// \tparam Label Label type of the nodes.
+template <class Label>
+class TreeIndex {
+// Member functions.
+public:
+  /// Indexes a tree. Replaces the previous index.
+  ///
+  /// \param root Root of the tree.
+  void index(const node::Node<Label>& root);
+  /// Indexes the tree of a DAG node. The index has an entry for every node
+  /// of the tree, but a subtree shared in the DAG is traversed once, its
+  /// further occurrences are copied from the first one. The nodes of the
+  /// index are the label nodes of the DAG, which must outlive the index (or
+  /// the next call to index).
+  ///
+  /// \param dag The DAG.
+  /// \param root Id of the DAG node of the root.
+  void index(const TreeDag<Label>& dag, int root);
+  /// Returns the number of nodes.
+  int size() const;
+  /// Returns a node.
+  ///
+  /// \param i Postorder id of the node.
+  /// \return The node.
+  const node::Node<Label>& node(int i) const;
+  /// Returns the number of children of a node.
+  ///
+  /// \param i Postorder id of the node.
+  int children_count(int i) const;
+  /// Returns a child of a node.
+  ///
+  /// \param i Postorder id of the node.
+  /// \param k Position of the child, 0 is the leftmost child.
+  /// \return Postorder id of the child.
+  int child(int i, int k) const;
+  /// Returns the postorder id of the leftmost leaf descendant of a node.
+  ///
+  /// \param i Postorder id of the node.
+  int lld(int i) const;
+  /// Returns the leftmost leaf descendants of all nodes. Indexed in
+  /// postorder-1.
+  const std::vector<int>& llds() const;
+  /// Returns the DAG the tree was indexed from, nullptr for a tree indexed
+  /// from nodes.
+  const TreeDag<Label>* dag() const;
+  /// Returns the DAG node of every node if the tree was indexed from a DAG,
+  /// otherwise an empty vector. Nodes with equal DAG nodes root identical
+  /// subtrees. Indexed in postorder-1.
+  const std::vector<int>& dag_ids() const;
+  /// Collects the key-root nodes, i.e., the root and every node that has a
+  /// left sibling, in ascending postorder.
+  ///
+  /// \param kr Filled with the postorder ids of the key-root nodes.
+  void key_roots(std::vector<int>& kr) const;
+// Member variables.
+private:
+  /// Nodes. Indexed in postorder-1.
+  std::vector<std::reference_wrapper<const node::Node<Label>>> nodes_;
+  /// Position of the first child of each node in children_, followed by the
+  /// total number of children. Indexed in postorder-1.
+  std::vector<int> children_start_;
+  /// Postorder ids of the children of all nodes.
+  std::vector<int> children_;
+  /// Leftmost leaf descendants. Indexed in postorder-1.
+  std::vector<int> lld_;
+  /// The DAG of the last indexed tree, nullptr if indexed from nodes.
+  const TreeDag<Label>* dag_ = nullptr;
+  /// DAG nodes. Indexed in postorder-1.
+  std::vector<int> dag_ids_;
+// Member functions.
+private:
+  /// Traverses a subtree and appends its nodes and leftmost leaf
+  /// descendants in postorder.
+  ///
+  /// \param root Root of the subtree.
+  void index_recursion(const node::Node<Label>& root);
+  /// Traverses the subtree of a DAG node and appends its nodes, leftmost
+  /// leaf descendants, and DAG nodes in postorder. A DAG node indexed before
+  /// is not traversed again, its postorder block is copied.
+  ///
+  /// \param dag The DAG.
+  /// \param root Id of the DAG node of the subtree root.
+  /// \param first Postorder id of the first node of the block of every DAG
+  ///        node indexed so far.
+  void index_recursion(const TreeDag<Label>& dag, int root,
+                       std::unordered_map<int, int>& first);
+  /// Fills children_start_ and children_ from the leftmost leaf descendants.
+  void index_children();
+};
+
+/// Sums the costs of nodes over every subtree and every children forest of a
+/// tree, e.g., the costs of deleting whole subtrees.
+///
+/// \param t Index of the tree.
+/// \param node_cost Function returning the cost of a node.
+/// \param tree Filled with the cost of each subtree. Indexed in postorder-1.
+/// \param forest Filled with the cost of each children forest. Indexed in
+///        postorder-1.
+template <class Label, class NodeCost, class CostType>
+void subtree_costs(const TreeIndex<Label>& t, NodeCost node_cost,
+                   std::vector<CostType>& tree, std::vector<CostType>& forest);
+
+// Implementation details.
+#include "tree_index_impl.h"
+
+}
+
+#endif // TREE_SIMILARITY_TREE_INDEX_TREE_INDEX_H
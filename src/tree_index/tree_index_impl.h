@@ -0,0 +1,190 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+/// \file tree_index/tree_index_impl.h
+///
+/// \details
+/// Contains the implementation of the TreeIndex class.
+
+#ifndef TREE_SIMILARITY_TREE_INDEX_TREE_INDEX_IMPL_H
+#define TREE_SIMILARITY_TREE_INDEX_TREE_INDEX_IMPL_H
+
+template <class Label>
+void TreeIndex<Label>::index(const node::Node<Label>& root) {
+  nodes_.clear();
+  lld_.clear();
+  dag_ = nullptr;
+  dag_ids_.clear();
+  index_recursion(root);
+  index_children();
+}
+
+template <class Label>
+void TreeIndex<Label>::index(const TreeDag<Label>& dag, int root) {
+  nodes_.clear();
+  lld_.clear();
+  dag_ = &dag;
+  dag_ids_.clear();
+  // Copied blocks are read from the vectors they are appended to.
+  nodes_.reserve(dag.tree_size(root));
+  lld_.reserve(dag.tree_size(root));
+  dag_ids_.reserve(dag.tree_size(root));
+  std::unordered_map<int, int> first;
+  index_recursion(dag, root, first);
+  index_children();
+}
+
+template <class Label>
+void TreeIndex<Label>::index_recursion(const node::Node<Label>& root) {
+  const auto& root_children = root.get_children();
+  // The leftmost leaf descendant of a node is that of its first child, which
+  // is the next node in postorder.
+  const int kFirst = nodes_.size() + 1;
+  for (const auto& child : root_children) {
+    index_recursion(child);
+  }
+  nodes_.push_back(std::cref(root));
+  lld_.push_back(root_children.empty() ? static_cast<int>(nodes_.size())
+                                       : lld_[kFirst - 1]);
+}
+
+template <class Label>
+void TreeIndex<Label>::index_recursion(const TreeDag<Label>& dag, int root,
+                                       std::unordered_map<int, int>& first) {
+  const int kFirst = nodes_.size() + 1;
+  auto indexed = first.emplace(root, kFirst);
+  if (!indexed.second) {
+    // A subtree is a contiguous block in postorder, only the leftmost leaf
+    // descendants shift with its position.
+    const int kBlock = indexed.first->second;
+    const int kShift = kFirst - kBlock;
+    for (int i = kBlock; i < kBlock + dag.tree_size(root); ++i) {
+      nodes_.push_back(nodes_[i - 1]);
+      lld_.push_back(lld_[i - 1] + kShift);
+      dag_ids_.push_back(dag_ids_[i - 1]);
+    }
+    return;
+  }
+  for (int k = 0; k < dag.children_count(root); ++k) {
+    index_recursion(dag, dag.child(root, k), first);
+  }
+  nodes_.push_back(std::cref(dag.node(root)));
+  lld_.push_back(dag.children_count(root) == 0
+                     ? static_cast<int>(nodes_.size())
+                     : lld_[kFirst - 1]);
+  dag_ids_.push_back(root);
+}
+
+template <class Label>
+void TreeIndex<Label>::index_children() {
+  // The rightmost child of a node precedes it in postorder, the left sibling
+  // of a child precedes the child's leftmost leaf descendant. Every node
+  // except the root is a child, thus both passes take linear time.
+  const int kSize = nodes_.size();
+  children_start_.assign(kSize + 1, 0);
+  for (int i = 1; i <= kSize; ++i) {
+    int count = 0;
+    for (int c = i - 1; c >= lld_[i - 1]; c = lld_[c - 1] - 1) {
+      ++count;
+    }
+    children_start_[i] = children_start_[i - 1] + count;
+  }
+  children_.resize(children_start_[kSize]);
+  for (int i = 1; i <= kSize; ++i) {
+    int position = children_start_[i];
+    for (int c = i - 1; c >= lld_[i - 1]; c = lld_[c - 1] - 1) {
+      children_[--position] = c;
+    }
+  }
+}
+
+template <class Label>
+int TreeIndex<Label>::size() const {
+  return nodes_.size();
+}
+
+template <class Label>
+const node::Node<Label>& TreeIndex<Label>::node(int i) const {
+  return nodes_[i - 1];
+}
+
+template <class Label>
+int TreeIndex<Label>::children_count(int i) const {
+  return children_start_[i] - children_start_[i - 1];
+}
+
+template <class Label>
+int TreeIndex<Label>::child(int i, int k) const {
+  return children_[children_start_[i - 1] + k];
+}
+
+template <class Label>
+int TreeIndex<Label>::lld(int i) const {
+  return lld_[i - 1];
+}
+
+template <class Label>
+const std::vector<int>& TreeIndex<Label>::llds() const {
+  return lld_;
+}
+
+template <class Label>
+const TreeDag<Label>* TreeIndex<Label>::dag() const {
+  return dag_;
+}
+
+template <class Label>
+const std::vector<int>& TreeIndex<Label>::dag_ids() const {
+  return dag_ids_;
+}
+
+template <class Label>
+void TreeIndex<Label>::key_roots(std::vector<int>& kr) const {
+  // A node is a key root if no larger node shares its leftmost leaf
+  // descendant, i.e., it is the last node in postorder on its left path.
+  kr.clear();
+  std::vector<bool> path_seen(nodes_.size() + 1, false);
+  for (int i = nodes_.size(); i >= 1; --i) {
+    if (!path_seen[lld_[i - 1]]) {
+      path_seen[lld_[i - 1]] = true;
+      kr.push_back(i);
+    }
+  }
+  std::reverse(kr.begin(), kr.end());
+}
+
+template <class Label, class NodeCost, class CostType>
+void subtree_costs(const TreeIndex<Label>& t, NodeCost node_cost,
+                   std::vector<CostType>& tree, std::vector<CostType>& forest) {
+  tree.assign(t.size(), 0);
+  forest.assign(t.size(), 0);
+  // Children precede their parents in postorder.
+  for (int i = 1; i <= t.size(); ++i) {
+    for (int k = 0; k < t.children_count(i); ++k) {
+      forest[i - 1] += tree[t.child(i, k) - 1];
+    }
+    tree[i - 1] = forest[i - 1] + node_cost(t.node(i));
+  }
+}
+
+#endif // TREE_SIMILARITY_TREE_INDEX_TREE_INDEX_IMPL_H
@@ -0,0 +1,285 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file zhang_shasha/batch_ted.h
+///
+/// \details
+/// Contains the declaration of the BatchAlgorithm class. It computes the
+/// Zhang and Shasha tree edit distance of many small tree pairs at once,
+/// running the recurrences of several pairs side by side in SIMD lanes.
+
+#ifndef TREE_SIMILARITY_ZHANG_SHASHA_BATCH_TED_H
+#define TREE_SIMILARITY_ZHANG_SHASHA_BATCH_TED_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "node.h"
+#include "label_dictionary.h"
+#include "hash.h"
+#include "cost_model_traits.h"
+#include "zhang_shasha.h"
+#include "small_tree_postorder.h"
+
+namespace zhang_shasha {
+
+/// \class BatchAlgorithm
+///
+/// \details
+/// For small trees, the work around forest_distance dominates and a single
+/// pair leaves little to vectorize. Pairs whose source trees have the same
+/// shape and whose destination trees have the same shape share the key
+/// roots and leftmost leaf descendants, thus the control flow of the
+/// recurrence. Up to kLanes such pairs are computed together: every matrix
+/// cell holds kLanes distances in consecutive memory (structure of arrays),
+/// and each cell update is a loop over the lanes that the compiler turns
+/// into SIMD instructions. Only the costs differ between the lanes.
+///
+/// A batch with fewer pairs than lanes leaves the remaining lanes at zero
+/// costs, their results are discarded.
+///
+/// Fewer than kMinBatchSize pairs of equal shapes and pairs with a tree
+/// larger than kMaxBatchedSize are computed one by one by
+/// zhang_shasha::Algorithm. Batching pairs of equal sizes but different
+/// shapes with per-lane masked updates measured slower than computing them
+/// one by one, even for shapes differing in one subtree. Finding the shapes
+/// takes one pass over the nodes, which costs them about 5% on trees of a
+/// few dozen nodes.
+/// Statistics tells the share of a workload that was batched.
+template <typename Label, typename CostModel>
+class BatchAlgorithm {
+// Member struct.
+public:
+  /// Holds counters describing the work done by the last zhang_shasha_ted
+  /// call.
+  struct Statistics {
+    /// Number of tree pairs.
+    long long pairs = 0;
+    /// Number of batches computed in SIMD lanes.
+    long long batches = 0;
+    /// Number of tree pairs computed in batches.
+    long long batched_pairs = 0;
+    /// Number of tree pairs computed one by one.
+    long long single_pairs = 0;
+  };
+  /// A source and a destination tree.
+  using TreePair = std::pair<std::reference_wrapper<const node::Node<Label>>,
+                             std::reference_wrapper<const node::Node<Label>>>;
+  /// Number of tree pairs computed together.
+  static constexpr int kLanes = 8;
+  /// Maximum number of nodes of a tree computed in a batch.
+  static constexpr int kMaxBatchedSize = 64;
+  /// Minimum number of pairs with equal shapes computed as a batch. Fewer
+  /// pairs are computed faster one by one.
+  static constexpr int kMinBatchSize = 4;
+// Member functions.
+public:
+  /// Constructor. Creates the cost model based on the template.
+  BatchAlgorithm();
+  /// Constructor. Uses a copy of a configured cost model.
+  ///
+  /// \param c The cost model.
+  BatchAlgorithm(const CostModel& c);
+  /// Computes the tree edit distances of many tree pairs.
+  ///
+  /// \param pairs Source and destination trees.
+  /// \return Tree edit distance of each pair, in the order of pairs.
+  std::vector<double> zhang_shasha_ted(const std::vector<TreePair>& pairs);
+  /// Returns the counters collected by the last zhang_shasha_ted call.
+  ///
+  /// \return A Statistics object.
+  const Statistics& get_statistics() const;
+// Types and type aliases.
+private:
+  using Traits = cost_model::CostModelTraits<CostModel>;
+  /// Type of the stored distances (see CostModelTraits).
+  using CostType = typename Traits::CostType;
+  /// std::true_type if the cost model is label-based.
+  using LabelBasedCosts = std::integral_constant<bool, Traits::kLabelBased>;
+  /// std::true_type if the cost model has constant costs.
+  using ConstantCosts = std::integral_constant<bool, Traits::kConstantCosts>;
+  /// Size and shape of a tree.
+  struct TreeShape {
+    /// Number of nodes, 0 if the tree has more than kMaxBatchedSize nodes.
+    int size = 0;
+    /// Offset of the leftmost leaf descendants in lld_.
+    int lld = 0;
+    /// Hash of the leftmost leaf descendants.
+    std::uint64_t hash = 0;
+  };
+  /// Shapes of the trees of a pair.
+  struct PairShape {
+    /// Source tree.
+    TreeShape t1;
+    /// Destination tree.
+    TreeShape t2;
+  };
+  /// Nodes of a tree. Indexed in postorder-1.
+  using NodeList = std::vector<std::reference_wrapper<const node::Node<Label>>>;
+// Member variables.
+private:
+  /// Shapes of the pairs. Aligned with the pairs.
+  std::vector<PairShape> shapes_;
+  /// Postorder ids of the leftmost leaf descendants of all trees up to
+  /// kMaxBatchedSize nodes, tree after tree. A tree's are indexed in
+  /// postorder-1.
+  std::vector<std::uint8_t> lld_;
+  /// First pair of each bucket of pairs with equal tree sizes, -1 if the
+  /// bucket is empty. Indexed in
+  /// (source size-1) * kMaxBatchedSize + destination size-1.
+  std::vector<int> bucket_head_;
+  /// Next pair in the bucket of each pair, -1 for the last one.
+  std::vector<int> bucket_next_;
+  /// Pairs of the current bucket.
+  std::vector<int> bucket_;
+  /// Pairs computed one by one by single_.
+  std::vector<int> unbatched_;
+  /// Source nodes of the current batch. Indexed by lane.
+  std::vector<NodeList> t1_nodes_;
+  /// Destination nodes of the current batch. Indexed by lane.
+  std::vector<NodeList> t2_nodes_;
+  /// Leftmost leaf descendants of the source trees in the current batch of
+  /// equal shapes. Points into lld_.
+  const std::uint8_t* t1_lld_ = nullptr;
+  /// Leftmost leaf descendants of the destination trees in the current
+  /// batch of equal shapes. Points into lld_.
+  const std::uint8_t* t2_lld_ = nullptr;
+  /// Key roots of a source tree in ascending order.
+  std::vector<int> t1_kr_;
+  /// Key roots of a destination tree in ascending order.
+  std::vector<int> t2_kr_;
+  /// Number of columns of the lane matrices, i.e., destination size + 1.
+  int columns_ = 0;
+  /// Cost of deleting each source node, kLanes values per node. Indexed in
+  /// (postorder-1) * kLanes + lane.
+  std::vector<CostType> del_;
+  /// Cost of inserting each destination node (see del_).
+  std::vector<CostType> ins_;
+  /// Cost of renaming each source node to each destination node, kLanes
+  /// values per node pair. Indexed in
+  /// ((i-1) * (columns_-1) + (j-1)) * kLanes + lane.
+  std::vector<CostType> ren_;
+  /// Subtree distances, kLanes values per cell. Indexed in
+  /// (i * columns_ + j) * kLanes + lane.
+  std::vector<CostType> td_;
+  /// Subforest distances (see td_).
+  std::vector<CostType> fd_;
+  /// Ids of the labels of the current batch. For label-based cost models,
+  /// ids of the source labels only.
+  label::LabelDictionary<Label> t1_labels_;
+  /// Ids of the destination labels of the current batch. Only for
+  /// label-based cost models.
+  label::LabelDictionary<Label> t2_labels_;
+  /// Rename costs between the distinct source and destination labels of the
+  /// current batch, computed on first use. Only for label-based cost models.
+  /// Indexed in source id * number of destination labels + destination id.
+  std::vector<CostType> label_ren_;
+  /// Marks the entries of label_ren_ that are computed.
+  std::vector<bool> label_ren_computed_;
+  /// Computes the pairs that are not batched.
+  Algorithm<Label, CostModel> single_;
+  /// Cost model.
+  const CostModel c_;
+  /// Counters of the last zhang_shasha_ted call.
+  Statistics stats_;
+// Member functions.
+private:
+  /// Appends the leftmost leaf descendants of a tree to lld_ and describes
+  /// its shape. Stops after kMaxBatchedSize nodes or levels.
+  ///
+  /// \param root Root of the tree.
+  /// \param tree Shape of the tree. Its size is 0 if the tree has more than
+  ///        kMaxBatchedSize nodes, lld_ is unchanged then.
+  void index_shape(const node::Node<Label>& root, TreeShape& tree);
+  /// Collects the key roots of a tree.
+  ///
+  /// \param lld Leftmost leaf descendants of the tree.
+  /// \param size Number of nodes, at most kMaxBatchedSize.
+  /// \param kr Key roots in ascending order.
+  void key_roots(const std::uint8_t* lld, int size, std::vector<int>& kr) const;
+  /// Collects the nodes of a tree in postorder.
+  ///
+  /// \param node Root of the tree.
+  /// \param nodes Nodes.
+  void collect_nodes(const node::Node<Label>& node, NodeList& nodes) const;
+  /// Tests if two pairs have equal shapes.
+  ///
+  /// \param a A pair.
+  /// \param b Another pair with the sizes of a.
+  /// \return True if the leftmost leaf descendants are equal.
+  bool equal_shapes(int a, int b) const;
+  /// Computes the distances of the pairs of a bucket with equal sizes.
+  ///
+  /// \param pairs All pairs.
+  /// \param first First pair of the bucket.
+  /// \param result Distances, indexed by the pairs.
+  void compute_bucket(const std::vector<TreePair>& pairs, int first,
+                      std::vector<double>& result);
+  /// Computes the distances of up to kLanes pairs with equal shapes.
+  ///
+  /// \param pairs All pairs.
+  /// \param batch The pairs of the batch.
+  /// \param result Distances, indexed by the pairs.
+  void compute_batch(const std::vector<TreePair>& pairs,
+                     const std::vector<int>& batch,
+                     std::vector<double>& result);
+  /// Collects the nodes of the pairs of a batch, zeroes the lane cost
+  /// vectors, and fills those of the pairs. The trees of a batch have equal
+  /// sizes.
+  ///
+  /// \param pairs All pairs.
+  /// \param batch The pairs of the batch.
+  void reset_costs(const std::vector<TreePair>& pairs,
+                   const std::vector<int>& batch);
+  /// Fills the lane cost vectors with the per-node cost model calls.
+  void fill_costs(int lanes, std::false_type);
+  /// Fills the lane rename costs with one cost model call per distinct pair
+  /// of labels in the batch.
+  void fill_rename_costs(int lanes, std::true_type);
+  /// Fills the lane rename costs with one cost model call per pair of nodes.
+  void fill_rename_costs(int lanes, std::false_type);
+  /// Fills the lane cost vectors with the constant costs and compares
+  /// interned label ids.
+  void fill_costs(int lanes, std::true_type);
+  /// Computes the subforest distances of a key-root pair in all lanes.
+  ///
+  /// \param kr1 Postorder id of the source key root.
+  /// \param kr2 Postorder id of the destination key root.
+  void forest_distance(int kr1, int kr2);
+  /// Returns the first lane of a cell of td_ or fd_.
+  ///
+  /// \param i Source postorder id or 0.
+  /// \param j Destination postorder id or 0.
+  /// \return Offset of the cell.
+  std::size_t cell(int i, int j) const;
+};
+
+// Implementation details.
+#include "batch_ted_impl.h"
+
+}
+
+#endif // TREE_SIMILARITY_ZHANG_SHASHA_BATCH_TED_H
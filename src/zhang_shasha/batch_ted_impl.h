@@ -0,0 +1,431 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file zhang_shasha/batch_ted_impl.h
+///
+/// \details
+/// Contains the implementation of the BatchAlgorithm class.
+
+#ifndef TREE_SIMILARITY_ZHANG_SHASHA_BATCH_TED_IMPL_H
+#define TREE_SIMILARITY_ZHANG_SHASHA_BATCH_TED_IMPL_H
+
+template <typename Label, typename CostModel>
+BatchAlgorithm<Label, CostModel>::BatchAlgorithm() : single_(), c_() {}
+
+template <typename Label, typename CostModel>
+BatchAlgorithm<Label, CostModel>::BatchAlgorithm(const CostModel& c)
+    : single_(c), c_(c) {}
+
+template <typename Label, typename CostModel>
+std::vector<double> BatchAlgorithm<Label, CostModel>::zhang_shasha_ted(
+    const std::vector<TreePair>& pairs) {
+  stats_ = Statistics();
+  stats_.pairs = pairs.size();
+  std::vector<double> result(pairs.size());
+
+  // One pass over the pairs in their order collects the sizes and shapes of
+  // the small trees and buckets the pairs by the sizes of both trees. Only
+  // pairs of one bucket can be batched.
+  shapes_.assign(pairs.size(), PairShape());
+  lld_.clear();
+  bucket_head_.assign(kMaxBatchedSize * kMaxBatchedSize, -1);
+  bucket_next_.resize(pairs.size());
+  unbatched_.clear();
+  for (int p = 0; p < static_cast<int>(pairs.size()); ++p) {
+    PairShape& shape = shapes_[p];
+    index_shape(pairs[p].first, shape.t1);
+    if (shape.t1.size > 0) {
+      index_shape(pairs[p].second, shape.t2);
+    }
+    if (shape.t2.size == 0) {
+      lld_.resize(shape.t1.lld);
+      shape.t1.size = 0;
+      unbatched_.push_back(p);
+      continue;
+    }
+    int& head = bucket_head_[(shape.t1.size - 1) * kMaxBatchedSize +
+                             shape.t2.size - 1];
+    bucket_next_[p] = head;
+    head = p;
+  }
+
+  for (int first : bucket_head_) {
+    if (first < 0) {
+      continue;
+    }
+    // A pair alone in its bucket has no partner for a batch.
+    if (bucket_next_[first] < 0) {
+      unbatched_.push_back(first);
+      continue;
+    }
+    compute_bucket(pairs, first, result);
+  }
+
+  // The pairs computed one by one are visited in their input order, which
+  // is friendlier to the caches than the order of the buckets.
+  std::sort(unbatched_.begin(), unbatched_.end());
+  for (int p : unbatched_) {
+    result[p] = single_.zhang_shasha_ted(pairs[p].first, pairs[p].second);
+  }
+  stats_.single_pairs = unbatched_.size();
+  return result;
+}
+
+template <typename Label, typename CostModel>
+const typename BatchAlgorithm<Label, CostModel>::Statistics&
+BatchAlgorithm<Label, CostModel>::get_statistics() const {
+  return stats_;
+}
+
+template <typename Label, typename CostModel>
+void BatchAlgorithm<Label, CostModel>::index_shape(
+    const node::Node<Label>& root, TreeShape& tree) {
+  tree.lld = lld_.size();
+  tree.hash = 0;
+  tree.size = small_tree_postorder(root, kMaxBatchedSize,
+      [this, &tree](const node::Node<Label>&, int, int lld, bool) {
+        lld_.push_back(static_cast<std::uint8_t>(lld));
+        tree.hash = (tree.hash + lld) * 0x9e3779b97f4a7c15ULL;
+      });
+  if (tree.size == 0) {
+    lld_.resize(tree.lld);
+  }
+}
+
+template <typename Label, typename CostModel>
+void BatchAlgorithm<Label, CostModel>::key_roots(
+    const std::uint8_t* lld, int size, std::vector<int>& kr) const {
+  // A node is a key root if no larger node has its leftmost leaf
+  // descendant. One bit per leaf suffices for kMaxBatchedSize nodes.
+  kr.clear();
+  std::uint64_t leaves = 0;
+  for (int i = size; i >= 1; --i) {
+    const std::uint64_t kLeaf = std::uint64_t(1) << (lld[i - 1] - 1);
+    if (!(leaves & kLeaf)) {
+      kr.push_back(i);
+      leaves |= kLeaf;
+    }
+  }
+  std::reverse(kr.begin(), kr.end());
+}
+
+template <typename Label, typename CostModel>
+void BatchAlgorithm<Label, CostModel>::collect_nodes(
+    const node::Node<Label>& node, NodeList& nodes) const {
+  for (const node::Node<Label>& child : node.get_children()) {
+    collect_nodes(child, nodes);
+  }
+  nodes.push_back(std::cref(node));
+}
+
+template <typename Label, typename CostModel>
+bool BatchAlgorithm<Label, CostModel>::equal_shapes(int a, int b) const {
+  const PairShape& kA = shapes_[a];
+  const PairShape& kB = shapes_[b];
+  return std::equal(lld_.begin() + kA.t1.lld,
+                    lld_.begin() + kA.t1.lld + kA.t1.size,
+                    lld_.begin() + kB.t1.lld) &&
+         std::equal(lld_.begin() + kA.t2.lld,
+                    lld_.begin() + kA.t2.lld + kA.t2.size,
+                    lld_.begin() + kB.t2.lld);
+}
+
+template <typename Label, typename CostModel>
+void BatchAlgorithm<Label, CostModel>::compute_bucket(
+    const std::vector<TreePair>& pairs, int first,
+    std::vector<double>& result) {
+  bucket_.clear();
+  for (int p = first; p >= 0; p = bucket_next_[p]) {
+    bucket_.push_back(p);
+  }
+  const int kMembers = bucket_.size();
+
+  // Pairs with equal shapes are adjacent in the order of the shape hashes.
+  std::sort(bucket_.begin(), bucket_.end(), [this](int a, int b) {
+    return shapes_[a].t1.hash < shapes_[b].t1.hash ||
+           (shapes_[a].t1.hash == shapes_[b].t1.hash &&
+            shapes_[a].t2.hash < shapes_[b].t2.hash);
+  });
+  std::vector<int> batch;
+  for (int start = 0; start < kMembers;) {
+    const int kFirst = bucket_[start];
+    int end = start + 1;
+    while (end < kMembers &&
+           shapes_[bucket_[end]].t1.hash == shapes_[kFirst].t1.hash &&
+           shapes_[bucket_[end]].t2.hash == shapes_[kFirst].t2.hash) {
+      ++end;
+    }
+    batch.clear();
+    for (int m = start; m < end; ++m) {
+      // Pairs whose hashes collide with the first one are computed one by
+      // one.
+      if (m > start && !equal_shapes(kFirst, bucket_[m])) {
+        unbatched_.push_back(bucket_[m]);
+        continue;
+      }
+      batch.push_back(bucket_[m]);
+      if (static_cast<int>(batch.size()) == kLanes) {
+        compute_batch(pairs, batch, result);
+        batch.clear();
+      }
+    }
+    if (static_cast<int>(batch.size()) < kMinBatchSize) {
+      unbatched_.insert(unbatched_.end(), batch.begin(), batch.end());
+    } else {
+      compute_batch(pairs, batch, result);
+    }
+    start = end;
+  }
+}
+
+template <typename Label, typename CostModel>
+void BatchAlgorithm<Label, CostModel>::compute_batch(
+    const std::vector<TreePair>& pairs, const std::vector<int>& batch,
+    std::vector<double>& result) {
+  // All pairs of the batch have the shapes of the first one.
+  const PairShape& kShape = shapes_[batch[0]];
+  const int kT1Size = kShape.t1.size;
+  const int kT2Size = kShape.t2.size;
+  t1_lld_ = lld_.data() + kShape.t1.lld;
+  t2_lld_ = lld_.data() + kShape.t2.lld;
+  key_roots(t1_lld_, kT1Size, t1_kr_);
+  key_roots(t2_lld_, kT2Size, t2_kr_);
+  columns_ = kT2Size + 1;
+  reset_costs(pairs, batch);
+
+  // Every cell is written before it is read, no initialization needed.
+  const std::size_t kCells =
+      static_cast<std::size_t>(kT1Size + 1) * columns_ * kLanes;
+  td_.resize(kCells);
+  fd_.resize(kCells);
+  for (int kr1 : t1_kr_) {
+    for (int kr2 : t2_kr_) {
+      forest_distance(kr1, kr2);
+    }
+  }
+
+  const std::size_t kRoots = cell(kT1Size, kT2Size);
+  for (std::size_t b = 0; b < batch.size(); ++b) {
+    result[batch[b]] = td_[kRoots + b];
+  }
+  ++stats_.batches;
+  stats_.batched_pairs += batch.size();
+}
+
+template <typename Label, typename CostModel>
+void BatchAlgorithm<Label, CostModel>::reset_costs(
+    const std::vector<TreePair>& pairs, const std::vector<int>& batch) {
+  const int kLanesUsed = batch.size();
+  if (static_cast<int>(t1_nodes_.size()) < kLanes) {
+    t1_nodes_.resize(kLanes);
+    t2_nodes_.resize(kLanes);
+  }
+  for (int b = 0; b < kLanesUsed; ++b) {
+    t1_nodes_[b].clear();
+    t2_nodes_[b].clear();
+    collect_nodes(pairs[batch[b]].first, t1_nodes_[b]);
+    collect_nodes(pairs[batch[b]].second, t2_nodes_[b]);
+  }
+  const int kT1Size = t1_nodes_[0].size();
+  const int kT2Size = t2_nodes_[0].size();
+  // Unused lanes keep zero costs.
+  del_.assign(static_cast<std::size_t>(kT1Size) * kLanes, 0);
+  ins_.assign(static_cast<std::size_t>(kT2Size) * kLanes, 0);
+  ren_.assign(static_cast<std::size_t>(kT1Size) * kT2Size * kLanes, 0);
+  fill_costs(kLanesUsed, ConstantCosts());
+}
+
+template <typename Label, typename CostModel>
+void BatchAlgorithm<Label, CostModel>::fill_costs(int lanes,
+                                                  std::false_type) {
+  for (int b = 0; b < lanes; ++b) {
+    const NodeList& kT1 = t1_nodes_[b];
+    const NodeList& kT2 = t2_nodes_[b];
+    for (std::size_t i = 0; i < kT1.size(); ++i) {
+      del_[i * kLanes + b] = c_.del(kT1[i]);
+    }
+    for (std::size_t j = 0; j < kT2.size(); ++j) {
+      ins_[j * kLanes + b] = c_.ins(kT2[j]);
+    }
+  }
+  fill_rename_costs(lanes, LabelBasedCosts());
+}
+
+template <typename Label, typename CostModel>
+void BatchAlgorithm<Label, CostModel>::fill_rename_costs(int lanes,
+                                                         std::true_type) {
+  // The pairs of a batch often share labels, e.g., records of one schema.
+  const int kT2Size = columns_ - 1;
+  t1_labels_.clear();
+  t2_labels_.clear();
+  std::vector<std::vector<int>> t1_label_id(lanes);
+  std::vector<std::vector<int>> t2_label_id(lanes);
+  for (int b = 0; b < lanes; ++b) {
+    for (const node::Node<Label>& n : t1_nodes_[b]) {
+      t1_label_id[b].push_back(t1_labels_.insert(n.label()));
+    }
+    for (const node::Node<Label>& n : t2_nodes_[b]) {
+      t2_label_id[b].push_back(t2_labels_.insert(n.label()));
+    }
+  }
+  const std::size_t kT2Labels = t2_labels_.size();
+  label_ren_.resize(t1_labels_.size() * kT2Labels);
+  label_ren_computed_.assign(label_ren_.size(), false);
+  for (int b = 0; b < lanes; ++b) {
+    for (int i = 0; i < static_cast<int>(t1_label_id[b].size()); ++i) {
+      for (int j = 0; j < kT2Size; ++j) {
+        const int kA = t1_label_id[b][i];
+        const int kB = t2_label_id[b][j];
+        const std::size_t kEntry = kA * kT2Labels + kB;
+        if (!label_ren_computed_[kEntry]) {
+          label_ren_[kEntry] =
+              c_.ren(t1_labels_.label(kA), t2_labels_.label(kB));
+          label_ren_computed_[kEntry] = true;
+        }
+        ren_[(i * kT2Size + j) * kLanes + b] = label_ren_[kEntry];
+      }
+    }
+  }
+}
+
+template <typename Label, typename CostModel>
+void BatchAlgorithm<Label, CostModel>::fill_rename_costs(int lanes,
+                                                         std::false_type) {
+  const int kT2Size = columns_ - 1;
+  for (int b = 0; b < lanes; ++b) {
+    const NodeList& kT1 = t1_nodes_[b];
+    const NodeList& kT2 = t2_nodes_[b];
+    for (int i = 0; i < static_cast<int>(kT1.size()); ++i) {
+      for (int j = 0; j < kT2Size; ++j) {
+        ren_[(i * kT2Size + j) * kLanes + b] = c_.ren(kT1[i], kT2[j]);
+      }
+    }
+  }
+}
+
+template <typename Label, typename CostModel>
+void BatchAlgorithm<Label, CostModel>::fill_costs(int lanes,
+                                                  std::true_type) {
+  const cost_model::ConstantCostValues<CostModel> kCosts;
+  const CostType kDel = kCosts.del;
+  const CostType kIns = kCosts.ins;
+  const CostType kRen = kCosts.ren;
+  const int kT2Size = columns_ - 1;
+  std::vector<int> t2_label_id(kT2Size);
+  t1_labels_.clear();
+  for (int b = 0; b < lanes; ++b) {
+    const NodeList& kT1 = t1_nodes_[b];
+    const NodeList& kT2 = t2_nodes_[b];
+    for (int j = 0; j < kT2Size; ++j) {
+      t2_label_id[j] = t1_labels_.insert(kT2[j].get().label());
+      ins_[j * kLanes + b] = kIns;
+    }
+    for (int i = 0; i < static_cast<int>(kT1.size()); ++i) {
+      const int kILabel = t1_labels_.insert(kT1[i].get().label());
+      del_[i * kLanes + b] = kDel;
+      for (int j = 0; j < kT2Size; ++j) {
+        ren_[(i * kT2Size + j) * kLanes + b] =
+            kILabel == t2_label_id[j] ? 0 : kRen;
+      }
+    }
+  }
+}
+
+template <typename Label, typename CostModel>
+void BatchAlgorithm<Label, CostModel>::forest_distance(int kr1, int kr2) {
+  const std::uint8_t* kT1Lld = t1_lld_;
+  const std::uint8_t* kT2Lld = t2_lld_;
+  const int kT2Size = columns_ - 1;
+  const int kKr1Lld = kT1Lld[kr1 - 1]; // Indexed in postorder-1.
+  const int kKr2Lld = kT2Lld[kr2 - 1];
+  const int kT1Empty = kKr1Lld - 1;
+  const int kT2Empty = kKr2Lld - 1;
+  CostType* fd = fd_.data();
+  CostType* td = td_.data();
+
+  // Distance between two empty forests.
+  CostType* empty = fd + cell(kT1Empty, kT2Empty);
+  for (int l = 0; l < kLanes; ++l) {
+    empty[l] = 0;
+  }
+
+  // Distances between a source forest and an empty forest.
+  for (int i = kKr1Lld; i <= kr1; ++i) {
+    CostType* f = fd + cell(i, kT2Empty);
+    const CostType* up = fd + cell(i - 1, kT2Empty);
+    const CostType* del = del_.data() + (i - 1) * kLanes;
+    for (int l = 0; l < kLanes; ++l) {
+      f[l] = up[l] + del[l];
+    }
+  }
+
+  // Distances between a destination forest and an empty forest.
+  for (int j = kKr2Lld; j <= kr2; ++j) {
+    CostType* f = fd + cell(kT1Empty, j);
+    const CostType* left = fd + cell(kT1Empty, j - 1);
+    const CostType* ins = ins_.data() + (j - 1) * kLanes;
+    for (int l = 0; l < kLanes; ++l) {
+      f[l] = left[l] + ins[l];
+    }
+  }
+
+  // Distances between non-empty forests. Each lane loop is one SIMD update
+  // of the cell in all pairs of the batch.
+  for (int i = kKr1Lld; i <= kr1; ++i) {
+    const int kILld = kT1Lld[i - 1];
+    const CostType* del = del_.data() + (i - 1) * kLanes;
+    for (int j = kKr2Lld; j <= kr2; ++j) {
+      CostType* f = fd + cell(i, j);
+      CostType* t = td + cell(i, j);
+      const CostType* up = fd + cell(i - 1, j);
+      const CostType* left = fd + cell(i, j - 1);
+      const CostType* ins = ins_.data() + (j - 1) * kLanes;
+      if (kILld == kKr1Lld && kT2Lld[j - 1] == kKr2Lld) {
+        // Two subtrees: delete, insert, or rename the roots.
+        const CostType* diag = fd + cell(i - 1, j - 1);
+        const CostType* ren =
+            ren_.data() + ((i - 1) * kT2Size + (j - 1)) * kLanes;
+        for (int l = 0; l < kLanes; ++l) {
+          const CostType kMin = std::min(std::min(up[l] + del[l],
+                                                  left[l] + ins[l]),
+                                         diag[l] + ren[l]);
+          f[l] = kMin;
+          t[l] = kMin;
+        }
+      } else {
+        // Two forests: delete, insert, or map the rightmost subtrees.
+        const CostType* rest = fd + cell(kILld - 1, kT2Lld[j - 1] - 1);
+        for (int l = 0; l < kLanes; ++l) {
+          f[l] = std::min(std::min(up[l] + del[l], left[l] + ins[l]),
+                          rest[l] + t[l]);
+        }
+      }
+    }
+  }
+}
+
+template <typename Label, typename CostModel>
+std::size_t BatchAlgorithm<Label, CostModel>::cell(int i, int j) const {
+  return (static_cast<std::size_t>(i) * columns_ + j) * kLanes;
+}
+
+#endif // TREE_SIMILARITY_ZHANG_SHASHA_BATCH_TED_IMPL_H
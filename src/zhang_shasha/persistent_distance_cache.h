@@ -0,0 +1,203 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file zhang_shasha/persistent_distance_cache.h
+///
+/// \details
+/// Contains the declaration of the PersistentDistanceCache class. It stores
+/// tree edit distances of whole tree pairs in a file, so that repeated runs
+/// over mostly unchanged data look up the distances of unchanged pairs
+/// instead of computing them.
+
+#ifndef TREE_SIMILARITY_ZHANG_SHASHA_PERSISTENT_DISTANCE_CACHE_H
+#define TREE_SIMILARITY_ZHANG_SHASHA_PERSISTENT_DISTANCE_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#define TREE_SIMILARITY_HAS_TRUNCATE
+#endif
+#include "node.h"
+#include "hash.h"
+#include "zhang_shasha.h"
+
+namespace zhang_shasha {
+
+/// \class PersistentDistanceCache
+///
+/// \details
+/// Distance cache keyed by the fingerprints of both trees and an id of the
+/// cost model. The entries are kept in an in-memory hash index and appended
+/// to a local file, which is read back when the cache is opened.
+///
+/// The cache is thread-safe: algorithm instances running in different
+/// threads may share one cache. The file must not be written by several
+/// processes at once. Fingerprints are 64-bit, the cache does not verify the
+/// trees on a hit.
+///
+/// File format: the 8 bytes "TSDC0001" followed by records of three 64-bit
+/// unsigned integers (fingerprint of t1, fingerprint of t2, cost model id)
+/// and a 64-bit double (the distance) in the byte order of the machine. An
+/// incomplete record at the end, e.g., after a crash, is cut off on open.
+class PersistentDistanceCache {
+// Member struct.
+public:
+  /// Counters describing the use of the cache since it was opened.
+  struct Statistics {
+    /// Number of lookups that found a distance.
+    long long hits = 0;
+    /// Number of lookups that did not find a distance.
+    long long misses = 0;
+    /// Number of distances in the index.
+    long long entries = 0;
+    /// Number of distances read from the file on open.
+    long long loaded = 0;
+  };
+// Member functions.
+public:
+  /// Writes the buffered records to the file.
+  ~PersistentDistanceCache();
+
+  /// Opens a cache file, creating it if it does not exist, and reads its
+  /// entries into the index. Replaces a previously opened file.
+  ///
+  /// \param path Path to the cache file.
+  /// \return True on success, false otherwise (see get_error).
+  bool open(const std::string& path);
+
+  /// Looks up the distance of a tree pair.
+  ///
+  /// \param fingerprint1 Fingerprint of the source tree.
+  /// \param fingerprint2 Fingerprint of the destination tree.
+  /// \param cost_model_id Id of the cost model.
+  /// \param distance Set to the stored distance if found.
+  /// \return True if the distance was found.
+  bool lookup(std::uint64_t fingerprint1, std::uint64_t fingerprint2,
+              std::uint64_t cost_model_id, double& distance);
+
+  /// Stores the distance of a tree pair and appends it to the file. Records
+  /// are buffered, see flush.
+  ///
+  /// \param fingerprint1 Fingerprint of the source tree.
+  /// \param fingerprint2 Fingerprint of the destination tree.
+  /// \param cost_model_id Id of the cost model.
+  /// \param distance The distance.
+  /// \return True on success, false if writing failed (see get_error).
+  bool insert(std::uint64_t fingerprint1, std::uint64_t fingerprint2,
+              std::uint64_t cost_model_id, double distance);
+
+  /// Writes the buffered records to the file.
+  ///
+  /// \return True on success, false otherwise (see get_error).
+  bool flush();
+
+  /// Returns the distance of two trees from the cache, or computes it with
+  /// the algorithm and stores it.
+  ///
+  /// \param algorithm The algorithm computing distances that are not cached.
+  /// \param t1 Source tree.
+  /// \param t2 Destination tree.
+  /// \param cost_model_id Id of the algorithm's cost model. Must change
+  ///        whenever the costs change, e.g., the fingerprint of a costs file.
+  /// \return The tree edit distance.
+  template <typename Label, typename CostModel>
+  double ted(Algorithm<Label, CostModel>& algorithm,
+             const node::Node<Label>& t1, const node::Node<Label>& t2,
+             std::uint64_t cost_model_id);
+
+  /// Computes a fingerprint of a tree from the labels' string
+  /// representations and the tree structure. It does not depend on the
+  /// platform or the process, so it can be stored.
+  ///
+  /// \param tree The tree.
+  /// \return The fingerprint.
+  template <typename Label>
+  static std::uint64_t fingerprint(const node::Node<Label>& tree);
+
+  /// Computes a fingerprint of a string, e.g., of a costs file to be used as
+  /// a cost model id.
+  ///
+  /// \param bytes The string.
+  /// \return The fingerprint.
+  static std::uint64_t fingerprint(const std::string& bytes);
+
+  /// Returns the counters of the cache.
+  ///
+  /// \return A copy of the counters.
+  Statistics get_statistics() const;
+
+  /// Returns the description of the last error.
+  ///
+  /// \return The error message.
+  std::string get_error() const;
+// Types and type aliases.
+private:
+  /// Fingerprints of a tree pair and the cost model id.
+  struct Key {
+    std::uint64_t fingerprint1;
+    std::uint64_t fingerprint2;
+    std::uint64_t cost_model_id;
+    bool operator==(const Key& other) const {
+      return fingerprint1 == other.fingerprint1 &&
+             fingerprint2 == other.fingerprint2 &&
+             cost_model_id == other.cost_model_id;
+    }
+  };
+  struct KeyHash {
+    std::size_t operator()(const Key& key) const {
+      return static_cast<std::size_t>(
+          (key.fingerprint1 * 0x9e3779b97f4a7c15ULL ^ key.fingerprint2) *
+          0x9e3779b97f4a7c15ULL ^ key.cost_model_id);
+    }
+  };
+  /// A record of the file.
+  struct Record {
+    Key key;
+    double distance;
+  };
+// Member variables.
+private:
+  /// Distances of all stored tree pairs.
+  std::unordered_map<Key, double, KeyHash> index_;
+  /// The file the records are appended to.
+  std::ofstream file_;
+  /// Counters.
+  Statistics stats_;
+  /// Description of the last error.
+  std::string error_;
+  /// Guards all members above.
+  mutable std::mutex mutex_;
+};
+
+// Implementation details.
+#include "persistent_distance_cache_impl.h"
+
+}
+
+#endif // TREE_SIMILARITY_ZHANG_SHASHA_PERSISTENT_DISTANCE_CACHE_H
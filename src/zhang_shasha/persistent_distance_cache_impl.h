@@ -0,0 +1,198 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file zhang_shasha/persistent_distance_cache_impl.h
+///
+/// \details
+/// Contains the implementation of the PersistentDistanceCache class.
+
+#ifndef TREE_SIMILARITY_ZHANG_SHASHA_PERSISTENT_DISTANCE_CACHE_IMPL_H
+#define TREE_SIMILARITY_ZHANG_SHASHA_PERSISTENT_DISTANCE_CACHE_IMPL_H
+
+inline PersistentDistanceCache::~PersistentDistanceCache() {
+  flush();
+}
+
+inline bool PersistentDistanceCache::open(const std::string& path) {
+  static_assert(sizeof(Record) == 32, "Records must not contain padding.");
+  const char kMagic[] = "TSDC0001";
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (file_.is_open()) {
+    file_.close();
+  }
+  index_.clear();
+  stats_ = Statistics();
+  error_.clear();
+
+  // Read the existing records. A new file is created with the magic number,
+  // an incomplete record at the end is cut off.
+  bool create = true;
+  bool torn = false;
+  std::ifstream in(path, std::ios::binary);
+  if (in.is_open()) {
+    char magic[8];
+    in.read(magic, sizeof(magic));
+    if (in.gcount() != 0 &&
+        (in.gcount() != sizeof(magic) ||
+         std::memcmp(magic, kMagic, sizeof(magic)) != 0)) {
+      error_ = "Not a distance cache file: " + path;
+      return false;
+    }
+    create = in.gcount() == 0;
+    Record record;
+    while (in.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+      index_[record.key] = record.distance;
+      ++stats_.loaded;
+    }
+    torn = in.gcount() != 0;
+    in.close();
+  }
+  stats_.entries = index_.size();
+
+  if (torn) {
+    const long long kSize = sizeof(kMagic) - 1 + stats_.loaded * sizeof(Record);
+#ifdef TREE_SIMILARITY_HAS_TRUNCATE
+    create = ::truncate(path.c_str(), kSize) != 0;
+#else
+    create = true;
+#endif
+  }
+  if (create) {
+    // A torn file that cannot be truncated is written anew.
+    file_.open(path, std::ios::binary | std::ios::trunc);
+    file_.write(kMagic, sizeof(kMagic) - 1);
+    for (const auto& entry : index_) {
+      const Record kRecord{entry.first, entry.second};
+      file_.write(reinterpret_cast<const char*>(&kRecord), sizeof(kRecord));
+    }
+    file_.flush();
+  } else {
+    file_.open(path, std::ios::binary | std::ios::app);
+  }
+  if (!file_) {
+    error_ = "Cannot write the distance cache file: " + path;
+    file_.close();
+    return false;
+  }
+  return true;
+}
+
+inline bool PersistentDistanceCache::lookup(std::uint64_t fingerprint1,
+                                            std::uint64_t fingerprint2,
+                                            std::uint64_t cost_model_id,
+                                            double& distance) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = index_.find(Key{fingerprint1, fingerprint2, cost_model_id});
+  if (it == index_.end()) {
+    ++stats_.misses;
+    return false;
+  }
+  ++stats_.hits;
+  distance = it->second;
+  return true;
+}
+
+inline bool PersistentDistanceCache::insert(std::uint64_t fingerprint1,
+                                            std::uint64_t fingerprint2,
+                                            std::uint64_t cost_model_id,
+                                            double distance) {
+  const Record kRecord{Key{fingerprint1, fingerprint2, cost_model_id},
+                       distance};
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!index_.emplace(kRecord.key, distance).second) {
+    // Another thread computed the same distance meanwhile.
+    return true;
+  }
+  ++stats_.entries;
+  if (!file_.is_open()) {
+    error_ = "The distance cache file is not open.";
+    return false;
+  }
+  if (!file_.write(reinterpret_cast<const char*>(&kRecord), sizeof(kRecord))) {
+    error_ = "Error while writing the distance cache file.";
+    return false;
+  }
+  return true;
+}
+
+inline bool PersistentDistanceCache::flush() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (file_.is_open() && !file_.flush()) {
+    error_ = "Error while writing the distance cache file.";
+    return false;
+  }
+  return true;
+}
+
+template <typename Label, typename CostModel>
+double PersistentDistanceCache::ted(Algorithm<Label, CostModel>& algorithm,
+                                    const node::Node<Label>& t1,
+                                    const node::Node<Label>& t2,
+                                    std::uint64_t cost_model_id) {
+  const std::uint64_t kFingerprint1 = fingerprint(t1);
+  const std::uint64_t kFingerprint2 = fingerprint(t2);
+  double distance = 0.0;
+  if (!lookup(kFingerprint1, kFingerprint2, cost_model_id, distance)) {
+    // Computed without holding the lock, a failed write only costs a
+    // recomputation in the next run.
+    distance = algorithm.zhang_shasha_ted(t1, t2);
+    insert(kFingerprint1, kFingerprint2, cost_model_id, distance);
+  }
+  return distance;
+}
+
+template <typename Label>
+std::uint64_t PersistentDistanceCache::fingerprint(
+    const node::Node<Label>& tree) {
+  // Merkle-style: the label, the number of children, and the children's
+  // fingerprints in order.
+  std::uint64_t h = data_structures::mix_hash(
+      fingerprint(tree.label().to_string()) + tree.get_children().size());
+  for (const auto& child : tree.get_children()) {
+    h = data_structures::mix_hash(h + fingerprint(child));
+  }
+  return h;
+}
+
+inline std::uint64_t PersistentDistanceCache::fingerprint(
+    const std::string& bytes) {
+  // FNV-1a, 64-bit.
+  std::uint64_t h = 14695981039346656037ULL;
+  for (char c : bytes) {
+    h ^= static_cast<unsigned char>(c);
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+inline PersistentDistanceCache::Statistics
+PersistentDistanceCache::get_statistics() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+inline std::string PersistentDistanceCache::get_error() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return error_;
+}
+
+#endif // TREE_SIMILARITY_ZHANG_SHASHA_PERSISTENT_DISTANCE_CACHE_IMPL_H
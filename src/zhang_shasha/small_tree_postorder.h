@@ -0,0 +1,102 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file zhang_shasha/small_tree_postorder.h
+///
+/// \details
+/// Contains the postorder traversal shared by the Zhang and Shasha engines
+/// for trees of bounded size. It finds the leftmost leaf descendants and key
+/// roots on the fly and leaves a tree that exceeds the bound without
+/// traversing it.
+
+#ifndef TREE_SIMILARITY_ZHANG_SHASHA_SMALL_TREE_POSTORDER_H
+#define TREE_SIMILARITY_ZHANG_SHASHA_SMALL_TREE_POSTORDER_H
+
+#include "node.h"
+
+namespace zhang_shasha {
+
+/// Traverses a subtree in postorder for small_tree_postorder.
+///
+/// \param node Root of the subtree.
+/// \param depth Depth of the node, 1 for the root.
+/// \param key_root True if the node is a key root.
+/// \param capacity Maximum number of nodes and levels.
+/// \param size Number of nodes visited so far.
+/// \param visit Called for each node.
+/// \return Postorder id of the leftmost leaf descendant of node, or 0 if the
+///         tree exceeds the capacity.
+template <typename Label, typename Visit>
+int small_tree_postorder_recursion(const node::Node<Label>& node, int depth,
+                                   bool key_root, int capacity, int& size,
+                                   Visit& visit) {
+  // A deep tree is left after capacity levels, it has more nodes.
+  if (depth > capacity) {
+    return 0;
+  }
+  int lld = 0;
+  for (const node::Node<Label>& child : node.get_children()) {
+    // Every child but the first one is a key root.
+    const int kChildLld = small_tree_postorder_recursion(
+        child, depth + 1, lld != 0, capacity, size, visit);
+    if (kChildLld == 0) {
+      return 0;
+    }
+    if (lld == 0) {
+      lld = kChildLld;
+    }
+  }
+  if (size == capacity) {
+    return 0;
+  }
+  ++size;
+  if (lld == 0) {
+    lld = size;
+  }
+  visit(node, size, lld, key_root);
+  return lld;
+}
+
+/// Traverses a tree of at most capacity nodes in postorder. Stops after
+/// capacity nodes or levels, some nodes were visited then.
+///
+/// \param root Root of the tree.
+/// \param capacity Maximum number of nodes.
+/// \param visit Called for each node with the node, its postorder id, the
+///        postorder id of its leftmost leaf descendant, and true if it is a
+///        key root. Key roots are visited in ascending postorder, the root
+///        is the last one.
+/// \return Number of nodes, or 0 if the tree has more than capacity nodes.
+template <typename Label, typename Visit>
+int small_tree_postorder(const node::Node<Label>& root, int capacity,
+                         Visit visit) {
+  int size = 0;
+  if (small_tree_postorder_recursion(root, 1, true, capacity, size, visit) ==
+      0) {
+    return 0;
+  }
+  return size;
+}
+
+}
+
+#endif // TREE_SIMILARITY_ZHANG_SHASHA_SMALL_TREE_POSTORDER_H
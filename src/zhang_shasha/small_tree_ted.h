@@ -0,0 +1,226 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file zhang_shasha/small_tree_ted.h
+///
+/// \details
+/// Contains the declaration of the SmallTreeTED class, a Zhang and Shasha
+/// implementation for trees of bounded size with fixed-size buffers, and of
+/// the SizeDispatchingAlgorithm class that picks an implementation by the
+/// sizes of the input trees.
+
+#ifndef TREE_SIMILARITY_ZHANG_SHASHA_SMALL_TREE_TED_H
+#define TREE_SIMILARITY_ZHANG_SHASHA_SMALL_TREE_TED_H
+
+#include <algorithm>
+#include <array>
+#include <type_traits>
+#include "node.h"
+#include "label_dictionary.h"
+#include "cost_model_traits.h"
+#include "zhang_shasha.h"
+#include "small_tree_postorder.h"
+
+namespace zhang_shasha {
+
+/// \class SmallTreeTED
+///
+/// \details
+/// Computes the tree edit distance between trees of at most N nodes. All
+/// indexes, costs, and distance matrices are std::array members sized by N,
+/// thus a computation allocates no memory, except for interning the labels
+/// with label-based cost models. For tiny trees, the allocations and
+/// bookkeeping of zhang_shasha::Algorithm dominate the running time.
+///
+/// The rename costs of all node pairs are computed once up front, the
+/// recurrence reads them from a table. With label-based cost models, the
+/// cost model is called once per distinct pair of labels. An instance holds
+/// about 3 * (N+1)^2 distances, create it once and reuse it.
+///
+/// \tparam N Maximum number of nodes of an input tree.
+template <typename Label, typename CostModel, int N>
+class SmallTreeTED {
+// Member functions.
+public:
+  /// Maximum number of nodes of an input tree.
+  static constexpr int kCapacity = N;
+  /// Constructor. Creates the cost model based on the template.
+  SmallTreeTED();
+  /// Constructor. Uses a copy of a configured cost model.
+  ///
+  /// \param c The cost model.
+  SmallTreeTED(const CostModel& c);
+  /// Computes the tree edit distance between two trees with at most N nodes
+  /// each.
+  ///
+  /// \param t1 Source tree.
+  /// \param t2 Destination tree.
+  /// \return Tree edit distance value, or -1 if a tree has more than N nodes.
+  double zhang_shasha_ted(const node::Node<Label>& t1,
+                          const node::Node<Label>& t2);
+// Types and type aliases.
+private:
+  using Traits = cost_model::CostModelTraits<CostModel>;
+  /// Type of the stored distances (see CostModelTraits).
+  using CostType = typename Traits::CostType;
+  /// std::true_type if the cost model is label-based.
+  using LabelBasedCosts = std::integral_constant<bool, Traits::kLabelBased>;
+  /// Placeholder for the label dictionary of cost models whose labels need
+  /// not be hashable.
+  struct NoLabelDictionary {};
+  /// Type of the label dictionary.
+  using LabelIds = typename std::conditional<LabelBasedCosts::value,
+      label::LabelDictionary<Label>, NoLabelDictionary>::type;
+  /// Indexes of one input tree.
+  struct IndexedTree {
+    /// Number of nodes.
+    int size = 0;
+    /// Number of key-root nodes.
+    int kr_count = 0;
+    /// Postorder ids of the leftmost leaf descendants. Indexed in
+    /// postorder-1.
+    std::array<int, N> lld;
+    /// Postorder ids of the key-root nodes in ascending order.
+    std::array<int, N> kr;
+    /// Observers of the nodes. Indexed in postorder-1.
+    std::array<const node::Node<Label>*, N> nodes;
+  };
+// Member variables.
+private:
+  /// Index of the source tree.
+  IndexedTree t1_;
+  /// Index of the destination tree.
+  IndexedTree t2_;
+  /// Cost of deleting each source node. Indexed in postorder-1.
+  std::array<CostType, N> del_;
+  /// Cost of inserting each destination node. Indexed in postorder-1.
+  std::array<CostType, N> ins_;
+  /// Cost of renaming each source node to each destination node. Indexed in
+  /// (i-1) * N + (j-1).
+  std::array<CostType, N * N> ren_;
+  /// Subtree distances. Indexed in i * (N+1) + j.
+  std::array<CostType, (N + 1) * (N + 1)> td_;
+  /// Subforest distances. Indexed in i * (N+1) + j.
+  std::array<CostType, (N + 1) * (N + 1)> fd_;
+  /// Labels of one input tree. Only for label-based cost models.
+  LabelIds labels_;
+  /// The first source node with the label of each source node. Only for
+  /// label-based cost models. Indexed in postorder-1.
+  std::array<int, N> t1_first_;
+  /// The first destination node with the label of each destination node
+  /// (see t1_first_).
+  std::array<int, N> t2_first_;
+  /// Cost model.
+  const CostModel c_;
+// Member functions.
+private:
+  /// Indexes an input tree. Stops after N nodes or levels.
+  ///
+  /// \param root Root of the tree.
+  /// \param tree The index.
+  /// \return False if the tree has more than N nodes.
+  bool index_tree(const node::Node<Label>& root, IndexedTree& tree) const;
+  /// Computes the node costs of the indexed trees with the cost model.
+  void compute_costs(std::false_type);
+  /// Computes the rename costs with one cost model call per distinct pair of
+  /// labels.
+  void compute_rename_costs(std::true_type);
+  /// Computes the rename costs with one cost model call per pair of nodes.
+  void compute_rename_costs(std::false_type);
+  /// Finds the first node with the label of each node of a tree.
+  ///
+  /// \param tree The index.
+  /// \param first Filled with the postorder-1 of the first node with the
+  ///        label of each node. Indexed in postorder-1.
+  void find_first_labels(const IndexedTree& tree, std::array<int, N>& first);
+  /// Fills the node costs of the indexed trees with the constant costs.
+  void compute_costs(std::true_type);
+  /// Computes the subforest distances of a key-root pair.
+  ///
+  /// \param kr1 Postorder id of the source key root.
+  /// \param kr2 Postorder id of the destination key root.
+  void forest_distance(int kr1, int kr2);
+};
+
+/// \class SizeDispatchingAlgorithm
+///
+/// \details
+/// Computes the tree edit distance with the smallest SmallTreeTED whose
+/// capacity fits both trees, and with zhang_shasha::Algorithm otherwise.
+/// The engines are tried from the smallest on. Each one stops indexing once
+/// its capacity of nodes or levels is exceeded, thus the trees are not
+/// traversed only to find their sizes. Holds one engine of each size, thus
+/// about 100 KB for distances of type double.
+template <typename Label, typename CostModel>
+class SizeDispatchingAlgorithm {
+// Member struct.
+public:
+  /// Counts the computations per engine since the construction.
+  struct Statistics {
+    /// Computations with trees of at most kTinySize nodes.
+    long long tiny = 0;
+    /// Computations with trees of at most kSmallSize nodes.
+    long long small = 0;
+    /// Computations with zhang_shasha::Algorithm.
+    long long general = 0;
+  };
+  /// Capacity of the engine for the smallest trees.
+  static constexpr int kTinySize = 16;
+  /// Capacity of the engine for small trees.
+  static constexpr int kSmallSize = 64;
+// Member functions.
+public:
+  /// Constructor. Creates the cost model based on the template.
+  SizeDispatchingAlgorithm();
+  /// Constructor. Uses a copy of a configured cost model.
+  ///
+  /// \param c The cost model.
+  SizeDispatchingAlgorithm(const CostModel& c);
+  /// Computes the tree edit distance between two trees.
+  ///
+  /// \param t1 Source tree.
+  /// \param t2 Destination tree.
+  /// \return Tree edit distance value.
+  double zhang_shasha_ted(const node::Node<Label>& t1,
+                          const node::Node<Label>& t2);
+  /// Returns the number of computations per engine.
+  ///
+  /// \return A Statistics object.
+  const Statistics& get_statistics() const;
+// Member variables.
+private:
+  /// Engine for the smallest trees.
+  SmallTreeTED<Label, CostModel, kTinySize> tiny_;
+  /// Engine for small trees.
+  SmallTreeTED<Label, CostModel, kSmallSize> small_;
+  /// Engine for all other trees.
+  Algorithm<Label, CostModel> general_;
+  /// Computations per engine.
+  Statistics stats_;
+};
+
+// Implementation details.
+#include "small_tree_ted_impl.h"
+
+}
+
+#endif // TREE_SIMILARITY_ZHANG_SHASHA_SMALL_TREE_TED_H
@@ -0,0 +1,218 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/// \file zhang_shasha/small_tree_ted_impl.h
+///
+/// \details
+/// Contains the implementation of the SmallTreeTED and
+/// SizeDispatchingAlgorithm classes.
+
+#ifndef TREE_SIMILARITY_ZHANG_SHASHA_SMALL_TREE_TED_IMPL_H
+#define TREE_SIMILARITY_ZHANG_SHASHA_SMALL_TREE_TED_IMPL_H
+
+template <typename Label, typename CostModel, int N>
+SmallTreeTED<Label, CostModel, N>::SmallTreeTED() : c_() {}
+
+template <typename Label, typename CostModel, int N>
+SmallTreeTED<Label, CostModel, N>::SmallTreeTED(const CostModel& c) : c_(c) {}
+
+template <typename Label, typename CostModel, int N>
+double SmallTreeTED<Label, CostModel, N>::zhang_shasha_ted(
+    const node::Node<Label>& t1, const node::Node<Label>& t2) {
+  if (!index_tree(t1, t1_) || !index_tree(t2, t2_)) {
+    return -1;
+  }
+  compute_costs(std::integral_constant<bool, Traits::kConstantCosts>());
+  for (int k1 = 0; k1 < t1_.kr_count; ++k1) {
+    for (int k2 = 0; k2 < t2_.kr_count; ++k2) {
+      forest_distance(t1_.kr[k1], t2_.kr[k2]);
+    }
+  }
+  return td_[t1_.size * (N + 1) + t2_.size];
+}
+
+template <typename Label, typename CostModel, int N>
+bool SmallTreeTED<Label, CostModel, N>::index_tree(
+    const node::Node<Label>& root, IndexedTree& tree) const {
+  tree.kr_count = 0;
+  tree.size = small_tree_postorder(root, N,
+      [&tree](const node::Node<Label>& node, int id, int lld, bool key_root) {
+        tree.nodes[id - 1] = &node;
+        tree.lld[id - 1] = lld;
+        if (key_root) {
+          tree.kr[tree.kr_count++] = id;
+        }
+      });
+  return tree.size > 0;
+}
+
+template <typename Label, typename CostModel, int N>
+void SmallTreeTED<Label, CostModel, N>::compute_costs(std::false_type) {
+  for (int i = 0; i < t1_.size; ++i) {
+    del_[i] = c_.del(*t1_.nodes[i]);
+  }
+  for (int j = 0; j < t2_.size; ++j) {
+    ins_[j] = c_.ins(*t2_.nodes[j]);
+  }
+  compute_rename_costs(LabelBasedCosts());
+}
+
+template <typename Label, typename CostModel, int N>
+void SmallTreeTED<Label, CostModel, N>::compute_rename_costs(std::true_type) {
+  // Nodes with equal labels have equal rename costs. The entry of the first
+  // nodes with the labels of i and j precedes that of i and j in the table.
+  find_first_labels(t1_, t1_first_);
+  find_first_labels(t2_, t2_first_);
+  for (int i = 0; i < t1_.size; ++i) {
+    const int kFirstI = t1_first_[i];
+    for (int j = 0; j < t2_.size; ++j) {
+      const int kFirstJ = t2_first_[j];
+      ren_[i * N + j] = kFirstI == i && kFirstJ == j ?
+          c_.ren(t1_.nodes[i]->label(), t2_.nodes[j]->label()) :
+          ren_[kFirstI * N + kFirstJ];
+    }
+  }
+}
+
+template <typename Label, typename CostModel, int N>
+void SmallTreeTED<Label, CostModel, N>::compute_rename_costs(std::false_type) {
+  for (int i = 0; i < t1_.size; ++i) {
+    for (int j = 0; j < t2_.size; ++j) {
+      ren_[i * N + j] = c_.ren(*t1_.nodes[i], *t2_.nodes[j]);
+    }
+  }
+}
+
+template <typename Label, typename CostModel, int N>
+void SmallTreeTED<Label, CostModel, N>::find_first_labels(
+    const IndexedTree& tree, std::array<int, N>& first) {
+  // A tree has at most N distinct labels.
+  std::array<int, N> first_of_id;
+  labels_.clear();
+  for (int i = 0; i < tree.size; ++i) {
+    const int kLabels = labels_.size();
+    const int kId = labels_.insert(tree.nodes[i]->label());
+    if (kId == kLabels) {
+      first_of_id[kId] = i;
+    }
+    first[i] = first_of_id[kId];
+  }
+}
+
+template <typename Label, typename CostModel, int N>
+void SmallTreeTED<Label, CostModel, N>::compute_costs(std::true_type) {
+  const cost_model::ConstantCostValues<CostModel> kCosts;
+  const CostType kDel = kCosts.del;
+  const CostType kIns = kCosts.ins;
+  const CostType kRen = kCosts.ren;
+  for (int i = 0; i < t1_.size; ++i) {
+    del_[i] = kDel;
+    const Label& kILabel = t1_.nodes[i]->label();
+    for (int j = 0; j < t2_.size; ++j) {
+      ren_[i * N + j] = kILabel == t2_.nodes[j]->label() ? 0 : kRen;
+    }
+  }
+  for (int j = 0; j < t2_.size; ++j) {
+    ins_[j] = kIns;
+  }
+}
+
+template <typename Label, typename CostModel, int N>
+void SmallTreeTED<Label, CostModel, N>::forest_distance(int kr1, int kr2) {
+  const int kKr1Lld = t1_.lld[kr1 - 1]; // Indexed in postorder-1.
+  const int kKr2Lld = t2_.lld[kr2 - 1];
+  const int kT1Empty = kKr1Lld - 1;
+  const int kT2Empty = kKr2Lld - 1;
+  const int kColumns = N + 1;
+
+  // Distances between a forest and an empty forest.
+  fd_[kT1Empty * kColumns + kT2Empty] = 0;
+  for (int i = kKr1Lld; i <= kr1; ++i) {
+    fd_[i * kColumns + kT2Empty] =
+        fd_[(i - 1) * kColumns + kT2Empty] + del_[i - 1];
+  }
+  for (int j = kKr2Lld; j <= kr2; ++j) {
+    fd_[kT1Empty * kColumns + j] =
+        fd_[kT1Empty * kColumns + j - 1] + ins_[j - 1];
+  }
+
+  // Distances between non-empty forests.
+  for (int i = kKr1Lld; i <= kr1; ++i) {
+    const int kILld = t1_.lld[i - 1];
+    const CostType kDel = del_[i - 1];
+    CostType* fd_row = &fd_[i * kColumns];
+    const CostType* fd_up = &fd_[(i - 1) * kColumns];
+    CostType* td_row = &td_[i * kColumns];
+    const CostType* ren_row = &ren_[(i - 1) * N];
+    for (int j = kKr2Lld; j <= kr2; ++j) {
+      const int kJLld = t2_.lld[j - 1];
+      if (kILld == kKr1Lld && kJLld == kKr2Lld) {
+        // Two subtrees: delete, insert, or rename the roots.
+        fd_row[j] = std::min({fd_up[j] + kDel,
+                              fd_row[j - 1] + ins_[j - 1],
+                              fd_up[j - 1] + ren_row[j - 1]});
+        td_row[j] = fd_row[j];
+      } else {
+        // Two forests: delete, insert, or map the rightmost subtrees.
+        fd_row[j] = std::min({fd_up[j] + kDel,
+                              fd_row[j - 1] + ins_[j - 1],
+                              fd_[(kILld - 1) * kColumns + kJLld - 1] +
+                                  td_row[j]});
+      }
+    }
+  }
+}
+
+template <typename Label, typename CostModel>
+SizeDispatchingAlgorithm<Label, CostModel>::SizeDispatchingAlgorithm()
+    : tiny_(), small_(), general_() {}
+
+template <typename Label, typename CostModel>
+SizeDispatchingAlgorithm<Label, CostModel>::SizeDispatchingAlgorithm(
+    const CostModel& c)
+    : tiny_(c), small_(c), general_(c) {}
+
+template <typename Label, typename CostModel>
+double SizeDispatchingAlgorithm<Label, CostModel>::zhang_shasha_ted(
+    const node::Node<Label>& t1, const node::Node<Label>& t2) {
+  // An engine returns -1 without computing if a tree exceeds its capacity.
+  double distance = tiny_.zhang_shasha_ted(t1, t2);
+  if (distance >= 0) {
+    ++stats_.tiny;
+    return distance;
+  }
+  distance = small_.zhang_shasha_ted(t1, t2);
+  if (distance >= 0) {
+    ++stats_.small;
+    return distance;
+  }
+  ++stats_.general;
+  return general_.zhang_shasha_ted(t1, t2);
+}
+
+template <typename Label, typename CostModel>
+const typename SizeDispatchingAlgorithm<Label, CostModel>::Statistics&
+SizeDispatchingAlgorithm<Label, CostModel>::get_statistics() const {
+  return stats_;
+}
+
+#endif // TREE_SIMILARITY_ZHANG_SHASHA_SMALL_TREE_TED_IMPL_H
@@ -0,0 +1,155 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+/// \file zhang_shasha/subtree_distance_cache.h
+///
+/// \details
+/// Contains the declaration of the SubtreeDistanceCache class. It memoizes
+/// subtree distances across TED computations, e.g., while comparing all trees
+/// of one collection to all trees of another one.
+
+#ifndef TREE_SIMILARITY_ZHANG_SHASHA_SUBTREE_DISTANCE_CACHE_H
+#define TREE_SIMILARITY_ZHANG_SHASHA_SUBTREE_DISTANCE_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace zhang_shasha {
+
+/// \class SubtreeDistanceCache
+///
+/// \details
+/// Bounded least-recently-used cache of subtree distance blocks keyed by a
+/// pair of structural subtree hashes. A block holds the subtree distances
+/// between the nodes on the left paths of two key-root nodes, which are the
+/// same for every occurrence of the two subtrees.
+///
+/// The cache is thread-safe and can be shared by algorithm instances running
+/// in different threads. All instances sharing a cache must use equal cost
+/// models. Subtree hashes are 64-bit, the cache does not verify the subtrees
+/// on a hit.
+///
+/// \tparam Value Type of the stored distances.
+template <typename Value>
+class SubtreeDistanceCache {
+// Member struct.
+public:
+  /// Counters describing the use of the cache since its construction or the
+  /// last call to clear.
+  struct Statistics {
+    /// Number of lookups that found a block.
+    long long hits = 0;
+    /// Number of lookups that did not find a block.
+    long long misses = 0;
+    /// Number of blocks removed to stay within the memory cap.
+    long long evictions = 0;
+    /// Number of blocks currently stored.
+    long long entries = 0;
+    /// Bytes currently used by the stored blocks.
+    long long bytes = 0;
+  };
+// Member functions.
+public:
+  /// Constructor.
+  ///
+  /// \param max_bytes Memory cap for the stored blocks and their bookkeeping.
+  /// \param min_cells Key-root pairs whose subforests have fewer cells than
+  ///        this are computed without consulting the cache, because their
+  ///        computation is cheaper than a synchronized lookup.
+  SubtreeDistanceCache(std::size_t max_bytes, long long min_cells = 4096);
+  /// Looks up the block of a pair of subtrees and marks it recently used.
+  ///
+  /// \param h1 Hash of the source subtree.
+  /// \param h2 Hash of the destination subtree.
+  /// \param block Set to the stored distances if found.
+  /// \return True if the block was found.
+  bool lookup(std::uint64_t h1, std::uint64_t h2, std::vector<Value>& block);
+  /// Stores the block of a pair of subtrees, evicting the least recently
+  /// used blocks if the memory cap is exceeded.
+  ///
+  /// \param h1 Hash of the source subtree.
+  /// \param h2 Hash of the destination subtree.
+  /// \param block The distances.
+  void insert(std::uint64_t h1, std::uint64_t h2, std::vector<Value> block);
+  /// Returns the minimum number of subforest cells of a cached pair.
+  long long get_min_cells() const;
+  /// Returns the counters of the cache.
+  ///
+  /// \return A copy of the counters.
+  Statistics get_statistics() const;
+  /// Removes all blocks and resets the counters.
+  void clear();
+// Types and type aliases.
+private:
+  /// Pair of subtree hashes.
+  struct Key {
+    std::uint64_t h1;
+    std::uint64_t h2;
+    bool operator==(const Key& other) const {
+      return h1 == other.h1 && h2 == other.h2;
+    }
+  };
+  struct KeyHash {
+    std::size_t operator()(const Key& key) const {
+      return static_cast<std::size_t>(key.h1 * 0x9e3779b97f4a7c15ULL ^ key.h2);
+    }
+  };
+  /// A stored block with its key, in the recency list.
+  struct Entry {
+    Key key;
+    std::vector<Value> block;
+  };
+  using EntryList = std::list<Entry>;
+// Member variables.
+private:
+  /// Memory cap in bytes.
+  const std::size_t max_bytes_;
+  /// Minimum number of subforest cells of a cached pair.
+  const long long min_cells_;
+  /// Blocks ordered from the most to the least recently used.
+  EntryList entries_;
+  /// Position of each block in entries_.
+  std::unordered_map<Key, typename EntryList::iterator, KeyHash> index_;
+  /// Counters.
+  Statistics stats_;
+  /// Guards all members above.
+  mutable std::mutex mutex_;
+// Member functions.
+private:
+  /// Returns the bytes accounted for a block.
+  ///
+  /// \param block The block.
+  /// \return Bytes of the distances and the bookkeeping.
+  static long long entry_bytes(const std::vector<Value>& block);
+};
+
+// Implementation details.
+#include "subtree_distance_cache_impl.h"
+
+}
+
+#endif // TREE_SIMILARITY_ZHANG_SHASHA_SUBTREE_DISTANCE_CACHE_H
@@ -0,0 +1,107 @@
+// The MIT License (MIT)
+// Copyright (c) 2017 Mateusz Pawlik, Nikolaus Augsten, and Daniel Kocher.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+/// \file zhang_shasha/subtree_distance_cache_impl.h
+///
+/// \details
+/// Contains the implementation of the SubtreeDistanceCache class.
+
+#ifndef TREE_SIMILARITY_ZHANG_SHASHA_SUBTREE_DISTANCE_CACHE_IMPL_H
+#define TREE_SIMILARITY_ZHANG_SHASHA_SUBTREE_DISTANCE_CACHE_IMPL_H
+
+template <typename Value>
+SubtreeDistanceCache<Value>::SubtreeDistanceCache(std::size_t max_bytes,
+                                                  long long min_cells)
+    : max_bytes_(max_bytes), min_cells_(min_cells) {}
+
+template <typename Value>
+bool SubtreeDistanceCache<Value>::lookup(std::uint64_t h1, std::uint64_t h2,
+                                         std::vector<Value>& block) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = index_.find(Key{h1, h2});
+  if (it == index_.end()) {
+    ++stats_.misses;
+    return false;
+  }
+  ++stats_.hits;
+  entries_.splice(entries_.begin(), entries_, it->second);
+  block = it->second->block;
+  return true;
+}
+
+template <typename Value>
+void SubtreeDistanceCache<Value>::insert(std::uint64_t h1, std::uint64_t h2,
+                                         std::vector<Value> block) {
+  const long long kBytes = entry_bytes(block);
+  if (kBytes > static_cast<long long>(max_bytes_)) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  const Key kKey{h1, h2};
+  if (index_.count(kKey) != 0) {
+    // Another thread computed the same block meanwhile.
+    return;
+  }
+  entries_.push_front(Entry{kKey, std::move(block)});
+  index_.emplace(kKey, entries_.begin());
+  stats_.bytes += kBytes;
+  ++stats_.entries;
+  while (stats_.bytes > static_cast<long long>(max_bytes_)) {
+    const Entry& victim = entries_.back();
+    stats_.bytes -= entry_bytes(victim.block);
+    --stats_.entries;
+    ++stats_.evictions;
+    index_.erase(victim.key);
+    entries_.pop_back();
+  }
+}
+
+template <typename Value>
+long long SubtreeDistanceCache<Value>::get_min_cells() const {
+  return min_cells_;
+}
+
+template <typename Value>
+typename SubtreeDistanceCache<Value>::Statistics
+SubtreeDistanceCache<Value>::get_statistics() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+template <typename Value>
+void SubtreeDistanceCache<Value>::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  index_.clear();
+  stats_ = Statistics();
+}
+
+template <typename Value>
+long long SubtreeDistanceCache<Value>::entry_bytes(
+    const std::vector<Value>& block) {
+  // List node, hash table node, and the block itself.
+  return sizeof(Entry) + 4 * sizeof(void*) + sizeof(Key) +
+         block.size() * sizeof(Value);
+}
+
+#endif // TREE_SIMILARITY_ZHANG_SHASHA_SUBTREE_DISTANCE_CACHE_IMPL_H
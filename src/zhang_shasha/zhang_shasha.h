@@ -31,8 +31,21 @@
 
 #include <vector>
 #include <memory>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <type_traits>
+#include <unordered_map>
 #include "node.h"
 #include "matrix.h"
+#include "hash.h"
+#include "label_dictionary.h"
+#include "tree_index.h"
+#include "cost_model_traits.h"
+#include "subtree_distance_cache.h"
 #include <iostream>
 
 namespace zhang_shasha {
@@ -45,72 +58,459 @@ public:
   struct TestItems {
     const std::vector<int>& t1_kr;
     const std::vector<int>& t1_lld;
+    const std::vector<int>& t2_lld;
+    /// Bytes of the td, fd, and rename cost matrices of the last computation
+    /// (see matrix_bytes).
+    long long matrix_bytes;
   };
+  /// An optimal edit mapping expressed as edit operations. Nodes are
+  /// identified by their postorder ids starting with 1.
+  struct EditMapping {
+    /// Pairs of mapped nodes (source, destination) with zero rename cost.
+    std::vector<std::pair<int, int>> matched;
+    /// Pairs of mapped nodes (source, destination) with non-zero rename cost.
+    std::vector<std::pair<int, int>> renamed;
+    /// Deleted source nodes.
+    std::vector<int> deleted;
+    /// Inserted destination nodes.
+    std::vector<int> inserted;
+  };
+  /// Holds counters describing the work done by the last zhang_shasha_ted
+  /// call. The counters are collected only if TREE_SIMILARITY_STATISTICS is
+  /// defined at compile time. Otherwise, they are never touched in the hot
+  /// path and remain zero.
+  struct Statistics {
+    /// True if the counters were collected.
+    static constexpr bool kEnabled =
+#ifdef TREE_SIMILARITY_STATISTICS
+        true;
+#else
+        false;
+#endif
+    /// Number of nodes of the source tree.
+    int t1_size = 0;
+    /// Number of nodes of the destination tree.
+    int t2_size = 0;
+    /// Number of key-root nodes of the source tree.
+    int t1_key_roots = 0;
+    /// Number of key-root nodes of the destination tree.
+    int t2_key_roots = 0;
+    /// Number of forest_distance calls (key-root node pairs).
+    long long forest_distance_calls = 0;
+    /// Number of key-root node pairs whose subtree distances were copied from
+    /// an identical earlier pair instead of calling forest_distance.
+    long long key_root_pairs_reused = 0;
+    /// Number of key-root node pairs whose subtree distances were found in
+    /// the subtree distance cache.
+    long long cache_hits = 0;
+    /// Number of subforest distances (fd cells) computed.
+    long long cells_computed = 0;
+    /// Bytes allocated for the td, fd, and rename cost matrices, including
+    /// row padding.
+    long long matrix_bytes = 0;
+    /// Time spent in indexing both input trees, in milliseconds.
+    double indexing_time_ms = 0.0;
+    /// Time spent in the dynamic programming part, in milliseconds.
+    double dp_time_ms = 0.0;
+  };
+  /// Bounds of the tree edit distance returned by an interrupted
+  /// computation. If the computation completed, both bounds are equal to the
+  /// distance and exact is set.
+  struct Interval {
+    /// Lower bound of the distance.
+    double lower = 0.0;
+    /// Upper bound of the distance.
+    double upper = 0.0;
+    /// True if the bounds are the distance itself.
+    bool exact = false;
+  };
+  /// A subtree of a document tree found by a subtree search.
+  struct SubtreeMatch {
+    /// Postorder id (starting with 1) of the subtree root in the document.
+    int node;
+    /// Tree edit distance between the query tree and the subtree.
+    double distance;
+  };
+  /// Predicate on the roots of the document subtrees considered by a subtree
+  /// search, e.g., a test of the root label.
+  using NodeFilter = std::function<bool(const node::Node<Label>&)>;
+  /// Type of the subtree distance cache that can be shared by algorithm
+  /// instances with equal cost models.
+  using Cache = SubtreeDistanceCache<
+      typename cost_model::CostModelTraits<CostModel>::CostType>;
 // Member functions.
 public:
   /// Constructor. Creates the cost model based on the template.
   Algorithm();
+  /// Constructor. Uses a copy of a configured cost model, e.g., one with
+  /// costs read from a file.
+  ///
+  /// \param c The cost model.
+  Algorithm(const CostModel& c);
   /// Computes the tree edit distance between two trees.
   ///
   /// \param t1 Source tree.
   /// \param t2 Destination tree.
   /// \return Tree edit distance value.
   double zhang_shasha_ted(const node::Node<Label>& t1, const node::Node<Label>& t2);
+  /// Computes the tree edit distance between the trees rooted at two DAG
+  /// nodes. The trees are indexed directly from the DAGs without
+  /// materializing them as nodes. If both trees are in the same DAG, the DAG
+  /// nodes serve as subtree ids.
+  ///
+  /// \param dag1 DAG holding the source tree.
+  /// \param root1 Id of the source tree root in dag1.
+  /// \param dag2 DAG holding the destination tree.
+  /// \param root2 Id of the destination tree root in dag2.
+  /// \return Tree edit distance value.
+  double zhang_shasha_ted(const tree_index::TreeDag<Label>& dag1, int root1,
+                          const tree_index::TreeDag<Label>& dag2, int root2);
+  /// Recomputes the tree edit distance after some subtrees of the destination
+  /// tree of the previous computation have been replaced. The source tree of
+  /// the previous computation must still exist.
+  ///
+  /// The distances of the previous computation are reused for every node of
+  /// the new destination tree whose subtree has not changed. Only the
+  /// key-root pairs whose destination subforest contains a replaced subtree
+  /// are recomputed. Nodes outside the replaced subtrees must keep their
+  /// labels and the tree structure. If a label or the structure differs, the
+  /// distance is recomputed from scratch. It is also recomputed for cost
+  /// models without label-only costs, whose labels are not kept.
+  ///
+  /// \param t2 New destination tree.
+  /// \param changed_subtrees Postorder ids (starting with 1) in the previous
+  ///        destination tree of the roots of the replaced subtrees.
+  /// \return Tree edit distance value, or -1 if there is no previous
+  ///         computation.
+  double zhang_shasha_ted_update(const node::Node<Label>& t2,
+                                 const std::vector<int>& changed_subtrees);
+  /// Computes the tree edit distance between two trees unless a deadline
+  /// passes or the computation is cancelled first. The deadline and the
+  /// cancellation flag are checked between key-root pairs, the clock only
+  /// after a number of subforest distances has been computed. An interrupted
+  /// computation returns bounds derived from the tree sizes and labels,
+  /// tightened by the key-root pairs completed so far.
+  ///
+  /// After an interrupted computation, compute_edit_mapping returns an empty
+  /// mapping and zhang_shasha_ted_update recomputes the distance from scratch.
+  ///
+  /// \param t1 Source tree.
+  /// \param t2 Destination tree.
+  /// \param deadline Point in time at which the computation is interrupted.
+  /// \param cancelled Flag set by another thread to interrupt the
+  ///        computation, or nullptr.
+  /// \return The distance as an exact interval, or its bounds.
+  Interval zhang_shasha_ted_anytime(const node::Node<Label>& t1,
+                                    const node::Node<Label>& t2,
+                                    std::chrono::steady_clock::time_point deadline,
+                                    const std::atomic<bool>* cancelled = nullptr);
+  /// Finds all subtrees of a document tree within a distance of a query
+  /// tree in one pass of the algorithm with the query as the source tree.
+  ///
+  /// A document subtree is a candidate if it passes the filter and its size
+  /// does not rule out the threshold, i.e., the cheapest insertions or
+  /// deletions of the size difference cost at most the threshold. Subforest
+  /// distances of a destination key root are computed only up to the last
+  /// node that is a candidate or read by a larger key root.
+  ///
+  /// Afterwards, compute_edit_mapping returns an empty mapping and
+  /// zhang_shasha_ted_update recomputes the distance from scratch.
+  ///
+  /// \param query Query tree.
+  /// \param document Document tree.
+  /// \param threshold Maximum distance of a reported subtree.
+  /// \param filter Predicate on subtree roots, or empty for all subtrees.
+  /// \return Matching subtrees by ascending distance, then postorder id.
+  std::vector<SubtreeMatch> search_subtrees(const node::Node<Label>& query,
+                                            const node::Node<Label>& document,
+                                            double threshold,
+                                            const NodeFilter& filter = NodeFilter());
+  /// Finds the k subtrees of a document tree closest to a query tree (see
+  /// search_subtrees). Without a threshold, only the filter prunes.
+  ///
+  /// \param query Query tree.
+  /// \param document Document tree.
+  /// \param k Number of subtrees.
+  /// \param filter Predicate on subtree roots, or empty for all subtrees.
+  /// \return At most k subtrees by ascending distance, then postorder id.
+  std::vector<SubtreeMatch> search_top_subtrees(const node::Node<Label>& query,
+                                                const node::Node<Label>& document,
+                                                int k,
+                                                const NodeFilter& filter = NodeFilter());
+  /// Sets a subtree distance cache consulted by zhang_shasha_ted for large
+  /// key-root pairs before computing them. Used only for cost models whose
+  /// costs depend on labels only.
+  ///
+  /// \param cache The cache, possibly shared with other instances, or nullptr
+  ///        to disable caching.
+  void set_cache(std::shared_ptr<Cache> cache);
+  /// Computes an optimal edit mapping between the trees of the last
+  /// zhang_shasha_ted call. Both trees must still exist.
+  ///
+  /// Only the subtree distances (td) of the distance computation are used.
+  /// The subforest distances needed for backtracking are recomputed for the
+  /// subtree pairs on the optimal path only, such that no additional matrix
+  /// is stored and the running time is bounded by that of zhang_shasha_ted.
+  ///
+  /// \return The edit mapping.
+  const EditMapping compute_edit_mapping();
   /// Creates a TestItems object and returns it.
   ///
   /// \return A TestItem object.
   const TestItems get_test_items() const;
+  /// Returns the counters collected by the last zhang_shasha_ted call.
+  ///
+  /// \return A Statistics object (all zeros if statistics are disabled).
+  const Statistics& get_statistics() const;
+// Types and type aliases.
+private:
+  using Traits = cost_model::CostModelTraits<CostModel>;
+  /// Type of the stored distances (see CostModelTraits).
+  using CostType = typename Traits::CostType;
+  /// std::true_type if the cost model is label-based.
+  using LabelBasedCosts = std::integral_constant<bool, Traits::kLabelBased>;
+  /// std::true_type if the cost model has constant costs.
+  using ConstantCosts = std::integral_constant<bool, Traits::kConstantCosts>;
+  /// std::true_type if the costs depend on labels only, i.e., identical
+  /// subtrees have identical distances to any other subtree.
+  using LabelOnlyCosts = std::integral_constant<bool,
+      Traits::kLabelBased || Traits::kConstantCosts>;
+  /// Placeholder for the label dictionary of cost models whose labels need
+  /// not be hashable.
+  struct NoLabelDictionary {};
+  /// Type of the label dictionary shared by both trees.
+  using LabelIds = typename std::conditional<LabelOnlyCosts::value,
+      label::LabelDictionary<Label>, NoLabelDictionary>::type;
+  /// Conditions interrupting the key-root loop of zhang_shasha_ted_anytime.
+  struct Interrupt {
+    /// Point in time at which the loop stops.
+    std::chrono::steady_clock::time_point deadline;
+    /// Flag stopping the loop when set, or nullptr.
+    const std::atomic<bool>* cancelled;
+  };
+  /// Number of subforest distances computed between two reads of the clock.
+  static constexpr long long kCellsPerClockCheck = 1LL << 16;
 // Member variables.
 private:
   /// Key-root nodes of the source tree.
   std::vector<int> t1_kr_;
   /// Key-root nodes of the destination tree.
   std::vector<int> t2_kr_;
-  /// Stores the postorder of the leftmost leaf descendant for each node of the
-  /// source tree.
+  /// Postorder index of the source tree: its nodes and the leftmost leaf
+  /// descendant of each node. Shared with the other TreeIndex-based
+  /// algorithms.
+  tree_index::TreeIndex<Label> t1_;
+  /// Postorder index of the destination tree.
+  tree_index::TreeIndex<Label> t2_;
+  /// Stores the cost of deleting each node of the source tree. Not used for
+  /// constant-cost models. Indexed in postorder-1.
+  std::vector<CostType> t1_del_;
+  /// Stores the cost of inserting each node of the destination tree. Not
+  /// used for constant-cost models. Indexed in postorder-1.
+  std::vector<CostType> t2_ins_;
+  /// Labels of both trees, the source tree's first. Only for cost models
+  /// with label-only costs.
+  LabelIds labels_;
+  /// Stores the id of the label of each node of the source tree in labels_.
+  /// Equal labels of both trees have equal ids, and the source tree's labels
+  /// have the smallest ids. Only for cost models with label-only costs.
+  /// Indexed in postorder-1.
+  std::vector<int> t1_label_id_;
+  /// Stores the id of the label of each node of the destination tree (see
+  /// t1_label_id_). Indexed in postorder-1.
+  std::vector<int> t2_label_id_;
+  /// Stores the id of the subtree rooted at each node of the source tree.
+  /// Ids are shared by both trees and equal ids mean identical subtrees
+  /// (labels and structure). Only for cost models with label-only costs.
   /// Indexed in postorder-1.
-  std::vector<int> t1_lld_;
-  /// Stores the postorder of the leftmost leaf descendant for each node of the
-  /// destination tree.
+  std::vector<int> t1_subtree_id_;
+  /// Stores the id of the subtree rooted at each node of the destination tree
+  /// (see t1_subtree_id_). Indexed in postorder-1.
+  std::vector<int> t2_subtree_id_;
+  /// Stores a 64-bit structural hash of the subtree rooted at each node of the
+  /// source tree, stable across computations. Only if a cache is set.
   /// Indexed in postorder-1.
-  std::vector<int> t2_lld_;
-  /// Stores pointers to nodes of the source tree. Indexed in postorder-1.
-  // NOTE: We use reference_wrapper for const references to nodes. For now, we
-  // decided not to use raw pointers. Smart pointers introduce ownership, but
-  // this vector is only an observer from a logical point of view.
-  std::vector<std::reference_wrapper<const node::Node<Label>>> t1_node_;
-  /// Stores pointers to nodes of the destination tree. Indexed in postorder-1.
-  std::vector<std::reference_wrapper<const node::Node<Label>>> t2_node_;
-  /// Matrix storing subtree distances.
-  data_structures::Matrix<double> td_;
+  std::vector<std::uint64_t> t1_subtree_hash_;
+  /// Stores a 64-bit structural hash of the subtree rooted at each node of the
+  /// destination tree (see t1_subtree_hash_). Indexed in postorder-1.
+  std::vector<std::uint64_t> t2_subtree_hash_;
+  /// For each key-root node of the source tree, an earlier key-root node with
+  /// an identical subtree, or 0. Aligned with t1_kr_. Twins are found within
+  /// one tree, whose pairs with every key root of the other tree are already
+  /// computed (see index_trees).
+  std::vector<int> t1_kr_twin_;
+  /// For each key-root node of the destination tree, an earlier key-root node
+  /// with an identical subtree, or 0. Aligned with t2_kr_.
+  std::vector<int> t2_kr_twin_;
+  /// True if the last zhang_shasha_ted call found identical input trees and
+  /// returned 0 without computing td_.
+  bool identical_trees_ = false;
+  /// True if the last computation left td_ incomplete, i.e., it was
+  /// interrupted or computed the distances to some subtrees only.
+  bool td_incomplete_ = false;
+  /// Rename costs between every distinct label of the source tree and every
+  /// distinct label of the destination tree. Only for label-based cost models.
+  data_structures::Matrix<CostType> ren_;
+  /// Matrix storing subtree distances. Cache-line aligned, and only the
+  /// pages touched by the computation are backed by memory (see
+  /// AlignedMatrixPolicy).
+  data_structures::Matrix<CostType, data_structures::AlignedMatrixPolicy> td_;
   /// Matrix storing subforest distances.
-  data_structures::Matrix<double> fd_;
+  data_structures::Matrix<CostType, data_structures::AlignedMatrixPolicy> fd_;
   /// Cost model.
   const CostModel c_;
+  /// Subtree distance cache, or nullptr.
+  std::shared_ptr<Cache> cache_;
+  /// Buffer for blocks exchanged with the cache.
+  std::vector<CostType> block_;
+  /// Counters of the last zhang_shasha_ted call.
+  Statistics stats_;
 // Member functions.
 private:
-  /// Indexes the nodes of an input tree. Wrapper for the recursive
-  /// index_nodes_recursion.
-  /// Call this method to index nodes.
+  /// Indexes both input trees and computes the costs and subtree ids used by
+  /// the key-root loop. Sets identical_trees_.
+  ///
+  /// Identical subtrees are exploited in two ways only: a key root with an
+  /// identical earlier key root of the same tree (its twin) reuses the twin's
+  /// subtree distances, and identical input trees have distance 0 if equal
+  /// labels are free. A key-root pair with identical subtrees across the two
+  /// trees is still computed: its forest distance also fills td(i, j) for the
+  /// non-corresponding nodes i and j on the left paths, which the pairs of
+  /// larger key roots read. Skipping such a pair, or the pairs inside it, is
+  /// not sound in general.
+  ///
+  /// \param t1 Source tree.
+  /// \param t2 Destination tree.
+  void index_trees(const node::Node<Label>& t1, const node::Node<Label>& t2);
+  /// Indexes the trees rooted at two DAG nodes (see index_trees above).
+  ///
+  /// \param dag1 DAG holding the source tree.
+  /// \param root1 Id of the source tree root in dag1.
+  /// \param dag2 DAG holding the destination tree.
+  /// \param root2 Id of the destination tree root in dag2.
+  void index_trees(const tree_index::TreeDag<Label>& dag1, int root1,
+                   const tree_index::TreeDag<Label>& dag2, int root2);
+  /// Runs index_inputs to fill t1_ and t2_, then computes the key roots,
+  /// costs, and subtree ids of the indexed trees.
+  ///
+  /// \param index_inputs Function indexing the source and destination trees.
+  template <typename IndexInputs>
+  void index_trees(IndexInputs index_inputs);
+  /// Computes the subtree distances of all key-root pairs, outer loop over
+  /// the source key roots in ascending postorder.
+  ///
+  /// \param interrupt Conditions to stop before the next key-root pair, or
+  ///        nullptr to compute all pairs.
+  /// \return Number of source key roots whose pairs with all destination key
+  ///         roots are computed.
+  std::size_t compute_key_root_pairs(const Interrupt* interrupt);
+  /// Returns the bytes of the td, fd, and rename cost matrices in their
+  /// current dimensions, including row padding.
+  long long matrix_bytes() const;
+  /// Computes bounds of the distance after compute_key_root_pairs completed
+  /// the given number of source key roots only. Uses the subtree distances
+  /// td(i, |T2|) of the nodes i on their left paths.
+  ///
+  /// \param completed_key_roots Number of completed source key roots.
+  /// \return Lower and upper bound of the distance.
+  Interval distance_bounds(std::size_t completed_key_roots) const;
+  /// Computes the distances between the source tree and the destination
+  /// subtrees rooted at candidate nodes, skipping subforest distances not
+  /// needed for them. Requires indexed trees.
+  ///
+  /// \param candidate Marks the candidate destination nodes. Indexed in
+  ///        postorder.
+  void compute_subtree_distances(const std::vector<bool>& candidate);
+  /// Matches the subtree of a node in the new destination tree with the
+  /// subtree of a node in the previous destination tree, in parallel
+  /// descending into the children of both and comparing the labels of the
+  /// nodes outside replaced subtrees. Uses the current destination index and
+  /// label ids for the new tree.
+  ///
+  /// \param j_new Postorder id of the node in the new tree.
+  /// \param j_old Postorder id of the node in the previous tree.
+  /// \param old_t2 Index of the previous tree.
+  /// \param old_label_id Label ids of the previous tree in labels_.
+  /// \param changed Marks the roots of replaced subtrees in the previous tree.
+  /// \param old_of_new Set to the matching node of the previous tree for every
+  ///        node of the new tree whose subtree is unchanged, left 0 otherwise.
+  /// \return False if the labels or structures outside replaced subtrees
+  ///         differ.
+  bool match_unchanged(int j_new, int j_old,
+                       const tree_index::TreeIndex<Label>& old_t2,
+                       const std::vector<int>& old_label_id,
+                       const std::vector<bool>& changed,
+                       std::vector<int>& old_of_new) const;
+  /// Computes the delete cost of every source node and the insert cost of
+  /// every destination node. For label-based cost models, computes also the
+  /// rename cost of every pair of distinct labels.
+  void compute_costs(std::false_type);
+  /// Does nothing, constant-cost models compare the label ids only.
+  void compute_costs(std::true_type);
+  /// Fills ren_ with the rename cost of every pair of a distinct source label
+  /// and a distinct destination label. Each pair is computed exactly once.
+  void compute_rename_costs(std::true_type);
+  /// Does nothing, renames are computed per node pair by the cost model.
+  void compute_rename_costs(std::false_type);
+  /// Interns the labels of the destination tree in labels_, once per node,
+  /// after those of the source tree if requested. The ids are shared by the
+  /// rename costs and the subtree ids.
+  ///
+  /// \param with_source If true, labels_ is cleared and the source labels
+  ///        are interned first. Otherwise, the source ids are kept.
+  void intern_labels(bool with_source, std::true_type);
+  /// Does nothing, the labels are passed to the cost model.
+  void intern_labels(bool with_source, std::false_type);
+  /// Assigns subtree ids to the nodes of both trees bottom-up, by hash
+  /// consing their Merkle keys, and finds the key-root twins. Computes also
+  /// the subtree hashes if a cache is set.
+  void index_subtrees(std::true_type);
+  /// Does nothing, identical subtrees may have different costs.
+  void index_subtrees(std::false_type);
+  /// Collects the nodes on the left path of a key-root node, i.e., the nodes
+  /// sharing its leftmost leaf descendant, in ascending postorder.
   ///
-  /// \param root The root node of the tree to index.
-  /// \param lld Vector with postorder ids of the leftmost leaf descendants.
-  /// \param kr Vector with postorder ids of the key-root nodes.
-  void index_nodes(const node::Node<Label>& root, std::vector<int>& lld,
-                   std::vector<int>& kr,
-                   std::vector<std::reference_wrapper<const node::Node<Label>>>& nodes);
-  /// Traverses an input tree rooted at root recursively and collects
-  /// information into index structures.
-  ///
-  /// \param root The root node of the tree to index.
   /// \param lld Vector with postorder ids of the leftmost leaf descendants.
-  /// \param kr Vector with postorder ids of the key-root nodes.
-  /// \param start_postorder Stores the postorder id of a node during traversal.
-  /// \param start_preorder Stores the preorder id of a node during traversal.
-  void index_nodes_recursion(const node::Node<Label>& root, std::vector<int>& lld,
-                             std::vector<int>& kr,
-                             std::vector<std::reference_wrapper<const node::Node<Label>>>& nodes,
-                             int& start_postorder, int& start_preorder);
+  /// \param kr Postorder id of the key-root node.
+  /// \param path Filled with postorder ids of the left path.
+  void left_path(const std::vector<int>& lld, int kr,
+                 std::vector<int>& path) const;
+  /// Copies the subtree distances of a key-root pair from the pair shifted by
+  /// the given postorder offsets, whose subtrees are identical.
+  ///
+  /// \param path1 Left path of the source key-root node.
+  /// \param path2 Left path of the destination key-root node.
+  /// \param shift1 Postorder offset of the identical source subtree.
+  /// \param shift2 Postorder offset of the identical destination subtree.
+  void copy_subtree_distances(const std::vector<int>& path1,
+                              const std::vector<int>& path2,
+                              int shift1, int shift2);
+  /// Takes the subtree distances of a key-root pair from the cache, or
+  /// computes them with forest_distance and adds them to the cache. Pairs
+  /// with small subforests are always computed.
+  ///
+  /// \param kr1 Current key-root node in source tree.
+  /// \param kr2 Current key-root node in destination tree.
+  /// \param path1 Buffer for the left path of kr1.
+  /// \param path2 Buffer for the left path of kr2.
+  void cached_forest_distance(int kr1, int kr2, std::vector<int>& path1,
+                              std::vector<int>& path2);
+  /// Returns the cost of renaming a source node to a destination node.
+  ///
+  /// \param i Postorder id of the source node.
+  /// \param j Postorder id of the destination node.
+  /// \return Rename cost.
+  CostType ren_cost(int i, int j, std::true_type) const;
+  CostType ren_cost(int i, int j, std::false_type) const;
+  /// Returns the costs of deleting a source node, inserting a destination
+  /// node, and renaming a source node to a destination node, as used by
+  /// forest_distance for the cost model.
+  ///
+  /// \param i Postorder id of the source node.
+  /// \param j Postorder id of the destination node.
+  CostType del_cost(int i) const;
+  CostType ins_cost(int j) const;
+  CostType ren_cost(int i, int j) const;
   /// Calculate distances for subforests and stores distances for subtrees.
   ///
   /// \param td Matrix storing subtree distances.
@@ -118,6 +518,14 @@ private:
   /// \param kr1 Current key-root node in source tree.
   /// \param kr2 Current key-root node in destination tree.
   void forest_distance(int kr1, int kr2);
+  /// Generic forest_distance reading the precomputed costs. Computes the
+  /// subforest distances of the destination nodes up to last2 only.
+  ///
+  /// \param last2 Last destination node in postorder, at most kr2.
+  void forest_distance(int kr1, int kr2, int last2, std::false_type);
+  /// forest_distance specialized for constant-cost models. The costs are
+  /// compile-time constants and renames compare label ids.
+  void forest_distance(int kr1, int kr2, int last2, std::true_type);
 };
 
 // Implementation details.
@@ -31,175 +31,815 @@ template <typename Label, typename CostModel>
 Algorithm<Label, CostModel>::Algorithm() : c_() {}
 
 template <typename Label, typename CostModel>
-void Algorithm<Label, CostModel>::index_nodes_recursion(
-    const node::Node<Label>& node,
-    std::vector<int>& lld,
-    std::vector<int>& kr,
-    std::vector<std::reference_wrapper<const node::Node<Label>>>& nodes,
-    int& start_postorder,
-    int& start_preorder) {
-  // std::cout << "-- node : " << node.label().to_string() << std::endl;
-  // Here, start_preorder holds this node's preorder id here.
-  // std::cout << "-- preorder : " << start_preorder << std::endl;
-  // Increment start_preorder for the consecutive node in preorder have the
-  // correct id.
-  start_preorder++;
-  // Recursions to childen nodes.
-  auto children_start_it = std::begin(node.get_children());
-  auto children_end_it=std::end(node.get_children());
-  // Treat the first child separately (non-key-root, updates parent's lld).
-  int first_child_postorder = -1;
-  if (children_start_it != children_end_it) {
-    index_nodes_recursion(*children_start_it, lld, kr, nodes, start_postorder,
-                          start_preorder);
-    // Here, start_postorder-1 is the postorder of the current child.
-    // Set this node's lld to its first child's lld.
-    first_child_postorder = start_postorder-1;
-    // Continue to consecutive children.
-    ++children_start_it;
-  }
-
-  while (children_start_it != children_end_it) {
-    index_nodes_recursion(*children_start_it, lld, kr, nodes, start_postorder,
-                          start_preorder);
-    // Here, start_postorder-1 is the postorder of the current child.
-    // Add current child to kr.
-    kr.push_back(start_postorder-1);
-    // Continue to consecutive children.
-    ++children_start_it;
-  }
-  // Here, start_postorder holds this node's postorder id here.
-  // std::cout << "-- postorder : " << start_postorder << std::endl;
-  // std::cout << "-- leaf : " << node.is_leaf() << std::endl;
-
-  if (node.is_leaf()) {
-    // Set lld of this node to this node's postorer.
-    lld.push_back(start_postorder);
-  } else {
-    // std::cout << "-- first_child_postorder : " << first_child_postorder << std::endl;
-    // std::cout << "-- lld.size : " << lld.size() << std::endl;
-    // This node's lld must be pushed after its childrens llds.
-    // lld is indexed starting with 0, thus first_child_postorder-1.
-    lld.push_back(lld.at(first_child_postorder-1));
-  }
-  // Add current node to the nodes vector.
-  nodes.push_back(std::ref(node));
-  // Increment start_postorder for the consecutive node in postorder have the
-  // correct id.
-  start_postorder++;
-}
-
-template <typename Label, typename CostModel>
-void Algorithm<Label, CostModel>::index_nodes(
-    const node::Node<Label>& root,
-    std::vector<int>& lld,
-    std::vector<int>& kr,
-    std::vector<std::reference_wrapper<const node::Node<Label>>>& nodes) {
-
-  // Index nodes of the source tree.
-  // std::cout << "--- index_nodes : source tree ---" << std::endl;
-
-  // Orders start with '1'. If '0' is needed, either index_nodes_recursion must
-  // be modified (placement of increments must change), or we start with '-1'.
-  // The order-variables are modified by index_nodes_recursion.
-  int start_postorder = 1;
-  // NOTE: Preorder is not used in Zhang and Shasha. Remove start_preorder. Or
-  //       move the template traversal with postorder and preorder to some notes
-  //       of how to traverse trees.
-  int start_preorder = 1;
-  index_nodes_recursion(root, lld, kr, nodes, start_postorder, start_preorder);
-  // Here, start_postorder and start_preorder store the size of tree minus 1.
-
-  // Add root to kr - not added in the recursion.
-  kr.push_back(start_postorder-1);
-
-  // // Print stuff.
-  // std::cout << "--- printing stuff ---" << std::endl;
-  // std::cout << "-- lld : ";
-  // for (auto e : lld) std::cout << e << ' ';
-  // std::cout << std::endl;
-  // std::cout << "-- kr : ";
-  // for (auto e : kr) std::cout << e << ' ';
-  // std::cout << std::endl;
-}
+Algorithm<Label, CostModel>::Algorithm(const CostModel& c) : c_(c) {}
 
 template <typename Label, typename CostModel>
 double Algorithm<Label, CostModel>::zhang_shasha_ted(const node::Node<Label>& t1,
                                                      const node::Node<Label>& t2) {
   // std::cout << "=== zhang_shasha_ted ===" << std::endl;
+  index_trees(t1, t2);
+  if (identical_trees_) {
+    return 0;
+  }
+  compute_key_root_pairs(nullptr);
+  return td_.at(t1_.size(), t2_.size());
+}
+
+template <typename Label, typename CostModel>
+double Algorithm<Label, CostModel>::zhang_shasha_ted(
+    const tree_index::TreeDag<Label>& dag1, int root1,
+    const tree_index::TreeDag<Label>& dag2, int root2) {
+  index_trees(dag1, root1, dag2, root2);
+  if (identical_trees_) {
+    return 0;
+  }
+  compute_key_root_pairs(nullptr);
+  return td_.at(t1_.size(), t2_.size());
+}
 
-  using data_structures::Matrix;
+template <typename Label, typename CostModel>
+typename Algorithm<Label, CostModel>::Interval
+Algorithm<Label, CostModel>::zhang_shasha_ted_anytime(
+    const node::Node<Label>& t1, const node::Node<Label>& t2,
+    std::chrono::steady_clock::time_point deadline,
+    const std::atomic<bool>* cancelled) {
+  Interval result;
+  index_trees(t1, t2);
+  if (identical_trees_) {
+    result.exact = true;
+    return result;
+  }
+  const Interrupt kInterrupt = {deadline, cancelled};
+  const std::size_t kCompleted = compute_key_root_pairs(&kInterrupt);
+  if (kCompleted == t1_kr_.size()) {
+    result.lower = result.upper = td_.at(t1_.size(), t2_.size());
+    result.exact = true;
+    return result;
+  }
+  td_incomplete_ = true;
+  return distance_bounds(kCompleted);
+}
 
-  const int kT1Size = t1.get_tree_size();
-  const int kT2Size = t2.get_tree_size();
+template <typename Label, typename CostModel>
+void Algorithm<Label, CostModel>::index_trees(const node::Node<Label>& t1,
+                                              const node::Node<Label>& t2) {
+  index_trees([&]() {
+    t1_.index(t1);
+    t2_.index(t2);
+  });
+}
+
+template <typename Label, typename CostModel>
+void Algorithm<Label, CostModel>::index_trees(
+    const tree_index::TreeDag<Label>& dag1, int root1,
+    const tree_index::TreeDag<Label>& dag2, int root2) {
+  index_trees([&]() {
+    t1_.index(dag1, root1);
+    t2_.index(dag2, root2);
+  });
+}
+
+template <typename Label, typename CostModel>
+template <typename IndexInputs>
+void Algorithm<Label, CostModel>::index_trees(IndexInputs index_inputs) {
+#ifdef TREE_SIMILARITY_STATISTICS
+  stats_ = Statistics();
+  auto indexing_start = std::chrono::steady_clock::now();
+#endif
+
+  // The indexes replace those of the previous computation.
+  index_inputs();
+  t1_.key_roots(t1_kr_);
+  t2_.key_roots(t2_kr_);
+  const int kT1Size = t1_.size();
+  const int kT2Size = t2_.size();
 
   // NOTE: The default constructor of Matrix is called while constructing ZS-Algorithm.
-  // NOTE: Shouldn't we implement Matrix::resize() instead of constructing matrix again?
-  td_ = Matrix<double>(kT1Size+1, kT2Size+1);
-  fd_ = Matrix<double>(kT1Size+1, kT2Size+1);
-
-  // Cleanup node indexes for consecutive use of the algorithm.
-  t1_lld_.clear();
-  t2_lld_.clear();
-  t1_kr_.clear();
-  t2_kr_.clear();
-  t1_node_.clear();
-  t2_node_.clear();
-  // TODO: It is better to allocate the vector with tree sizes and fill them in.
-  //       Currently lld-values are pushed-back. That results in linear-number
-  //       of push_back invocations.
-  //       Simmilar approach could be used for kr-values, but the current index,
-  //       of a kr-value to set has, to be maintained outside recursion.
-  index_nodes(t1, t1_lld_, t1_kr_, t1_node_);
-  index_nodes(t2, t2_lld_, t2_kr_, t2_node_);
-
-  // Nested loop over key-root node pairs.
-  for (auto kr1 : t1_kr_) {
-    for (auto kr2 : t2_kr_) {
-      forest_distance(kr1, kr2);
+  // Resizing reuses the memory of previous computations. All entries are
+  // written before being read.
+  td_.resize(kT1Size+1, kT2Size+1);
+  fd_.resize(kT1Size+1, kT2Size+1);
+  td_incomplete_ = false;
+
+  intern_labels(true, LabelOnlyCosts());
+  compute_costs(ConstantCosts());
+  index_subtrees(LabelOnlyCosts());
+
+  // The distance between identical trees is 0 if equal labels are free.
+  identical_trees_ = (Traits::kConstantCosts || Traits::kEqualLabelsFree) &&
+      !t1_subtree_id_.empty() && t1_subtree_id_.back() == t2_subtree_id_.back();
+
+#ifdef TREE_SIMILARITY_STATISTICS
+  stats_.indexing_time_ms = std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - indexing_start).count();
+  stats_.t1_size = kT1Size;
+  stats_.t2_size = kT2Size;
+  stats_.t1_key_roots = t1_kr_.size();
+  stats_.t2_key_roots = t2_kr_.size();
+  stats_.matrix_bytes = matrix_bytes();
+#endif
+}
+
+template <typename Label, typename CostModel>
+std::size_t Algorithm<Label, CostModel>::compute_key_root_pairs(
+    const Interrupt* interrupt) {
+#ifdef TREE_SIMILARITY_STATISTICS
+  auto dp_start = std::chrono::steady_clock::now();
+#endif
+
+  // Subforest distances computed since the clock was last read. Starts full
+  // such that the clock is read before the first pair.
+  const long long kClockCheck = kCellsPerClockCheck;
+  long long pending_cells = kClockCheck;
+
+  // Nested loop over key-root node pairs. A pair whose source or destination
+  // key root has an identical earlier key root (twin) has the subtree
+  // distances of the pair with the twin, which were computed in an earlier
+  // outer iteration or earlier in this one. A pair of identical subtrees
+  // across the trees is computed, its left-path cells are read later.
+  const bool kTwins = !t1_kr_twin_.empty();
+  std::vector<int> t1_path;
+  std::vector<int> t2_path;
+  bool stop = false;
+  std::size_t k1 = 0;
+  for (; k1 < t1_kr_.size(); ++k1) {
+    const int kr1 = t1_kr_[k1];
+    const int kTwin1 = kTwins ? t1_kr_twin_[k1] : 0;
+    if (kTwins) {
+      left_path(t1_.llds(), kr1, t1_path);
+    }
+    for (std::size_t k2 = 0; k2 < t2_kr_.size(); ++k2) {
+      const int kr2 = t2_kr_[k2];
+      const int kTwin2 = kTwins ? t2_kr_twin_[k2] : 0;
+      if (kTwin1 == 0 && kTwin2 == 0) {
+        if (interrupt) {
+          // The pair is checked before it is computed, such that a large
+          // pair does not start after the deadline.
+          pending_cells += static_cast<long long>(kr1 - t1_.lld(kr1) + 2) *
+                           (kr2 - t2_.lld(kr2) + 2);
+          if ((interrupt->cancelled &&
+               interrupt->cancelled->load(std::memory_order_relaxed)) ||
+              (pending_cells >= kClockCheck &&
+               std::chrono::steady_clock::now() >= interrupt->deadline)) {
+            stop = true;
+            break;
+          }
+          if (pending_cells >= kClockCheck) {
+            pending_cells = 0;
+          }
+        }
+        if (cache_ && !t1_subtree_hash_.empty()) {
+          cached_forest_distance(kr1, kr2, t1_path, t2_path);
+        } else {
+          forest_distance(kr1, kr2);
+        }
+        continue;
+      }
+      left_path(t2_.llds(), kr2, t2_path);
+      if (kTwin1 != 0) {
+        copy_subtree_distances(t1_path, t2_path, kr1 - kTwin1, 0);
+      } else {
+        copy_subtree_distances(t1_path, t2_path, 0, kr2 - kTwin2);
+      }
+#ifdef TREE_SIMILARITY_STATISTICS
+      ++stats_.key_root_pairs_reused;
+#endif
+    }
+    if (stop) {
+      break;
+    }
+  }
+
+#ifdef TREE_SIMILARITY_STATISTICS
+  stats_.dp_time_ms = std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - dp_start).count();
+#endif
+
+  return k1;
+}
+
+template <typename Label, typename CostModel>
+long long Algorithm<Label, CostModel>::matrix_bytes() const {
+  return (static_cast<long long>(td_.get_rows()) * td_.get_stride() +
+          static_cast<long long>(fd_.get_rows()) * fd_.get_stride() +
+          static_cast<long long>(ren_.get_rows()) * ren_.get_stride()) *
+         sizeof(CostType);
+}
+
+template <typename Label, typename CostModel>
+typename Algorithm<Label, CostModel>::Interval
+Algorithm<Label, CostModel>::distance_bounds(
+    std::size_t completed_key_roots) const {
+  const int kT1Size = t1_.size();
+  const int kT2Size = t2_.size();
+  // Delete costs of the source subtrees are differences of prefix sums in
+  // postorder: the subtree of i spans [lld(i), i].
+  std::vector<double> del_prefix(kT1Size + 1, 0.0);
+  for (int i = 1; i <= kT1Size; ++i) {
+    del_prefix[i] = del_prefix[i - 1] + del_cost(i);
+  }
+  double ins_total = 0.0;
+  for (int j = 1; j <= kT2Size; ++j) {
+    ins_total += ins_cost(j);
+  }
+
+  Interval result;
+  // Delete all source nodes and insert all destination nodes.
+  result.upper = del_prefix[kT1Size] + ins_total;
+  if (Traits::kConstantCosts) {
+    const double kDel = Traits::kDeleteCost;
+    const double kIns = Traits::kInsertCost;
+    const double kRen = Traits::kRenameCost;
+    // With m mapped node pairs, at most common of them have equal labels,
+    // where common is the size of the intersection of the label multisets.
+    // The cost is piecewise linear in m, it is minimal at a breakpoint.
+    std::unordered_map<int, int> label_count;
+    for (int id : t1_label_id_) {
+      ++label_count[id];
+    }
+    int common = 0;
+    for (int id : t2_label_id_) {
+      auto it = label_count.find(id);
+      if (it != label_count.end() && it->second > 0) {
+        --it->second;
+        ++common;
+      }
+    }
+    const int kMaxMapped = std::min(kT1Size, kT2Size);
+    result.lower = result.upper;
+    for (int m : {0, std::min(common, kMaxMapped), kMaxMapped}) {
+      result.lower = std::min(result.lower,
+          (kT1Size - m) * kDel + (kT2Size - m) * kIns +
+          std::max(0, m - common) * kRen);
+    }
+  } else {
+    // At least the size difference of nodes is deleted or inserted, rename
+    // costs are non-negative.
+    std::vector<double> costs;
+    if (kT1Size > kT2Size) {
+      for (int i = 1; i <= kT1Size; ++i) {
+        costs.push_back(del_cost(i));
+      }
+    } else {
+      for (int j = 1; j <= kT2Size; ++j) {
+        costs.push_back(ins_cost(j));
+      }
+    }
+    const std::size_t kForced = std::abs(kT1Size - kT2Size);
+    std::nth_element(costs.begin(), costs.begin() + kForced, costs.end());
+    for (std::size_t k = 0; k < kForced; ++k) {
+      result.lower += costs[k];
+    }
+  }
+
+  // The completed source key roots know the distance of every subtree on
+  // their left paths to the whole destination tree. Mapping such a subtree
+  // and deleting all other source nodes is an edit mapping. By the triangle
+  // inequality, the distance is at least that subtree distance minus the
+  // cost of inserting the other source nodes, if the costs are a metric.
+  const double kIns = Traits::kInsertCost;
+  const bool kMetric = Traits::kConstantCosts &&
+      Traits::kRenameCost <= Traits::kDeleteCost + Traits::kInsertCost;
+  std::vector<int> path;
+  for (std::size_t k = 0; k < completed_key_roots; ++k) {
+    left_path(t1_.llds(), t1_kr_[k], path);
+    for (int i : path) {
+      const double kSubtreeDistance = td_.at(i, kT2Size);
+      const int kLld = t1_.lld(i);
+      result.upper = std::min(result.upper, kSubtreeDistance +
+          del_prefix[kT1Size] - (del_prefix[i] - del_prefix[kLld - 1]));
+      if (kMetric) {
+        result.lower = std::max(result.lower, kSubtreeDistance -
+            (kT1Size - (i - kLld + 1)) * kIns);
+      }
+    }
+  }
+  result.lower = std::min(result.lower, result.upper);
+  return result;
+}
+
+template <typename Label, typename CostModel>
+std::vector<typename Algorithm<Label, CostModel>::SubtreeMatch>
+Algorithm<Label, CostModel>::search_subtrees(const node::Node<Label>& query,
+                                             const node::Node<Label>& document,
+                                             double threshold,
+                                             const NodeFilter& filter) {
+  index_trees(query, document);
+  const int kT1Size = t1_.size();
+  const int kT2Size = t2_.size();
+  // A subtree larger than the query needs at least the size difference of
+  // insertions, a smaller one as many deletions.
+  double min_del = del_cost(1);
+  for (int i = 2; i <= kT1Size; ++i) {
+    min_del = std::min<double>(min_del, del_cost(i));
+  }
+  double min_ins = ins_cost(1);
+  for (int j = 2; j <= kT2Size; ++j) {
+    min_ins = std::min<double>(min_ins, ins_cost(j));
+  }
+  std::vector<bool> candidate(kT2Size + 1, false);
+  for (int j = 1; j <= kT2Size; ++j) {
+    const int kSize = j - t2_.lld(j) + 1;
+    const double kBound = kSize > kT1Size ? (kSize - kT1Size) * min_ins
+                                          : (kT1Size - kSize) * min_del;
+    candidate[j] = kBound <= threshold && (!filter || filter(t2_.node(j)));
+  }
+  compute_subtree_distances(candidate);
+
+  std::vector<SubtreeMatch> matches;
+  for (int j = 1; j <= kT2Size; ++j) {
+    if (candidate[j] && td_.at(kT1Size, j) <= threshold) {
+      matches.push_back({j, static_cast<double>(td_.at(kT1Size, j))});
+    }
+  }
+  std::sort(matches.begin(), matches.end(),
+            [](const SubtreeMatch& a, const SubtreeMatch& b) {
+              return a.distance < b.distance ||
+                     (a.distance == b.distance && a.node < b.node);
+            });
+  return matches;
+}
+
+template <typename Label, typename CostModel>
+std::vector<typename Algorithm<Label, CostModel>::SubtreeMatch>
+Algorithm<Label, CostModel>::search_top_subtrees(
+    const node::Node<Label>& query, const node::Node<Label>& document, int k,
+    const NodeFilter& filter) {
+  index_trees(query, document);
+  const int kT1Size = t1_.size();
+  const int kT2Size = t2_.size();
+  std::vector<bool> candidate(kT2Size + 1, false);
+  for (int j = 1; j <= kT2Size; ++j) {
+    candidate[j] = !filter || filter(t2_.node(j));
+  }
+  compute_subtree_distances(candidate);
+
+  std::vector<SubtreeMatch> matches;
+  for (int j = 1; j <= kT2Size; ++j) {
+    if (candidate[j]) {
+      matches.push_back({j, static_cast<double>(td_.at(kT1Size, j))});
+    }
+  }
+  auto closer = [](const SubtreeMatch& a, const SubtreeMatch& b) {
+    return a.distance < b.distance ||
+           (a.distance == b.distance && a.node < b.node);
+  };
+  const std::size_t kCount =
+      std::min<std::size_t>(std::max(k, 0), matches.size());
+  std::partial_sort(matches.begin(), matches.begin() + kCount, matches.end(),
+                    closer);
+  matches.resize(kCount);
+  return matches;
+}
+
+template <typename Label, typename CostModel>
+void Algorithm<Label, CostModel>::compute_subtree_distances(
+    const std::vector<bool>& candidate) {
+  // A key root reads the subtree distances of all destination nodes of its
+  // subforests up to its last node. These nodes are needed from the smaller
+  // key roots on whose left paths they are, thus larger key roots first.
+  std::vector<bool> needed(candidate);
+  std::vector<int> t2_last(t2_kr_.size(), 0);
+  for (std::size_t k2 = t2_kr_.size(); k2-- > 0;) {
+    const int kr2 = t2_kr_[k2];
+    const int kKr2Lld = t2_.lld(kr2);
+    int last2 = 0;
+    for (int j = kKr2Lld; j <= kr2; ++j) {
+      if (t2_.lld(j) == kKr2Lld && needed[j]) {
+        last2 = j;
+      }
+    }
+    for (int j = kKr2Lld; j <= last2; ++j) {
+      needed[j] = true;
+    }
+    t2_last[k2] = last2;
+  }
+
+  for (int kr1 : t1_kr_) {
+    for (std::size_t k2 = 0; k2 < t2_kr_.size(); ++k2) {
+      if (t2_last[k2] != 0) {
+        forest_distance(kr1, t2_kr_[k2], t2_last[k2], ConstantCosts());
+      }
+    }
+  }
+  td_incomplete_ = true;
+}
+
+template <typename Label, typename CostModel>
+void Algorithm<Label, CostModel>::index_subtrees(std::true_type) {
+  std::unordered_map<std::vector<int>, int, data_structures::IntSequenceHash>
+      subtrees;
+  std::vector<int> key;
+  // Nodes are visited in postorder, thus children ids are known. The key of
+  // a node is its label id followed by the ids of its children.
+  auto assign_ids = [&](const tree_index::TreeIndex<Label>& t,
+                        const std::vector<int>& label_ids,
+                        std::vector<int>& ids) {
+    ids.resize(t.size());
+    for (int j = 1; j <= t.size(); ++j) {
+      key.clear();
+      key.push_back(label_ids[j - 1]);
+      for (int k = t.children_count(j) - 1; k >= 0; --k) {
+        key.push_back(ids[t.child(j, k) - 1]);
+      }
+      ids[j - 1] = subtrees.emplace(key, subtrees.size()).first->second;
+    }
+  };
+  if (t1_.dag() != nullptr && t1_.dag() == t2_.dag()) {
+    // The DAG shares exactly the identical subtrees.
+    t1_subtree_id_ = t1_.dag_ids();
+    t2_subtree_id_ = t2_.dag_ids();
+  } else {
+    assign_ids(t1_, t1_label_id_, t1_subtree_id_);
+    assign_ids(t2_, t2_label_id_, t2_subtree_id_);
+  }
+
+  // The ids above are valid within this computation only. The cache needs
+  // hashes of the labels themselves, combined in the same Merkle-style way.
+  auto assign_hashes = [&](const tree_index::TreeIndex<Label>& t,
+                           std::vector<std::uint64_t>& hashes) {
+    hashes.resize(t.size());
+    for (int j = 1; j <= t.size(); ++j) {
+      std::uint64_t h = data_structures::mix_hash(
+          std::hash<Label>()(t.node(j).label()) +
+          static_cast<std::uint64_t>(j - t.lld(j)));
+      for (int k = t.children_count(j) - 1; k >= 0; --k) {
+        h = data_structures::mix_hash(h + hashes[t.child(j, k) - 1]);
+      }
+      hashes[j - 1] = h;
+    }
+  };
+  if (cache_) {
+    assign_hashes(t1_, t1_subtree_hash_);
+    assign_hashes(t2_, t2_subtree_hash_);
+  } else {
+    t1_subtree_hash_.clear();
+    t2_subtree_hash_.clear();
+  }
+
+  // Identical subtrees have equal sizes, thus a twin is never an ancestor.
+  auto find_twins = [](const std::vector<int>& kr, const std::vector<int>& ids,
+                       std::vector<int>& twins) {
+    std::unordered_map<int, int> first_kr;
+    twins.assign(kr.size(), 0);
+    for (std::size_t k = 0; k < kr.size(); ++k) {
+      auto inserted = first_kr.emplace(ids[kr[k] - 1], kr[k]);
+      if (!inserted.second) {
+        twins[k] = inserted.first->second;
+      }
+    }
+  };
+  find_twins(t1_kr_, t1_subtree_id_, t1_kr_twin_);
+  find_twins(t2_kr_, t2_subtree_id_, t2_kr_twin_);
+}
+
+template <typename Label, typename CostModel>
+void Algorithm<Label, CostModel>::index_subtrees(std::false_type) {
+  t1_subtree_id_.clear();
+  t2_subtree_id_.clear();
+  t1_subtree_hash_.clear();
+  t2_subtree_hash_.clear();
+  t1_kr_twin_.clear();
+  t2_kr_twin_.clear();
+}
+
+template <typename Label, typename CostModel>
+void Algorithm<Label, CostModel>::left_path(const std::vector<int>& lld,
+                                            int kr,
+                                            std::vector<int>& path) const {
+  path.clear();
+  for (int i = lld[kr - 1]; i <= kr; ++i) {
+    if (lld[i - 1] == lld[kr - 1]) {
+      path.push_back(i);
+    }
+  }
+}
+
+template <typename Label, typename CostModel>
+void Algorithm<Label, CostModel>::copy_subtree_distances(
+    const std::vector<int>& path1, const std::vector<int>& path2,
+    int shift1, int shift2) {
+  for (int i : path1) {
+    for (int j : path2) {
+      td_.at(i, j) = td_.at(i - shift1, j - shift2);
+    }
+  }
+}
+
+template <typename Label, typename CostModel>
+void Algorithm<Label, CostModel>::cached_forest_distance(
+    int kr1, int kr2, std::vector<int>& path1, std::vector<int>& path2) {
+  const long long kCells =
+      static_cast<long long>(kr1 - t1_.lld(kr1) + 2) *
+      (kr2 - t2_.lld(kr2) + 2);
+  if (kCells < cache_->get_min_cells()) {
+    forest_distance(kr1, kr2);
+    return;
+  }
+  // A block stores the subtree distances of the left paths in row-major
+  // order.
+  left_path(t1_.llds(), kr1, path1);
+  left_path(t2_.llds(), kr2, path2);
+  const std::uint64_t kHash1 = t1_subtree_hash_[kr1 - 1];
+  const std::uint64_t kHash2 = t2_subtree_hash_[kr2 - 1];
+  if (cache_->lookup(kHash1, kHash2, block_) &&
+      block_.size() == path1.size() * path2.size()) {
+    auto cell = block_.begin();
+    for (int i : path1) {
+      for (int j : path2) {
+        td_.at(i, j) = *cell++;
+      }
+    }
+#ifdef TREE_SIMILARITY_STATISTICS
+    ++stats_.cache_hits;
+#endif
+    return;
+  }
+  forest_distance(kr1, kr2);
+  block_.clear();
+  for (int i : path1) {
+    for (int j : path2) {
+      block_.push_back(td_.at(i, j));
     }
   }
+  cache_->insert(kHash1, kHash2, block_);
+}
+
+template <typename Label, typename CostModel>
+void Algorithm<Label, CostModel>::set_cache(std::shared_ptr<Cache> cache) {
+  cache_ = cache;
+}
+
+template <typename Label, typename CostModel>
+double Algorithm<Label, CostModel>::zhang_shasha_ted_update(
+    const node::Node<Label>& t2, const std::vector<int>& changed_subtrees) {
+  if (t1_.size() == 0 || t2_.size() == 0) {
+    return -1;
+  }
+  const node::Node<Label>& t1 = t1_.node(t1_.size());
+  if (identical_trees_ || td_incomplete_ || !LabelOnlyCosts::value) {
+    // The subtree distances of the previous computation are not known, or
+    // the labels of the previous destination tree are not kept.
+    return zhang_shasha_ted(t1, t2);
+  }
+
+#ifdef TREE_SIMILARITY_STATISTICS
+  stats_ = Statistics();
+  auto indexing_start = std::chrono::steady_clock::now();
+#endif
+
+  const int kT1Size = t1_.size();
+  const int kOldT2Size = t2_.size();
+  std::vector<bool> changed(kOldT2Size + 1, false);
+  for (int j : changed_subtrees) {
+    if (j < 1 || j > kOldT2Size) {
+      return zhang_shasha_ted(t1, t2);
+    }
+    changed[j] = true;
+  }
+
+  // Index the new destination tree and find its unchanged subtrees. The new
+  // labels are interned in the dictionary of the previous computation, such
+  // that equal labels of both destination trees have equal ids.
+  const tree_index::TreeIndex<Label> old_t2 = std::move(t2_);
+  const std::vector<int> old_label_id = std::move(t2_label_id_);
+  t2_.index(t2);
+  t2_.key_roots(t2_kr_);
+  intern_labels(false, LabelOnlyCosts());
+  const int kT2Size = t2_.size();
+  std::vector<int> old_of_new(kT2Size + 1, 0);
+  if (!match_unchanged(kT2Size, kOldT2Size, old_t2, old_label_id, changed,
+                       old_of_new)) {
+    return zhang_shasha_ted(t1, t2);
+  }
+  compute_costs(ConstantCosts());
+  index_subtrees(std::false_type());
+
+  // Subtree distances to an unchanged destination subtree stay the same.
+  data_structures::Matrix<CostType, data_structures::AlignedMatrixPolicy> td(kT1Size+1, kT2Size+1);
+  for (int j = 1; j <= kT2Size; ++j) {
+    if (old_of_new[j] != 0) {
+      for (int i = 1; i <= kT1Size; ++i) {
+        td.at(i, j) = td_.at(i, old_of_new[j]);
+      }
+    }
+  }
+  td_ = std::move(td);
+  fd_.resize(kT1Size+1, kT2Size+1);
+
+#ifdef TREE_SIMILARITY_STATISTICS
+  auto dp_start = std::chrono::steady_clock::now();
+  stats_.indexing_time_ms = std::chrono::duration<double, std::milli>(
+      dp_start - indexing_start).count();
+  stats_.t1_size = kT1Size;
+  stats_.t2_size = kT2Size;
+  stats_.t1_key_roots = t1_kr_.size();
+  stats_.t2_key_roots = t2_kr_.size();
+  stats_.matrix_bytes = matrix_bytes();
+#endif
+
+  // A changed destination node is on the left path of a changed key root.
+  // Key roots are visited in ascending postorder in the outer loop, such
+  // that every subtree distance read by forest_distance is already known.
+  for (auto kr2 : t2_kr_) {
+    if (old_of_new[kr2] == 0) {
+      for (auto kr1 : t1_kr_) {
+        forest_distance(kr1, kr2);
+      }
+    }
+  }
+
+#ifdef TREE_SIMILARITY_STATISTICS
+  stats_.dp_time_ms = std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - dp_start).count();
+#endif
 
   return td_.at(kT1Size, kT2Size);
 }
 
+template <typename Label, typename CostModel>
+bool Algorithm<Label, CostModel>::match_unchanged(
+    int j_new, int j_old, const tree_index::TreeIndex<Label>& old_t2,
+    const std::vector<int>& old_label_id, const std::vector<bool>& changed,
+    std::vector<int>& old_of_new) const {
+  if (changed[j_old]) {
+    return true;
+  }
+  const int kChildren = t2_.children_count(j_new);
+  if (kChildren != old_t2.children_count(j_old) ||
+      t2_label_id_[j_new - 1] != old_label_id[j_old - 1]) {
+    return false;
+  }
+  bool unchanged = true;
+  for (int k = 0; k < kChildren; ++k) {
+    const int kChildNew = t2_.child(j_new, k);
+    if (!match_unchanged(kChildNew, old_t2.child(j_old, k), old_t2,
+                         old_label_id, changed, old_of_new)) {
+      return false;
+    }
+    unchanged = unchanged && old_of_new[kChildNew] != 0;
+  }
+  if (unchanged) {
+    old_of_new[j_new] = j_old;
+  }
+  return true;
+}
+
+template <typename Label, typename CostModel>
+void Algorithm<Label, CostModel>::intern_labels(bool with_source,
+                                                std::true_type) {
+  if (with_source) {
+    labels_.clear();
+    t1_label_id_.clear();
+    for (int i = 1; i <= t1_.size(); ++i) {
+      t1_label_id_.push_back(labels_.insert(t1_.node(i).label()));
+    }
+  }
+  t2_label_id_.clear();
+  for (int j = 1; j <= t2_.size(); ++j) {
+    t2_label_id_.push_back(labels_.insert(t2_.node(j).label()));
+  }
+}
+
+template <typename Label, typename CostModel>
+void Algorithm<Label, CostModel>::intern_labels(bool, std::false_type) {
+  t1_label_id_.clear();
+  t2_label_id_.clear();
+}
+
+template <typename Label, typename CostModel>
+void Algorithm<Label, CostModel>::compute_costs(std::true_type) {}
+
+template <typename Label, typename CostModel>
+void Algorithm<Label, CostModel>::compute_costs(std::false_type) {
+  t1_del_.clear();
+  t2_ins_.clear();
+  // Costs of a node do not change, compute them once instead of per cell.
+  for (int i = 1; i <= t1_.size(); ++i) {
+    t1_del_.push_back(c_.del(t1_.node(i)));
+  }
+  for (int j = 1; j <= t2_.size(); ++j) {
+    t2_ins_.push_back(c_.ins(t2_.node(j)));
+  }
+  compute_rename_costs(LabelBasedCosts());
+}
+
+template <typename Label, typename CostModel>
+void Algorithm<Label, CostModel>::compute_rename_costs(std::true_type) {
+  // The source labels were interned first, thus they have the ids 0 to
+  // kT1Labels-1. Every pair of nodes is renamed in some subtree pair, thus
+  // every pair of a source label and a destination label is needed.
+  const int kT1Labels = t1_label_id_.empty() ? 0 :
+      *std::max_element(t1_label_id_.begin(), t1_label_id_.end()) + 1;
+  ren_.resize(kT1Labels, labels_.size());
+  std::vector<bool> computed(labels_.size(), false);
+  for (int b : t2_label_id_) {
+    if (computed[b]) {
+      continue;
+    }
+    computed[b] = true;
+    for (int a = 0; a < kT1Labels; ++a) {
+      ren_.at(a, b) = c_.ren(labels_.label(a), labels_.label(b));
+    }
+  }
+}
+
+template <typename Label, typename CostModel>
+void Algorithm<Label, CostModel>::compute_rename_costs(std::false_type) {}
+
+template <typename Label, typename CostModel>
+typename Algorithm<Label, CostModel>::CostType
+Algorithm<Label, CostModel>::ren_cost(int i, int j, std::true_type) const {
+  return ren_.at(t1_label_id_[i - 1], t2_label_id_[j - 1]);
+}
+
+template <typename Label, typename CostModel>
+typename Algorithm<Label, CostModel>::CostType
+Algorithm<Label, CostModel>::ren_cost(int i, int j, std::false_type) const {
+  return c_.ren(t1_.node(i), t2_.node(j));
+}
+
+template <typename Label, typename CostModel>
+typename Algorithm<Label, CostModel>::CostType
+Algorithm<Label, CostModel>::del_cost(int i) const {
+  if (Traits::kConstantCosts) {
+    const CostType kDel = Traits::kDeleteCost;
+    return kDel;
+  }
+  return t1_del_[i - 1];
+}
+
+template <typename Label, typename CostModel>
+typename Algorithm<Label, CostModel>::CostType
+Algorithm<Label, CostModel>::ins_cost(int j) const {
+  if (Traits::kConstantCosts) {
+    const CostType kIns = Traits::kInsertCost;
+    return kIns;
+  }
+  return t2_ins_[j - 1];
+}
+
+template <typename Label, typename CostModel>
+typename Algorithm<Label, CostModel>::CostType
+Algorithm<Label, CostModel>::ren_cost(int i, int j) const {
+  if (Traits::kConstantCosts) {
+    const CostType kRen = Traits::kRenameCost;
+    return t1_label_id_[i - 1] == t2_label_id_[j - 1] ? 0 : kRen;
+  }
+  return ren_cost(i, j, LabelBasedCosts());
+}
+
 template <typename Label, typename CostModel>
 void Algorithm<Label, CostModel>::forest_distance(
     int kr1,
     int kr2) {
-  const int kKr1Lld = t1_lld_[kr1 - 1]; // See declaration of t1_lld_.
-  const int kKr2Lld = t2_lld_[kr2 - 1];
+  forest_distance(kr1, kr2, kr2, ConstantCosts());
+}
+
+template <typename Label, typename CostModel>
+void Algorithm<Label, CostModel>::forest_distance(
+    int kr1,
+    int kr2,
+    int last2,
+    std::false_type) {
+  const int kKr1Lld = t1_.lld(kr1);
+  const int kKr2Lld = t2_.lld(kr2);
   const int kT1Empty = kKr1Lld - 1;
   const int kT2Empty = kKr2Lld - 1;
+#ifdef TREE_SIMILARITY_STATISTICS
+  ++stats_.forest_distance_calls;
+  stats_.cells_computed += static_cast<long long>(kr1 - kT1Empty) *
+                           (last2 - kT2Empty);
+#endif
   // Distance between two empty forests.
-  fd_.at(kT1Empty, kT2Empty) = 0.0;
+  fd_.at(kT1Empty, kT2Empty) = 0;
 
   // Distances between a source forest and an empty forest.
   for (int i = kKr1Lld; i <= kr1; ++i) {
-    fd_.at(i, kT2Empty) = fd_.at(i - 1, kT2Empty) + c_.del(t1_node_[i - 1]);
-    // For t1_node_[i - 1] see declaration of t1_node_.
+    fd_.at(i, kT2Empty) = fd_.at(i - 1, kT2Empty) + t1_del_[i - 1];
+    // For t1_del_[i - 1] see declaration of t1_del_.
   }
 
   // Distances between a destination forest and an empty forest.
-  for (int j = kKr2Lld; j <= kr2; ++j) {
-    fd_.at(kT1Empty, j) = fd_.at(kT1Empty, j - 1) + c_.ins(t2_node_[j - 1]);
+  for (int j = kKr2Lld; j <= last2; ++j) {
+    fd_.at(kT1Empty, j) = fd_.at(kT1Empty, j - 1) + t2_ins_[j - 1];
   }
 
   // Distances between non-empty forests.
   for (int i = kKr1Lld; i <= kr1; ++i) {
-    for (int j = kKr2Lld; j <= kr2; ++j) {
+    for (int j = kKr2Lld; j <= last2; ++j) {
       // If we have two subtrees.
-      if (t1_lld_[i - 1] == kKr1Lld && t2_lld_[j - 1] == kKr2Lld) {
+      if (t1_.lld(i) == kKr1Lld && t2_.lld(j) == kKr2Lld) {
         fd_.at(i, j) = std::min(
-            {fd_.at(i - 1, j) + c_.del(t1_node_[i - 1]), // Delete root node in source subtree.
-             fd_.at(i, j - 1) + c_.ins(t2_node_[j - 1]), // Insert root node in destination subtree.
-             fd_.at(i - 1, j - 1) + c_.ren(t1_node_[i - 1], t2_node_[j - 1])}); // Rename the root nodes.
+            {fd_.at(i - 1, j) + t1_del_[i - 1], // Delete root node in source subtree.
+             fd_.at(i, j - 1) + t2_ins_[j - 1], // Insert root node in destination subtree.
+             fd_.at(i - 1, j - 1) + ren_cost(i, j, LabelBasedCosts())}); // Rename the root nodes.
         td_.at(i, j) = fd_.at(i, j);
       } else { // We have two forests.
         fd_.at(i, j) = std::min(
-            {fd_.at(i - 1, j) + c_.del(t1_node_[i - 1]), // Delete rightmost root node in source subforest.
-             fd_.at(i, j - 1) + c_.ins(t2_node_[j - 1]), // Insert rightmost root node in destination subforest.
-             fd_.at(t1_lld_[i - 1] - 1, t2_lld_[j - 1] - 1) + td_.at(i, j)}); // Delete the rightmost subtrees + keep the rightmost subtrees.
+            {fd_.at(i - 1, j) + t1_del_[i - 1], // Delete rightmost root node in source subforest.
+             fd_.at(i, j - 1) + t2_ins_[j - 1], // Insert rightmost root node in destination subforest.
+             fd_.at(t1_.lld(i) - 1, t2_.lld(j) - 1) + td_.at(i, j)}); // Delete the rightmost subtrees + keep the rightmost subtrees.
       }
       // std::cout << "--- fd[" << i << "][" << j << "] = " << fd_.at(i, j) << std::endl;
     }
@@ -207,13 +847,142 @@ void Algorithm<Label, CostModel>::forest_distance(
   // std::cout << "--- td[" << kr1 << "][" << kr2 << "] = " << td_.at(kr1, kr2) << std::endl;
 }
 
+template <typename Label, typename CostModel>
+void Algorithm<Label, CostModel>::forest_distance(
+    int kr1,
+    int kr2,
+    int last2,
+    std::true_type) {
+  const cost_model::ConstantCostValues<CostModel> kCosts;
+  const CostType kDel = kCosts.del;
+  const CostType kIns = kCosts.ins;
+  const CostType kRen = kCosts.ren;
+  const int kKr1Lld = t1_.lld(kr1);
+  const int kKr2Lld = t2_.lld(kr2);
+  const int kT1Empty = kKr1Lld - 1;
+  const int kT2Empty = kKr2Lld - 1;
+#ifdef TREE_SIMILARITY_STATISTICS
+  ++stats_.forest_distance_calls;
+  stats_.cells_computed += static_cast<long long>(kr1 - kT1Empty) *
+                           (last2 - kT2Empty);
+#endif
+  // Distances between a forest and an empty forest (including two empty
+  // forests) depend only on the number of nodes.
+  for (int i = kT1Empty; i <= kr1; ++i) {
+    fd_.at(i, kT2Empty) = (i - kT1Empty) * kDel;
+  }
+  for (int j = kKr2Lld; j <= last2; ++j) {
+    fd_.at(kT1Empty, j) = (j - kT2Empty) * kIns;
+  }
+
+  // Distances between non-empty forests.
+  for (int i = kKr1Lld; i <= kr1; ++i) {
+    const int kILld = t1_.lld(i);
+    const int kILabel = t1_label_id_[i - 1];
+    for (int j = kKr2Lld; j <= last2; ++j) {
+      // If we have two subtrees.
+      if (kILld == kKr1Lld && t2_.lld(j) == kKr2Lld) {
+        fd_.at(i, j) = std::min(
+            {fd_.at(i - 1, j) + kDel, // Delete root node in source subtree.
+             fd_.at(i, j - 1) + kIns, // Insert root node in destination subtree.
+             fd_.at(i - 1, j - 1) + (kILabel == t2_label_id_[j - 1] ? 0 : kRen)}); // Rename the root nodes.
+        td_.at(i, j) = fd_.at(i, j);
+      } else { // We have two forests.
+        fd_.at(i, j) = std::min(
+            {fd_.at(i - 1, j) + kDel, // Delete rightmost root node in source subforest.
+             fd_.at(i, j - 1) + kIns, // Insert rightmost root node in destination subforest.
+             fd_.at(kILld - 1, t2_.lld(j) - 1) + td_.at(i, j)}); // Delete the rightmost subtrees + keep the rightmost subtrees.
+      }
+    }
+  }
+}
+
+template <typename Label, typename CostModel>
+const typename Algorithm<Label, CostModel>::EditMapping
+Algorithm<Label, CostModel>::compute_edit_mapping() {
+  EditMapping mapping;
+  if (t1_.size() == 0 || t2_.size() == 0 || td_incomplete_) {
+    return mapping;
+  }
+  if (identical_trees_) {
+    for (int i = 1; i <= t1_.size(); ++i) {
+      mapping.matched.emplace_back(i, i);
+    }
+    return mapping;
+  }
+  // forest_distance counts its work, but the statistics describe
+  // zhang_shasha_ted only.
+  const Statistics kStats = stats_;
+
+  // Subtree pairs whose subforest distances must be backtracked.
+  std::vector<std::pair<int, int>> tree_pairs;
+  tree_pairs.emplace_back(t1_.size(), t2_.size());
+  while (!tree_pairs.empty()) {
+    const int kRoot1 = tree_pairs.back().first;
+    const int kRoot2 = tree_pairs.back().second;
+    tree_pairs.pop_back();
+    const int kRoot1Lld = t1_.lld(kRoot1);
+    const int kRoot2Lld = t2_.lld(kRoot2);
+    const int kT1Empty = kRoot1Lld - 1;
+    const int kT2Empty = kRoot2Lld - 1;
+
+    // Recompute subforest distances of this subtree pair. Overwrites td
+    // entries of the subtree pairs on its left paths with the same values.
+    forest_distance(kRoot1, kRoot2);
+
+    // Follow the decisions of the recurrence from the full subtrees back to
+    // two empty forests. The equalities hold exactly, the values are
+    // recomputed with the same operations.
+    int i = kRoot1;
+    int j = kRoot2;
+    while (i > kT1Empty || j > kT2Empty) {
+      if (i == kT1Empty) {
+        mapping.inserted.push_back(j--);
+      } else if (j == kT2Empty) {
+        mapping.deleted.push_back(i--);
+      } else if (fd_.at(i, j) == fd_.at(i - 1, j) + del_cost(i)) {
+        mapping.deleted.push_back(i--);
+      } else if (fd_.at(i, j) == fd_.at(i, j - 1) + ins_cost(j)) {
+        mapping.inserted.push_back(j--);
+      } else if (t1_.lld(i) == kRoot1Lld && t2_.lld(j) == kRoot2Lld) {
+        // Two subtrees, their roots are mapped.
+        if (ren_cost(i, j) == 0) {
+          mapping.matched.emplace_back(i, j);
+        } else {
+          mapping.renamed.emplace_back(i, j);
+        }
+        --i;
+        --j;
+      } else {
+        // Two forests, their rightmost subtrees are mapped to each other.
+        // Their mapping is recovered from their own subforest distances.
+        tree_pairs.emplace_back(i, j);
+        const int kILld = t1_.lld(i);
+        j = t2_.lld(j) - 1;
+        i = kILld - 1;
+      }
+    }
+  }
+
+  stats_ = kStats;
+  return mapping;
+}
+
 template <typename Label, typename CostModel>
 const typename Algorithm<Label, CostModel>::TestItems Algorithm<Label, CostModel>::get_test_items() const {
   TestItems test_items = {
     t1_kr_,
-    t1_lld_,
+    t1_.llds(),
+    t2_.llds(),
+    matrix_bytes(),
   };
   return test_items;
 }
 
+template <typename Label, typename CostModel>
+const typename Algorithm<Label, CostModel>::Statistics&
+Algorithm<Label, CostModel>::get_statistics() const {
+  return stats_;
+}
+
 #endif // TREE_SIMILARITY_ZHANG_SHASHA_ZHANG_SHASHA_IMPL_H
@@ -0,0 +1,145 @@
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+#include <fstream>
+#include "unit_cost_model.h"
+#include "string_label.h"
+#include "node.h"
+#include "bracket_notation_parser.h"
+#include "zhang_shasha.h"
+#include "duplicate_classes.h"
+
+int main() {
+
+  using Label = label::StringLabel;
+  using CostModel = cost_model::UnitCostModel<Label>;
+
+  // Parse test cases from file. Their trees form the collection.
+  std::ifstream test_cases_file("ted_test_data.txt");
+  if (!test_cases_file.is_open()) {
+    std::cerr << "Error while opening file." << std::endl;
+    return -1;
+  }
+  std::vector<std::string> tree_strings;
+  for (std::string line; std::getline( test_cases_file, line);) {
+    if (line[0] == '#') {
+      std::getline(test_cases_file, line);
+      tree_strings.push_back(line);
+      std::getline(test_cases_file, line);
+      tree_strings.push_back(line);
+      std::getline(test_cases_file, line);
+    }
+  }
+
+  // Add more duplicates: every third tree once more, the first tree twice.
+  const std::size_t kParsed = tree_strings.size();
+  for (std::size_t t = 0; t < kParsed; t += 3) {
+    tree_strings.push_back(tree_strings[t]);
+  }
+  tree_strings.push_back(tree_strings[0]);
+  tree_strings.push_back(tree_strings[0]);
+  const std::set<std::string> kDistinct(tree_strings.begin(), tree_strings.end());
+
+  parser::BracketNotationParser bnp;
+  std::vector<node::Node<Label>> trees;
+  for (const std::string& s : tree_strings) {
+    trees.push_back(bnp.parse_string(s));
+  }
+
+  collection::DuplicateClasses<Label> classes;
+  classes.build(trees);
+
+  // Classes are the distinct trees, represented by their first occurrence.
+  auto stats = classes.get_statistics();
+  if (classes.get_class_count() != static_cast<int>(kDistinct.size()) ||
+      stats.trees != static_cast<long long>(trees.size()) ||
+      stats.collapse_ratio != static_cast<double>(trees.size()) / kDistinct.size()) {
+    std::cerr << "Incorrect number of classes: " << classes.get_class_count() << " instead of " << kDistinct.size() << std::endl;
+    return -1;
+  }
+  for (int t = 0; t < static_cast<int>(trees.size()); ++t) {
+    const int kRepresentative = classes.get_representatives()[classes.get_class(t)];
+    if (tree_strings[kRepresentative] != tree_strings[t] || kRepresentative > t) {
+      std::cerr << "Incorrect class of tree " << t << std::endl;
+      return -1;
+    }
+  }
+
+  // Distances are computed between representatives only.
+  zhang_shasha::Algorithm<Label, CostModel> zs_ted;
+  long long distance_calls = 0;
+  auto distance = [&](const node::Node<Label>& t1, const node::Node<Label>& t2) {
+    ++distance_calls;
+    return zs_ted.zhang_shasha_ted(t1, t2);
+  };
+  const long long kClasses = classes.get_class_count();
+
+  data_structures::Matrix<double> distances = classes.distance_matrix(trees, distance);
+  if (distance_calls != kClasses * (kClasses - 1)) {
+    std::cerr << "Incorrect number of distance computations: " << distance_calls << std::endl;
+    return -1;
+  }
+  for (std::size_t i = 0; i < trees.size(); ++i) {
+    for (std::size_t j = 0; j < trees.size(); ++j) {
+      const double kCorrect = zs_ted.zhang_shasha_ted(trees[i], trees[j]);
+      if (distances.at(i, j) != kCorrect) {
+        std::cerr << "Incorrect distance: " << distances.at(i, j) << " instead of " << kCorrect << std::endl;
+        std::cerr << tree_strings[i] << std::endl;
+        std::cerr << tree_strings[j] << std::endl;
+        return -1;
+      }
+    }
+  }
+
+  // The join finds the same pairs as a nested loop.
+  const double kThreshold = 3.0;
+  distance_calls = 0;
+  auto pairs = classes.join(trees, kThreshold, distance);
+  if (distance_calls != kClasses * (kClasses - 1) / 2) {
+    std::cerr << "Incorrect number of join distance computations: " << distance_calls << std::endl;
+    return -1;
+  }
+  std::size_t p = 0;
+  for (int i = 0; i < static_cast<int>(trees.size()); ++i) {
+    for (int j = i + 1; j < static_cast<int>(trees.size()); ++j) {
+      const double kCorrect = zs_ted.zhang_shasha_ted(trees[i], trees[j]);
+      if (kCorrect > kThreshold) {
+        continue;
+      }
+      if (p == pairs.size() || pairs[p].tree1 != i || pairs[p].tree2 != j ||
+          pairs[p].distance != kCorrect) {
+        std::cerr << "Missing join pair: " << i << ", " << j << std::endl;
+        return -1;
+      }
+      ++p;
+    }
+  }
+  if (p != pairs.size()) {
+    std::cerr << "Too many join pairs: " << pairs.size() << " instead of " << p << std::endl;
+    return -1;
+  }
+
+  // A join at distance 0 finds the pairs within the classes, a negative
+  // threshold none.
+  std::size_t duplicate_pairs = 0;
+  for (int c = 0; c < kClasses; ++c) {
+    const std::size_t kMembers = classes.get_members(c).size();
+    duplicate_pairs += kMembers * (kMembers - 1) / 2;
+  }
+  pairs = classes.join(trees, 0.0, distance);
+  if (pairs.size() != duplicate_pairs || duplicate_pairs == 0 ||
+      !classes.join(trees, -1.0, distance).empty()) {
+    std::cerr << "Incorrect number of duplicate pairs: " << pairs.size() << " instead of " << duplicate_pairs << std::endl;
+    return -1;
+  }
+  for (const auto& pair : pairs) {
+    if (classes.get_class(pair.tree1) != classes.get_class(pair.tree2) ||
+        pair.tree1 >= pair.tree2) {
+      std::cerr << "Incorrect duplicate pair: " << pair.tree1 << ", " << pair.tree2 << std::endl;
+      return -1;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,40 @@
+#include <iostream>
+#include <string>
+#include <fstream>
+#include "string_edit_distance_cost_model.h"
+
+int main() {
+
+  // Parse test cases from file.
+  std::ifstream test_cases_file("string_edit_distance_test_data.txt");
+  if (!test_cases_file.is_open()) {
+    std::cerr << "Error while opening file." << std::endl;
+    return -1;
+  }
+
+  // Read test cases from a file line by line.
+  for (std::string line; std::getline( test_cases_file, line);) {
+    if (line[0] == '#') {
+      // Read the single test case.
+      std::getline(test_cases_file, line);
+      std::string input_string_1 = line;
+      std::getline(test_cases_file, line);
+      std::string input_string_2 = line;
+      std::getline(test_cases_file, line);
+      int correct_result = std::stoi(line);
+
+      // Execute the algorithm in both directions.
+      int computed_result_12 = cost_model::string_edit_distance(input_string_1, input_string_2);
+      int computed_result_21 = cost_model::string_edit_distance(input_string_2, input_string_1);
+
+      if (correct_result != computed_result_12 || correct_result != computed_result_21) {
+        std::cerr << "Incorrect string edit distance: " << computed_result_12 << ", " << computed_result_21 << " instead of " << correct_result << std::endl;
+        std::cerr << input_string_1 << std::endl;
+        std::cerr << input_string_2 << std::endl;
+        return -1;
+      }
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,163 @@
+#include <cstdint>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <vector>
+#include "aligned_allocator.h"
+#include "matrix.h"
+
+using data_structures::AlignedAllocator;
+using data_structures::AlignedMatrixPolicy;
+using data_structures::DefaultMatrixPolicy;
+using data_structures::Matrix;
+
+/// Element whose size does not divide the cache line.
+struct ThreeBytes {
+  char bytes[3];
+};
+
+/// Returns true if a pointer is aligned to a cache line.
+bool aligned(const void* p) {
+  return reinterpret_cast<std::uintptr_t>(p) %
+         AlignedAllocator<char>::kAlignment == 0;
+}
+
+/// Returns the row stride of a matrix from the addresses of its elements.
+template <typename Matrix>
+std::ptrdiff_t stride(Matrix& m) {
+  return &m.at(1, 0) - &m.at(0, 0);
+}
+
+/// Allocates blocks of a number of elements, checks their alignment, writes
+/// them, and frees them again.
+///
+/// \param n Number of elements.
+/// \param zeroed True if the block must be zeroed, i.e., mapped.
+/// \return True if the blocks are aligned, zeroed if required, and writable.
+template <typename T>
+bool allocate_blocks(std::size_t n, bool zeroed) {
+  AlignedAllocator<T> allocator;
+  for (int round = 0; round < 3; ++round) {
+    T* p = allocator.allocate(n);
+    if (!aligned(p)) {
+      std::cerr << "Block of " << n * sizeof(T) << " bytes is not aligned." << std::endl;
+      return false;
+    }
+    for (std::size_t e = 0; e < n; e += 512) {
+      if (zeroed && p[e] != T()) {
+        std::cerr << "Mapped block of " << n * sizeof(T) << " bytes is not zeroed." << std::endl;
+        return false;
+      }
+      p[e] = T(1);
+    }
+    p[n - 1] = T(1);
+    allocator.deallocate(p, n);
+  }
+  return true;
+}
+
+int main() {
+
+  // Rows under 4 KB are not padded.
+  if (AlignedMatrixPolicy::row_stride<double>(1) != 1 ||
+      AlignedMatrixPolicy::row_stride<double>(511) != 511 ||
+      AlignedMatrixPolicy::row_stride<int>(1023) != 1023 ||
+      AlignedMatrixPolicy::row_stride<char>(4095) != 4095 ||
+      DefaultMatrixPolicy::row_stride<double>(512) != 512) {
+    std::cerr << "Short rows must not be padded." << std::endl;
+    return -1;
+  }
+  // Longer rows are rounded up to cache lines, page multiples get another one.
+  if (AlignedMatrixPolicy::row_stride<double>(513) != 520 ||
+      AlignedMatrixPolicy::row_stride<double>(1000) != 1000 ||
+      AlignedMatrixPolicy::row_stride<double>(1001) != 1008 ||
+      AlignedMatrixPolicy::row_stride<double>(512) != 520 ||
+      AlignedMatrixPolicy::row_stride<double>(1024) != 1032 ||
+      AlignedMatrixPolicy::row_stride<int>(1024) != 1040 ||
+      AlignedMatrixPolicy::row_stride<int>(1030) != 1040) {
+    std::cerr << "Incorrect padding of long rows." << std::endl;
+    return -1;
+  }
+  // Elements not dividing a cache line are never padded.
+  if (AlignedMatrixPolicy::row_stride<ThreeBytes>(2000) != 2000) {
+    std::cerr << "Rows of odd-sized elements must not be padded." << std::endl;
+    return -1;
+  }
+
+  // Heap blocks and mapped blocks, including exactly the mapping threshold.
+  const std::size_t kMapElements =
+      AlignedAllocator<double>::kMapThreshold / sizeof(double);
+  for (std::size_t n : {1, 3, 8, 100, 4097}) {
+    if (!allocate_blocks<double>(n, false) || !allocate_blocks<char>(n, false)) {
+      return -1;
+    }
+  }
+  if (!allocate_blocks<double>(kMapElements - 1, false)) {
+    return -1;
+  }
+#ifdef TREE_SIMILARITY_HAS_MMAP
+  const bool kMapped = true;
+#else
+  const bool kMapped = false;
+#endif
+  if (!allocate_blocks<double>(kMapElements, kMapped) ||
+      !allocate_blocks<double>(3 * kMapElements + 5, kMapped) ||
+      !allocate_blocks<char>(AlignedAllocator<char>::kMapThreshold, kMapped)) {
+    return -1;
+  }
+
+  // Sizes whose bytes or padding overflow are rejected.
+  AlignedAllocator<double> allocator;
+  for (std::size_t n : {allocator.max_size() + 1, SIZE_MAX / sizeof(double) + 1,
+                        SIZE_MAX}) {
+    try {
+      allocator.allocate(n);
+      std::cerr << "Allocation of " << n << " elements did not fail." << std::endl;
+      return -1;
+    } catch (const std::bad_alloc&) {
+    }
+  }
+
+  // The rows of padded matrices start at cache lines.
+  Matrix<double, AlignedMatrixPolicy> m(4, 1024);
+  if (!aligned(&m.at(0, 0)) || !aligned(&m.at(3, 0)) || stride(m) != 1032) {
+    std::cerr << "Rows of an aligned matrix are not aligned." << std::endl;
+    return -1;
+  }
+
+  // Resizing reuses the memory unless the matrix grows beyond it.
+  m.resize(1000, 1000);
+  const double* kLarge = &m.at(0, 0);
+  if (!aligned(kLarge) || stride(m) != 1000 || m.get_rows() != 1000 ||
+      m.get_columns() != 1000) {
+    std::cerr << "Incorrect matrix after growing." << std::endl;
+    return -1;
+  }
+  m.at(999, 999) = 1.0;
+  m.resize(10, 3);
+  if (&m.at(0, 0) != kLarge || stride(m) != 3 || m.get_rows() != 10) {
+    std::cerr << "Shrinking must reuse the memory." << std::endl;
+    return -1;
+  }
+  m.at(9, 2) = 1.0;
+  m.resize(990, 1001);
+  if (&m.at(0, 0) != kLarge || stride(m) != 1008) {
+    std::cerr << "Growing within the capacity must reuse the memory." << std::endl;
+    return -1;
+  }
+  m.at(989, 1000) = 1.0;
+  m.resize(1500, 1500);
+  if (!aligned(&m.at(0, 0)) || stride(m) != 1504 || m.get_rows() != 1500) {
+    std::cerr << "Incorrect matrix after growing again." << std::endl;
+    return -1;
+  }
+  m.at(1499, 1499) = 1.0;
+  try {
+    m.at(1500, 1504);
+    std::cerr << "Access beyond the matrix not detected." << std::endl;
+    return -1;
+  } catch (const std::out_of_range&) {
+  }
+
+  return 0;
+}
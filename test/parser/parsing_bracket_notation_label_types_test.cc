@@ -0,0 +1,144 @@
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <fstream>
+#include "string_label.h"
+#include "int_label.h"
+#include "hashed_label.h"
+#include "arena_label.h"
+#include "node.h"
+#include "bracket_notation_parser.h"
+#include "unit_cost_model.h"
+#include "zhang_shasha.h"
+
+/// Parses two trees with labels of type Label and computes their TED.
+///
+/// \param tree_1 Source tree in bracket notation.
+/// \param tree_2 Destination tree in bracket notation.
+/// \return The tree edit distance with the unit cost model.
+template <typename Label>
+double ted(const std::string& tree_1, const std::string& tree_2) {
+  parser::BasicBracketNotationParser<Label> bnp;
+  node::Node<Label> t1 = bnp.parse_string(tree_1);
+  node::Node<Label> t2 = bnp.parse_string(tree_2);
+  zhang_shasha::Algorithm<Label, cost_model::UnitCostModel<Label>> zs_ted;
+  return zs_ted.zhang_shasha_ted(t1, t2);
+}
+
+int main() {
+
+  // Parse test cases from file.
+  std::ifstream test_cases_file("label_types_test_data.txt");
+  if (!test_cases_file.is_open()) {
+    std::cerr << "Error while opening file." << std::endl;
+    return -1;
+  }
+
+  for (std::string line; std::getline( test_cases_file, line);) {
+    if (line[0] == '#') {
+      std::getline(test_cases_file, line);
+      std::string input_tree_1_string = line;
+      std::getline(test_cases_file, line);
+      std::string input_tree_2_string = line;
+      std::getline(test_cases_file, line);
+      double correct_string_result = std::stod(line);
+      std::getline(test_cases_file, line);
+      double correct_int_result = std::stod(line);
+
+      // Hashed labels are equal iff the strings are equal (no collisions).
+      double computed_string_results = ted<label::StringLabel>(
+          input_tree_1_string, input_tree_2_string);
+      double computed_hashed_results = ted<label::HashedLabel>(
+          input_tree_1_string, input_tree_2_string);
+      double computed_int_results = ted<label::IntLabel>(
+          input_tree_1_string, input_tree_2_string);
+
+      // Arena labels behave like string labels.
+      label::LabelArena arena;
+      parser::BasicBracketNotationParser<label::ArenaLabel> arena_parser(
+          [&arena](const std::string& l) { return label::ArenaLabel(l, arena); });
+      node::Node<label::ArenaLabel> t1 = arena_parser.parse_string(input_tree_1_string);
+      node::Node<label::ArenaLabel> t2 = arena_parser.parse_string(input_tree_2_string);
+      zhang_shasha::Algorithm<label::ArenaLabel,
+          cost_model::UnitCostModel<label::ArenaLabel>> zs_ted;
+      if (correct_string_result != zs_ted.zhang_shasha_ted(t1, t2)) {
+        std::cerr << "Incorrect TED result with arena labels." << std::endl;
+        std::cerr << input_tree_1_string << std::endl;
+        std::cerr << input_tree_2_string << std::endl;
+        return -1;
+      }
+
+      if (correct_string_result != computed_string_results ||
+          correct_string_result != computed_hashed_results ||
+          correct_int_result != computed_int_results) {
+        std::cerr << "Incorrect TED result: " << computed_string_results
+                  << " " << computed_hashed_results << " "
+                  << computed_int_results << " instead of "
+                  << correct_string_result << " " << correct_string_result
+                  << " " << correct_int_result << std::endl;
+        std::cerr << input_tree_1_string << std::endl;
+        std::cerr << input_tree_2_string << std::endl;
+        return -1;
+      }
+    }
+  }
+
+  // Integer labels are normalised.
+  parser::BasicBracketNotationParser<label::IntLabel> int_parser;
+  node::Node<label::IntLabel> t = int_parser.parse_string(
+      "{\"007\"{\"-3\"}{\"+5\"}{\" 9\"}}");
+  std::string labels;
+  for (const std::string& l : t.get_all_labels()) {
+    labels += l + ",";
+  }
+  if (labels != "7,-3,5,9,") {
+    std::cerr << "Incorrect integer labels: " << labels << std::endl;
+    return -1;
+  }
+
+  // Other labels are rejected.
+  for (const char* invalid : {"", " ", "a", "12a", "1 ", "1.5", "--1",
+                              "9223372036854775808",
+                              "-9223372036854775809"}) {
+    try {
+      label::IntLabel l(invalid);
+      std::cerr << "Invalid integer label accepted: '" << invalid << "'" << std::endl;
+      return -1;
+    } catch (const std::invalid_argument&) {
+    } catch (const std::out_of_range&) {
+    }
+  }
+  if (label::IntLabel("9223372036854775807").value() != INT64_MAX ||
+      label::IntLabel("-9223372036854775808").value() != INT64_MIN) {
+    std::cerr << "Incorrect extreme integer labels." << std::endl;
+    return -1;
+  }
+
+  // Hashes are fixed (FNV-1a), not platform dependent.
+  if (label::HashedLabel("").to_string() != "cbf29ce484222325" ||
+      label::HashedLabel("a").to_string() != "af63dc4c8601ec8c") {
+    std::cerr << "Incorrect hash: " << label::HashedLabel("a").to_string()
+              << std::endl;
+    return -1;
+  }
+
+  // Long arena labels are stored once, short ones inline.
+  label::LabelArena arena;
+  const std::string kLong = "a label longer than the inline capacity";
+  label::ArenaLabel long_1(kLong, arena);
+  label::ArenaLabel long_2(kLong, arena);
+  label::ArenaLabel long_3(kLong + "!", arena);
+  label::ArenaLabel short_1("short", arena);
+  if (!(long_1 == long_2) || long_1.data() != long_2.data() ||
+      long_1 == long_3 || long_1 == short_1 ||
+      long_3.to_string() != kLong + "!" || short_1.to_string() != "short" ||
+      arena.allocated_bytes() != label::LabelArena::kChunkSize ||
+      sizeof(label::ArenaLabel) != 24) {
+    std::cerr << "Incorrect arena labels." << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
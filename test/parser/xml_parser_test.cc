@@ -0,0 +1,119 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <fstream>
+#include "string_label.h"
+#include "node.h"
+#include "label_dictionary.h"
+#include "xml_parser.h"
+
+/// Converts a tree to bracket notation. Quotes and curly brackets in labels
+/// are escaped.
+///
+/// \param n Root of the tree.
+/// \return String representation of the tree.
+std::string to_bracket_notation(const node::Node<label::StringLabel>& n) {
+  std::string s("{\"");
+  for (char c : n.label().to_string()) {
+    if (c == '"' || c == '{' || c == '}') {
+      s += '\\';
+    }
+    s += c;
+  }
+  s += '"';
+  for (const auto& child : n.get_children()) {
+    s += to_bracket_notation(child);
+  }
+  return s + "}";
+}
+
+/// Parses a document and converts the result to bracket notation.
+///
+/// \param parser The parser.
+/// \param document The document.
+/// \return The tree in bracket notation, or ERROR.
+std::string parse(parser::XmlParser& parser, const std::string& document) {
+  if (!parser.parse_string(document)) {
+    return "ERROR";
+  }
+  return to_bracket_notation(parser.get_tree());
+}
+
+int main() {
+
+  using Label = label::StringLabel;
+
+  // Parse test cases from file.
+  std::ifstream test_cases_file("xml_parser_test_data.txt");
+  if (!test_cases_file.is_open()) {
+    std::cerr << "Error while opening file." << std::endl;
+    return -1;
+  }
+
+  label::LabelDictionary<Label> labels;
+  parser::XmlParser xml_parser(parser::XmlMapping(), &labels);
+
+  for (std::string line; std::getline( test_cases_file, line);) {
+    if (line[0] == '#') {
+      std::getline(test_cases_file, line);
+      std::string input_document = line;
+      std::getline(test_cases_file, line);
+      std::string correct_result = line;
+
+      std::string computed_results = parse(xml_parser, input_document);
+
+      if (correct_result != computed_results) {
+        std::cerr << "Incorrect tree: " << computed_results << " instead of " << correct_result << std::endl;
+        std::cerr << input_document << std::endl;
+        std::cerr << xml_parser.get_error() << std::endl;
+        return -1;
+      }
+
+      // Every label of the tree is interned.
+      if (computed_results != "ERROR") {
+        for (const std::string& l : xml_parser.get_tree().get_all_labels()) {
+          if (labels.lookup(Label(l)) == -1) {
+            std::cerr << "Label not interned: " << l << std::endl;
+            return -1;
+          }
+        }
+      }
+    }
+  }
+
+  // Attributes as single leaves, text kept untrimmed.
+  parser::XmlMapping mapping;
+  mapping.attribute_value_nodes = false;
+  mapping.trim_text = false;
+  parser::XmlParser leaves_parser(mapping);
+  std::string computed_results =
+      parse(leaves_parser, "<a x=\"1\" y=\"&quot;\"> t <b/></a>");
+  if (computed_results != "{\"a\"{\"@x=1\"}{\"@y=\\\"\"}{\" t \"}{\"b\"}}") {
+    std::cerr << "Incorrect tree with attribute leaves: " << computed_results << std::endl;
+    return -1;
+  }
+
+  // Elements only.
+  mapping.attributes = false;
+  mapping.text = false;
+  parser::XmlParser elements_parser(mapping);
+  computed_results = parse(elements_parser, "<a x=\"1\">t<b>u</b></a>");
+  if (computed_results != "{\"a\"{\"b\"}}") {
+    std::cerr << "Incorrect tree of elements: " << computed_results << std::endl;
+    return -1;
+  }
+
+  // Consecutive documents of one stream.
+  std::istringstream documents("<a/>\n<b><c/></b>\n");
+  std::string trees;
+  while (xml_parser.parse(documents)) {
+    trees += to_bracket_notation(xml_parser.get_tree());
+  }
+  if (trees != "{\"a\"}{\"b\"{\"c\"}}") {
+    std::cerr << "Incorrect trees of a stream: " << trees << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
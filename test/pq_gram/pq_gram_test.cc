@@ -0,0 +1,112 @@
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fstream>
+#include "string_label.h"
+#include "node.h"
+#include "bracket_notation_parser.h"
+#include "pq_gram.h"
+
+int main() {
+
+  using Label = label::StringLabel;
+
+  // Parse test cases from file.
+  std::ifstream test_cases_file("pq_gram_test_data.txt");
+  if (!test_cases_file.is_open()) {
+    std::cerr << "Error while opening file." << std::endl;
+    return -1;
+  }
+
+  pq_gram::ProfileBuilder<Label> builder(2, 3);
+  pq_gram::Index<Label> index(2, 3);
+  parser::BracketNotationParser bnp;
+  std::vector<node::Node<Label>> queries;
+  std::vector<pq_gram::Profile> indexed_profiles;
+
+  // Read test cases from a file line by line.
+  for (std::string line; std::getline( test_cases_file, line);) {
+    if (line[0] == '#') {
+      // Read the single test case.
+      std::getline(test_cases_file, line);
+      std::string input_tree_1_string = line;
+      std::getline(test_cases_file, line);
+      std::string input_tree_2_string = line;
+      std::getline(test_cases_file, line);
+      double correct_result = std::stod(line);
+
+      // Parse test tree.
+      node::Node<Label> t1 = bnp.parse_string(input_tree_1_string);
+      node::Node<Label> t2 = bnp.parse_string(input_tree_2_string);
+
+      // Compute the distance.
+      double computed_results = pq_gram::pq_gram_distance(
+          builder.extract(t1), builder.extract(t2));
+
+      if (std::abs(correct_result - computed_results) > 1e-9) {
+        std::cerr << "Incorrect pq-gram distance: " << computed_results << " instead of " << correct_result << std::endl;
+        std::cerr << input_tree_1_string << std::endl;
+        std::cerr << input_tree_2_string << std::endl;
+        return -1;
+      }
+
+      // Index the destination trees, query with the source trees.
+      index.add(t2);
+      indexed_profiles.push_back(builder.extract(t2));
+      queries.push_back(t1);
+    }
+  }
+
+  // Index lookups must report all trees with the pq-gram distance, closest
+  // first, trees without a common pq-gram last.
+  for (const auto& query : queries) {
+    const pq_gram::Profile kProfile = builder.extract(query);
+    const auto kResults = index.lookup(query, index.size());
+    if (static_cast<int>(kResults.size()) != index.size() ||
+        index.range(query, 1.0) != kResults) {
+      std::cerr << "Incorrect number of lookup results: " << kResults.size() << " instead of " << index.size() << std::endl;
+      return -1;
+    }
+    for (std::size_t r = 0; r < kResults.size(); ++r) {
+      double correct_result = pq_gram::pq_gram_distance(
+          kProfile, indexed_profiles[kResults[r].first]);
+      if (std::abs(correct_result - kResults[r].second) > 1e-9 ||
+          (r > 0 && (kResults[r - 1].second > kResults[r].second ||
+                     (kResults[r - 1].second == kResults[r].second &&
+                      kResults[r - 1].first > kResults[r].first)))) {
+        std::cerr << "Incorrect lookup result for tree " << kResults[r].first << std::endl;
+        return -1;
+      }
+    }
+    const auto kTop = index.lookup(query, 3);
+    const auto kRange = index.range(query, 0.5);
+    for (std::size_t r = 0; r < kTop.size(); ++r) {
+      if (kTop[r] != kResults[r]) {
+        std::cerr << "Incorrect top-k lookup result" << std::endl;
+        return -1;
+      }
+    }
+    for (std::size_t r = 0; r < kResults.size(); ++r) {
+      if ((r < kRange.size()) != (kResults[r].second <= 0.5)) {
+        std::cerr << "Incorrect range lookup result" << std::endl;
+        return -1;
+      }
+    }
+  }
+
+  // A query without a common pq-gram is at distance 1 to all trees.
+  const node::Node<Label> kUnrelated = bnp.parse_string("{\"unrelated\"}");
+  const auto kUnrelatedTop = index.lookup(kUnrelated, 3);
+  if (kUnrelatedTop.size() != 3 || kUnrelatedTop[0].first != 0 ||
+      kUnrelatedTop[2].first != 2 || kUnrelatedTop[2].second != 1.0 ||
+      !index.range(kUnrelated, 0.99).empty() ||
+      static_cast<int>(index.range(kUnrelated, 1.0).size()) != index.size() ||
+      !index.lookup(kUnrelated, 0).empty() ||
+      !index.lookup(kUnrelated, -1).empty()) {
+    std::cerr << "Incorrect lookup of a query without common pq-grams" << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,138 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "server.h"
+
+int main() {
+
+  // Latency percentiles are nearest-rank over the recent samples.
+  ted_server::LatencyRecorder empty(10);
+  if (empty.summary() != "requests=0 p50_ms=0 p90_ms=0 p99_ms=0 max_ms=0") {
+    std::cerr << "Incorrect empty latency summary: " << empty.summary() << std::endl;
+    return -1;
+  }
+  ted_server::LatencyRecorder latencies(1000);
+  for (int i = 100; i >= 1; --i) {
+    latencies.record(i);
+  }
+  if (latencies.summary() != "requests=100 p50_ms=50 p90_ms=90 p99_ms=99 max_ms=100") {
+    std::cerr << "Incorrect latency summary: " << latencies.summary() << std::endl;
+    return -1;
+  }
+  // Only the 10 most recent samples 16..25 are kept, all are counted.
+  ted_server::LatencyRecorder recent(10);
+  for (int i = 1; i <= 25; ++i) {
+    recent.record(i);
+  }
+  if (recent.summary() != "requests=25 p50_ms=20 p90_ms=24 p99_ms=25 max_ms=25") {
+    std::cerr << "Incorrect latency summary of recent samples: " << recent.summary() << std::endl;
+    return -1;
+  }
+
+  // Bracket notation validation.
+  const std::vector<std::string> kValid = {
+    "{\"a\"}",
+    "{\"\"}",
+    "{\"a\"{\"b\"}{\"c\"{\"d\"}}}",
+    "{\"a\\\"\\}\"{\"b\"}}",
+    "{\"a b\"{\"\\{\\}\"}}",
+  };
+  const std::vector<std::string> kMalformed = {
+    "",
+    "{}",
+    "{\"a\"",
+    "{\"a}",
+    "{\"a\"}}",
+    "{\"a\"}{\"b\"}",
+    "{\"a\"{}}",
+    "{\"a\"x{\"b\"}}",
+    "{\"a\"\"b\"}",
+    "{\"a\"{\"b\"}",
+    " {\"a\"}",
+    "{\"a\"} ",
+    "{a}",
+    "{\"0\"{1}}",
+    "{\"a{\"}",
+  };
+  for (const std::string& s : kValid) {
+    if (!ted_server::is_bracket_notation(s)) {
+      std::cerr << "Valid tree rejected: " << s << std::endl;
+      return -1;
+    }
+  }
+  for (const std::string& s : kMalformed) {
+    if (ted_server::is_bracket_notation(s)) {
+      std::cerr << "Malformed tree accepted: " << s << std::endl;
+      return -1;
+    }
+  }
+  // Line protocol. Responses are in the order of requests, requests after
+  // quit are not read.
+  ted_server::ServerOptions options;
+  options.corpus_file = "server_test_corpus.txt";
+  options.threads = 2;
+  std::istringstream requests(
+      "distance {\"a\"{\"b\"}}\n"
+      "\n"
+      "bounded 1 {\"a\"{\"b\"}}\r\n"
+      "topk 2 {\"a\"{\"b\"}}\n"
+      "topk 5 {\"x\"}\n"
+      "distance {\"a\"{}}\n"
+      "bounded -1 {\"a\"}\n"
+      "topk 0 {\"a\"}\n"
+      "frob {\"a\"}\n"
+      "quit\n"
+      "distance {\"a\"}\n");
+  std::ostringstream responses;
+  if (ted_server::serve_stream(options, requests, responses) != 0) {
+    std::cerr << "Server failed." << std::endl;
+    return -1;
+  }
+  const std::string kExpected =
+      "OK 1 0 2\n"
+      "OK 1:0 0:1\n"
+      "OK 1:0 0:1\n"
+      "OK 2:0 1:2 0:3\n"
+      "ERR malformed tree\n"
+      "ERR bounded expects a non-negative threshold\n"
+      "ERR topk expects a positive k\n"
+      "ERR unknown command 'frob'\n";
+  if (responses.str() != kExpected) {
+    std::cerr << "Incorrect responses:" << std::endl << responses.str() << std::endl;
+    return -1;
+  }
+
+  // With one request in flight, reading waits for every response, the
+  // responses are the same.
+  options.max_in_flight = 1;
+  requests.clear();
+  requests.seekg(0);
+  std::ostringstream throttled_responses;
+  if (ted_server::serve_stream(options, requests, throttled_responses) != 0 ||
+      throttled_responses.str() != kExpected) {
+    std::cerr << "Incorrect responses with one request in flight:" << std::endl << throttled_responses.str() << std::endl;
+    return -1;
+  }
+  options.max_in_flight = 64;
+
+  // A stats request is answered in order with the latencies so far.
+  std::istringstream stats_requests("distance {\"a\"}\nstats\n");
+  std::ostringstream stats_responses;
+  ted_server::serve_stream(options, stats_requests, stats_responses);
+  if (stats_responses.str().compare(0, 19, "OK 2 1 1\nOK request") != 0) {
+    std::cerr << "Incorrect stats response:" << std::endl << stats_responses.str() << std::endl;
+    return -1;
+  }
+
+  // A missing corpus is an error.
+  options.corpus_file = "missing_corpus.txt";
+  std::istringstream no_requests("");
+  std::ostringstream no_responses;
+  if (ted_server::serve_stream(options, no_requests, no_responses) != -1) {
+    std::cerr << "Missing corpus accepted." << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
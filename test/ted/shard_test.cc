@@ -0,0 +1,287 @@
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "unit_cost_model.h"
+#include "weighted_cost_model.h"
+#include "string_label.h"
+#include "node.h"
+#include "bracket_notation_parser.h"
+#include "zhang_shasha.h"
+#include "shard.h"
+
+using Label = label::StringLabel;
+
+/// Writes lines to a file.
+void write_lines(const std::string& file, const std::vector<std::string>& lines) {
+  std::ofstream out(file);
+  for (const std::string& line : lines) {
+    out << line << "\n";
+  }
+}
+
+/// Reads the lines of a file.
+std::vector<std::string> read_lines(const std::string& file) {
+  std::ifstream in(file);
+  std::vector<std::string> lines;
+  for (std::string line; std::getline(in, line);) {
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+/// Verifies that the pair ranges of n shards are contiguous and cover all
+/// pairs exactly once.
+bool verify_ranges(const std::vector<int>& sizes, int shards) {
+  const long long n = sizes.size();
+  const long long kPairs = n * (n - 1) / 2;
+  double total_cost = 0.0;
+  double max_cost = 0.0;
+  for (long long i = 0; i < n; ++i) {
+    for (long long j = i + 1; j < n; ++j) {
+      total_cost += static_cast<double>(sizes[i]) * sizes[j];
+      max_cost = std::max(max_cost, static_cast<double>(sizes[i]) * sizes[j]);
+    }
+  }
+  long long previous_end = 0;
+  for (int s = 0; s < shards; ++s) {
+    // The same computation as in run_shard.
+    const ted_shard::TreePair kBegin =
+        ted_shard::first_pair(sizes, total_cost * s / shards);
+    const ted_shard::TreePair kEnd = s + 1 == shards ?
+        ted_shard::TreePair{n - 1, n} :
+        ted_shard::first_pair(sizes, total_cost * (s + 1) / shards);
+    const long long kBeginPosition = ted_shard::pair_position(kBegin, n);
+    const long long kEndPosition = ted_shard::pair_position(kEnd, n);
+    if (kBeginPosition != previous_end || kEndPosition < kBeginPosition ||
+        kEndPosition > kPairs) {
+      std::cerr << "Shard " << s << "/" << shards << " of " << n << " trees has range " << kBeginPosition << ".." << kEndPosition << " after " << previous_end << std::endl;
+      return false;
+    }
+    // The shards are balanced up to the cost of one pair.
+    double cost = 0.0;
+    for (ted_shard::TreePair p = kBegin;
+         ted_shard::pair_position(p, n) < kEndPosition;) {
+      cost += static_cast<double>(sizes[p.i]) * sizes[p.j];
+      if (++p.j == n) {
+        ++p.i;
+        p.j = p.i + 1;
+      }
+    }
+    if (cost > total_cost / shards + max_cost + 1e-6) {
+      std::cerr << "Shard " << s << "/" << shards << " is unbalanced: " << cost << std::endl;
+      return false;
+    }
+    previous_end = kEndPosition;
+  }
+  if (previous_end != kPairs) {
+    std::cerr << "Shards of " << n << " trees end at " << previous_end << " instead of " << kPairs << std::endl;
+    return false;
+  }
+  return true;
+}
+
+/// Computes the shards of a collection.
+bool compute_shards(const std::string& collection, int shards,
+                    double threshold, const std::string& prefix,
+                    const std::string& costs = "") {
+  for (int s = 0; s < shards; ++s) {
+    ted_shard::ShardOptions options;
+    options.collection_file = collection;
+    options.shard = s;
+    options.shards = shards;
+    options.threshold = threshold;
+    options.costs_file = costs;
+    options.output_file = prefix + std::to_string(s) + ".txt";
+    if (ted_shard::run_shard(options) != 0) {
+      std::cerr << "Shard " << s << "/" << shards << " failed." << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+int main() {
+
+  // Parse test cases from file. The trees of the first test cases form the
+  // collection.
+  std::ifstream test_cases_file("ted_test_data.txt");
+  if (!test_cases_file.is_open()) {
+    std::cerr << "Error while opening file." << std::endl;
+    return -1;
+  }
+  std::vector<std::string> tree_strings;
+  for (std::string line; std::getline( test_cases_file, line) && tree_strings.size() < 30;) {
+    if (line[0] == '#') {
+      std::getline(test_cases_file, line);
+      tree_strings.push_back(line);
+      std::getline(test_cases_file, line);
+      tree_strings.push_back(line);
+      std::getline(test_cases_file, line);
+    }
+  }
+  parser::BracketNotationParser bnp;
+  std::vector<node::Node<Label>> trees;
+  std::vector<int> sizes;
+  for (const std::string& s : tree_strings) {
+    trees.push_back(bnp.parse_string(s));
+    sizes.push_back(trees.back().get_tree_size());
+  }
+  const long long n = trees.size();
+  const long long kPairs = n * (n - 1) / 2;
+
+  // Pair ranges: adjacent shards meet exactly, also with more shards than
+  // pairs, and for collections without pairs.
+  for (int shards : {1, 2, 3, 7, 64, 1000}) {
+    if (!verify_ranges(sizes, shards)) {
+      return -1;
+    }
+  }
+  const std::vector<int> kFewSizes = {5, 1, 3};
+  for (int shards : {1, 2, 3, 4, 10}) {
+    if (!verify_ranges(kFewSizes, shards) ||
+        !verify_ranges(std::vector<int>(), shards) ||
+        !verify_ranges(std::vector<int>(1, 4), shards)) {
+      return -1;
+    }
+  }
+  if (ted_shard::pair_position(ted_shard::first_pair(sizes, 0.0), n) != 0 ||
+      ted_shard::pair_position(ted_shard::first_pair(sizes, 1e18), n) != kPairs) {
+    std::cerr << "Incorrect first pair for the extreme bounds." << std::endl;
+    return -1;
+  }
+
+  // Round trip: merged shards equal the unsharded distance matrix.
+  write_lines("collection.txt", tree_strings);
+  if (!compute_shards("collection.txt", 4, -1.0, "matrix_shard_") ||
+      ted_shard::run_merge({"matrix_shard_2.txt", "matrix_shard_0.txt",
+                            "matrix_shard_3.txt", "matrix_shard_1.txt"},
+                           "matrix.txt") != 0) {
+    return -1;
+  }
+  zhang_shasha::Algorithm<Label, cost_model::UnitCostModel<Label>> zs_ted;
+  std::vector<std::string> expected;
+  std::vector<std::string> expected_join;
+  for (long long i = 0; i < n; ++i) {
+    for (long long j = i + 1; j < n; ++j) {
+      const double kDistance = zs_ted.zhang_shasha_ted(trees[i], trees[j]);
+      std::ostringstream line;
+      line.precision(std::numeric_limits<double>::max_digits10);
+      line << i << " " << j << " " << kDistance;
+      expected.push_back(line.str());
+      if (kDistance <= 6.0) {
+        expected_join.push_back(line.str());
+      }
+    }
+  }
+  if (read_lines("matrix.txt") != expected) {
+    std::cerr << "Merged matrix differs from the unsharded distances." << std::endl;
+    return -1;
+  }
+  if (!compute_shards("collection.txt", 3, 6.0, "join_shard_") ||
+      ted_shard::run_merge({"join_shard_0.txt", "join_shard_1.txt",
+                            "join_shard_2.txt"}, "join.txt") != 0 ||
+      read_lines("join.txt") != expected_join || expected_join.empty()) {
+    std::cerr << "Merged join differs from the unsharded join." << std::endl;
+    return -1;
+  }
+
+  // Asymmetric costs: both distances of every pair are written.
+  write_lines("asymmetric_costs.txt", {"default ins 2", "ren \"a\" \"b\" 0.5"});
+  cost_model::WeightedCostModel<Label> asymmetric_costs;
+  if (!asymmetric_costs.read_from_file("asymmetric_costs.txt") ||
+      asymmetric_costs.is_symmetric()) {
+    std::cerr << "Asymmetric costs not detected." << std::endl;
+    return -1;
+  }
+  zhang_shasha::Algorithm<Label, cost_model::WeightedCostModel<Label>>
+      weighted_ted(asymmetric_costs);
+  std::vector<std::string> expected_asymmetric;
+  bool differs = false;
+  for (long long i = 0; i < n; ++i) {
+    for (long long j = i + 1; j < n; ++j) {
+      const double kDistance = weighted_ted.zhang_shasha_ted(trees[i], trees[j]);
+      const double kReverse = weighted_ted.zhang_shasha_ted(trees[j], trees[i]);
+      differs = differs || kDistance != kReverse;
+      std::ostringstream line;
+      line.precision(std::numeric_limits<double>::max_digits10);
+      line << i << " " << j << " " << kDistance << " " << kReverse;
+      expected_asymmetric.push_back(line.str());
+    }
+  }
+  if (!differs ||
+      !compute_shards("collection.txt", 3, -1.0, "asymmetric_shard_",
+                      "asymmetric_costs.txt") ||
+      ted_shard::run_merge({"asymmetric_shard_1.txt", "asymmetric_shard_0.txt",
+                            "asymmetric_shard_2.txt"}, "asymmetric.txt") != 0 ||
+      read_lines("asymmetric.txt") != expected_asymmetric) {
+    std::cerr << "Merged asymmetric matrix differs from the unsharded distances." << std::endl;
+    return -1;
+  }
+  write_lines("symmetric_costs.txt", {"default del 3", "default ins 3",
+      "ren \"a\" \"b\" 0.5", "ren \"b\" \"a\" 0.5", "ren \"c\" \"d\" 1"});
+  cost_model::WeightedCostModel<Label> symmetric_costs;
+  if (!symmetric_costs.read_from_file("symmetric_costs.txt") ||
+      !symmetric_costs.is_symmetric()) {
+    std::cerr << "Symmetric costs not detected." << std::endl;
+    return -1;
+  }
+
+  // A collection with one tree has no pairs.
+  write_lines("single.txt", {tree_strings[0]});
+  if (!compute_shards("single.txt", 2, -1.0, "single_shard_") ||
+      ted_shard::run_merge({"single_shard_0.txt", "single_shard_1.txt"},
+                           "single_merged.txt") != 0 ||
+      !read_lines("single_merged.txt").empty()) {
+    std::cerr << "Incorrect merge of a collection without pairs." << std::endl;
+    return -1;
+  }
+
+  // Invalid shard sets are rejected.
+  std::vector<std::string> foreign_trees = tree_strings;
+  foreign_trees[0] = "{\"foreign\"}";
+  write_lines("foreign.txt", foreign_trees);
+  if (!compute_shards("foreign.txt", 4, -1.0, "foreign_shard_")) {
+    return -1;
+  }
+  std::vector<std::string> shard_lines = read_lines("matrix_shard_1.txt");
+  std::vector<std::string> without_footer(shard_lines.begin(), shard_lines.end() - 1);
+  write_lines("without_footer.txt", without_footer);
+  std::vector<std::string> out_of_order = shard_lines;
+  std::swap(out_of_order[1], out_of_order[2]);
+  write_lines("out_of_order.txt", out_of_order);
+  std::vector<std::string> out_of_range = shard_lines;
+  out_of_range.insert(out_of_range.begin() + 1, "0 1 3");
+  write_lines("out_of_range.txt", out_of_range);
+  std::vector<std::string> beyond_collection = shard_lines;
+  beyond_collection.insert(beyond_collection.end() - 1, std::to_string(n - 2) + " " + std::to_string(n) + " 3");
+  write_lines("beyond_collection.txt", beyond_collection);
+  std::vector<std::string> extra_distance = shard_lines;
+  extra_distance[1] += " 3";
+  write_lines("extra_distance.txt", extra_distance);
+  const std::vector<std::vector<std::string>> kInvalid = {
+    {},
+    {"matrix_shard_0.txt", "matrix_shard_1.txt", "matrix_shard_3.txt"},
+    {"matrix_shard_0.txt", "matrix_shard_1.txt", "matrix_shard_1.txt", "matrix_shard_2.txt", "matrix_shard_3.txt"},
+    {"matrix_shard_0.txt", "matrix_shard_1.txt", "matrix_shard_2.txt", "matrix_shard_2.txt"},
+    {"matrix_shard_0.txt", "foreign_shard_1.txt", "matrix_shard_2.txt", "matrix_shard_3.txt"},
+    {"matrix_shard_0.txt", "join_shard_1.txt", "matrix_shard_2.txt", "matrix_shard_3.txt"},
+    {"matrix_shard_0.txt", "without_footer.txt", "matrix_shard_2.txt", "matrix_shard_3.txt"},
+    {"matrix_shard_0.txt", "out_of_order.txt", "matrix_shard_2.txt", "matrix_shard_3.txt"},
+    {"matrix_shard_0.txt", "out_of_range.txt", "matrix_shard_2.txt", "matrix_shard_3.txt"},
+    {"matrix_shard_0.txt", "beyond_collection.txt", "matrix_shard_2.txt", "matrix_shard_3.txt"},
+    {"matrix_shard_0.txt", "extra_distance.txt", "matrix_shard_2.txt", "matrix_shard_3.txt"},
+    {"matrix_shard_0.txt", "missing.txt", "matrix_shard_2.txt", "matrix_shard_3.txt"},
+    {"matrix_shard_0.txt", "collection.txt", "matrix_shard_2.txt", "matrix_shard_3.txt"},
+  };
+  for (std::size_t c = 0; c < kInvalid.size(); ++c) {
+    if (ted_shard::run_merge(kInvalid[c], "invalid.txt") != -1) {
+      std::cerr << "Invalid shard set " << c << " merged." << std::endl;
+      return -1;
+    }
+  }
+
+  return 0;
+}
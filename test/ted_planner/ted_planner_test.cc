@@ -0,0 +1,173 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fstream>
+#include "unit_cost_model.h"
+#include "string_edit_distance_cost_model.h"
+#include "string_label.h"
+#include "node.h"
+#include "bracket_notation_parser.h"
+#include "zhang_shasha.h"
+#include "ted_planner.h"
+
+/// Counts the subforest distances computed by Zhang and Shasha for a tree:
+/// the sum of the subtree sizes of its key roots.
+///
+/// \param zs_ted Algorithm whose last computation indexed the tree as source.
+/// \return Sum of the subtree sizes.
+template <typename Algorithm>
+long long key_root_nodes(const Algorithm& zs_ted) {
+  long long nodes = 0;
+  for (int kr : zs_ted.get_test_items().t1_kr) {
+    nodes += kr - zs_ted.get_test_items().t1_lld[kr - 1] + 1;
+  }
+  return nodes;
+}
+
+int main() {
+
+  using Label = label::StringLabel;
+  using CostModel = cost_model::UnitCostModel<Label>;
+  using Planner = ted_planner::Planner<Label, CostModel>;
+  using ted_planner::Engine;
+  using ted_planner::Estimate;
+
+  // Parse test cases from file.
+  std::ifstream test_cases_file("ted_test_data.txt");
+  if (!test_cases_file.is_open()) {
+    std::cerr << "Error while opening file." << std::endl;
+    return -1;
+  }
+
+  // Initialise the algorithms.
+  Planner unlimited(1LL << 40);
+  Planner rejecting(0, true);
+  const long long kSharedBudget = 1 << 16;
+  Planner shared(kSharedBudget, true);
+  zhang_shasha::Algorithm<Label, CostModel> zs_ted;
+
+  // Read test cases from a file line by line.
+  for (std::string line; std::getline( test_cases_file, line);) {
+    if (line[0] == '#') {
+      // Read the single test case.
+      std::getline(test_cases_file, line);
+      std::string input_tree_1_string = line;
+      std::getline(test_cases_file, line);
+      std::string input_tree_2_string = line;
+      std::getline(test_cases_file, line);
+      double correct_result = std::stod(line);
+
+      // Parse test tree.
+      parser::BracketNotationParser bnp;
+      node::Node<Label> t1 = bnp.parse_string(input_tree_1_string);
+      node::Node<Label> t2 = bnp.parse_string(input_tree_2_string);
+      node::Node<Label> t1_mirrored = ted_planner::mirror(t1);
+      node::Node<Label> t2_mirrored = ted_planner::mirror(t2);
+
+      std::string error;
+
+      // The subproblems of both orientations are those of Zhang and Shasha.
+      const std::vector<Estimate> estimates = unlimited.estimate(t1, t2);
+      zs_ted.zhang_shasha_ted(t1, t2);
+      if (estimates[0].peak_bytes < zs_ted.get_test_items().matrix_bytes) {
+        error = "Estimated " + std::to_string(estimates[0].peak_bytes) +
+                " bytes, but the matrices take " +
+                std::to_string(zs_ted.get_test_items().matrix_bytes);
+      }
+      long long left = key_root_nodes(zs_ted);
+      zs_ted.zhang_shasha_ted(t2, t1);
+      left *= key_root_nodes(zs_ted);
+      zs_ted.zhang_shasha_ted(t1_mirrored, t2_mirrored);
+      long long right = key_root_nodes(zs_ted);
+      zs_ted.zhang_shasha_ted(t2_mirrored, t1_mirrored);
+      right *= key_root_nodes(zs_ted);
+      if (estimates[0].subproblems != left ||
+          estimates[1].subproblems != right) {
+        error = "Subproblems " + std::to_string(estimates[0].subproblems) +
+                "/" + std::to_string(estimates[1].subproblems) +
+                " instead of " + std::to_string(left) + "/" +
+                std::to_string(right);
+      }
+
+      // Without a limit, the cheaper orientation of Zhang and Shasha is run.
+      // Both orientations compute the distance.
+      Estimate plan = unlimited.plan(t1, t2);
+      if (plan.engine != Engine::kZhangShasha ||
+          plan.subproblems != std::min(left, right)) {
+        error = "Unexpected plan for an unlimited budget";
+      }
+      for (Estimate e : {estimates[0], estimates[1]}) {
+        double computed_result = unlimited.execute(e, t1, t2);
+        if (computed_result != correct_result) {
+          error = "Distance " + std::to_string(computed_result) +
+                  " instead of " + std::to_string(correct_result);
+        }
+      }
+
+      // With the budget of the smallest engine, an upper bound is computed
+      // unless an exact computation fits.
+      Planner bounded(estimates.back().peak_bytes, true);
+      plan = bounded.plan(t1, t2);
+      double computed_result = bounded.execute(plan, t1, t2);
+      if (plan.peak_bytes > estimates.back().peak_bytes ||
+          (plan.exact && computed_result != correct_result) ||
+          computed_result < correct_result) {
+        error = "Unexpected result " + std::to_string(computed_result) +
+                " of " + ted_planner::engine_name(plan.engine);
+      }
+
+      // Workspaces of a planner shared by all pairs are released before the
+      // retained memory exceeds the budget.
+      for (const Estimate& e : estimates) {
+        if (e.peak_bytes <= kSharedBudget &&
+            (shared.execute(e, t1, t2) < correct_result ||
+             shared.retained_bytes() > kSharedBudget)) {
+          error = "Retained " +
+                  std::to_string(shared.retained_bytes()) +
+                  " bytes after " + ted_planner::engine_name(e.engine);
+        }
+      }
+
+      // Nothing fits an empty budget.
+      plan = rejecting.plan(t1, t2);
+      if (plan.engine != Engine::kRejected ||
+          rejecting.execute(plan, t1, t2) != -1) {
+        error = "Pair not rejected";
+      }
+
+      if (!error.empty()) {
+        std::cerr << error << std::endl;
+        std::cerr << input_tree_1_string << std::endl;
+        std::cerr << input_tree_2_string << std::endl;
+        return -1;
+      }
+    }
+  }
+
+  // Rename costs are stored for the source labels and the labels of both
+  // trees, which are many more than the destination labels if the label
+  // sets are disjoint. The rows of the large td and fd matrices are padded.
+  {
+    using StringCostModel = cost_model::StringEditDistanceCostModel<Label>;
+    node::Node<Label> t1(Label("a"));
+    for (int i = 0; i < 300; ++i) {
+      t1.add_child(node::Node<Label>(Label("a" + std::to_string(i))));
+    }
+    node::Node<Label> t2(Label("b"));
+    for (int j = 0; j < 600; ++j) {
+      t2.add_child(node::Node<Label>(Label("b" + std::to_string(j))));
+    }
+    ted_planner::Planner<Label, StringCostModel> planner(1LL << 40);
+    zhang_shasha::Algorithm<Label, StringCostModel> string_ted;
+    string_ted.zhang_shasha_ted(t1, t2);
+    const long long kEstimated = planner.estimate(t1, t2)[0].peak_bytes;
+    const long long kAllocated = string_ted.get_test_items().matrix_bytes;
+    if (kEstimated < kAllocated) {
+      std::cerr << "Estimated " << kEstimated << " bytes, but the matrices "
+                << "take " << kAllocated << " for disjoint labels" << std::endl;
+      return -1;
+    }
+  }
+
+  return 0;
+}
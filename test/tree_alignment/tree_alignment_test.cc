@@ -0,0 +1,63 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fstream>
+#include "unit_cost_model.h"
+#include "string_label.h"
+#include "node.h"
+#include "bracket_notation_parser.h"
+#include "zhang_shasha.h"
+#include "tree_alignment.h"
+#include "top_down_ted.h"
+
+int main() {
+
+  using Label = label::StringLabel;
+  using CostModel = cost_model::UnitCostModel<Label>;
+
+  // Parse test cases from file.
+  std::ifstream test_cases_file("tree_alignment_test_data.txt");
+  if (!test_cases_file.is_open()) {
+    std::cerr << "Error while opening file." << std::endl;
+    return -1;
+  }
+
+  // Initialise the algorithms.
+  tree_alignment::Algorithm<Label, CostModel> alignment;
+  top_down_ted::Algorithm<Label, CostModel> td_ted;
+  zhang_shasha::Algorithm<Label, CostModel> zs_ted;
+
+  // Read test cases from a file line by line.
+  for (std::string line; std::getline( test_cases_file, line);) {
+    if (line[0] == '#') {
+      // Read the single test case.
+      std::getline(test_cases_file, line);
+      std::string input_tree_1_string = line;
+      std::getline(test_cases_file, line);
+      std::string input_tree_2_string = line;
+      std::getline(test_cases_file, line);
+      double correct_result = std::stod(line);
+
+      // Parse test tree.
+      parser::BracketNotationParser bnp;
+      node::Node<Label> t1 = bnp.parse_string(input_tree_1_string);
+      node::Node<Label> t2 = bnp.parse_string(input_tree_2_string);
+
+      // Execute the algorithm.
+      double computed_results = alignment.tree_alignment_distance(t1, t2);
+
+      // The alignment distance lies between the tree edit distance and the
+      // top-down distance.
+      if (correct_result != computed_results ||
+          computed_results < zs_ted.zhang_shasha_ted(t1, t2) ||
+          computed_results > td_ted.top_down_ted(t1, t2)) {
+        std::cerr << "Incorrect alignment distance: " << computed_results << " instead of " << correct_result << std::endl;
+        std::cerr << input_tree_1_string << std::endl;
+        std::cerr << input_tree_2_string << std::endl;
+        return -1;
+      }
+    }
+  }
+
+  return 0;
+}
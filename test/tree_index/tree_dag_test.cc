@@ -0,0 +1,126 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fstream>
+#include "unit_cost_model.h"
+#include "string_label.h"
+#include "node.h"
+#include "bracket_notation_parser.h"
+#include "zhang_shasha.h"
+#include "constrained_ted.h"
+#include "top_down_ted.h"
+#include "tree_alignment.h"
+#include "tree_dag.h"
+
+int main() {
+
+  using Label = label::StringLabel;
+  using CostModel = cost_model::UnitCostModel<Label>;
+
+  // Parse test cases from file.
+  std::ifstream test_cases_file("ted_test_data.txt");
+  if (!test_cases_file.is_open()) {
+    std::cerr << "Error while opening file." << std::endl;
+    return -1;
+  }
+  std::vector<std::string> tree_strings;
+  for (std::string line; std::getline( test_cases_file, line);) {
+    if (line[0] == '#') {
+      std::getline(test_cases_file, line);
+      tree_strings.push_back(line);
+      std::getline(test_cases_file, line);
+      tree_strings.push_back(line);
+      std::getline(test_cases_file, line);
+    }
+  }
+
+  parser::BracketNotationParser bnp;
+  std::vector<node::Node<Label>> trees;
+  tree_index::TreeDag<Label> dag;
+  std::vector<int> roots;
+  for (const std::string& s : tree_strings) {
+    trees.push_back(bnp.parse_string(s));
+    roots.push_back(dag.add(trees.back()));
+  }
+
+  // Every DAG node expands back to the tree it was built from.
+  zhang_shasha::Algorithm<Label, CostModel> zs_ted;
+  for (std::size_t t = 0; t < trees.size(); ++t) {
+    node::Node<Label> expanded = dag.to_tree(roots[t]);
+    if (expanded.get_tree_size() != trees[t].get_tree_size() ||
+        dag.tree_size(roots[t]) != trees[t].get_tree_size() ||
+        zs_ted.zhang_shasha_ted(expanded, trees[t]) != 0.0) {
+      std::cerr << "Incorrect expansion of tree " << t << ": " << tree_strings[t] << std::endl;
+      return -1;
+    }
+  }
+
+  // Indexing a DAG node gives the index of the tree, also where shared
+  // subtrees are copied.
+  tree_index::TreeIndex<Label> tree_ti;
+  tree_index::TreeIndex<Label> dag_ti;
+  for (std::size_t t = 0; t < trees.size(); ++t) {
+    tree_ti.index(trees[t]);
+    dag_ti.index(dag, roots[t]);
+    bool equal = dag_ti.size() == tree_ti.size() &&
+                 dag_ti.llds() == tree_ti.llds() &&
+                 static_cast<int>(dag_ti.dag_ids().size()) == dag_ti.size();
+    for (int i = 1; equal && i <= tree_ti.size(); ++i) {
+      equal = dag_ti.node(i).label() == tree_ti.node(i).label() &&
+              dag_ti.children_count(i) == tree_ti.children_count(i) &&
+              dag.tree_size(dag_ti.dag_ids()[i - 1]) == i - dag_ti.lld(i) + 1;
+    }
+    if (!equal) {
+      std::cerr << "Incorrect DAG index of tree " << t << ": " << tree_strings[t] << std::endl;
+      return -1;
+    }
+  }
+
+  // Algorithms indexing the DAG directly give the same distances as on nodes.
+  constrained_ted::Algorithm<Label, CostModel> constrained;
+  top_down_ted::Algorithm<Label, CostModel> top_down;
+  tree_alignment::Algorithm<Label, CostModel> alignment;
+  for (std::size_t t1 = 0; t1 < trees.size(); ++t1) {
+    for (std::size_t t2 = t1; t2 < trees.size(); t2 += 7) {
+      if (zs_ted.zhang_shasha_ted(dag, roots[t1], dag, roots[t2]) !=
+              zs_ted.zhang_shasha_ted(trees[t1], trees[t2]) ||
+          constrained.constrained_ted(dag, roots[t1], dag, roots[t2]) !=
+              constrained.constrained_ted(trees[t1], trees[t2]) ||
+          top_down.top_down_ted(dag, roots[t1], dag, roots[t2]) !=
+              top_down.top_down_ted(trees[t1], trees[t2]) ||
+          alignment.tree_alignment_distance(dag, roots[t1], dag, roots[t2]) !=
+              alignment.tree_alignment_distance(trees[t1], trees[t2])) {
+        std::cerr << "Incorrect distance on DAG between trees " << t1 << " and " << t2 << std::endl;
+        return -1;
+      }
+    }
+  }
+
+  // A tree of repeated subtrees compresses to one DAG node per distinct
+  // subtree: 2^10 - 1 tree nodes, but only 10 distinct subtrees.
+  std::string repetitive = "{\"x\"}";
+  for (int level = 1; level < 10; ++level) {
+    repetitive = "{\"x\"" + repetitive + repetitive + "}";
+  }
+  tree_index::TreeDag<Label> repetitive_dag;
+  const int kRoot = repetitive_dag.add(bnp.parse_string(repetitive));
+  auto stats = repetitive_dag.get_statistics();
+  if (stats.tree_nodes != 1023 || stats.dag_nodes != 10 ||
+      stats.dag_edges != 18 || repetitive_dag.height(kRoot) != 10 ||
+      repetitive_dag.tree_size(kRoot) != 1023) {
+    std::cerr << "Incorrect compression: " << stats.dag_nodes << " DAG nodes for " << stats.tree_nodes << " tree nodes" << std::endl;
+    return -1;
+  }
+  const node::Node<Label> kRepetitiveTree = repetitive_dag.to_tree(kRoot);
+  const node::Node<Label> kLeaf = bnp.parse_string("{\"x\"}");
+  tree_index::TreeDag<Label> other_dag;
+  const int kLeafRoot = other_dag.add(kLeaf);
+  if (zs_ted.zhang_shasha_ted(repetitive_dag, kRoot, repetitive_dag, kRoot) != 0.0 ||
+      zs_ted.zhang_shasha_ted(repetitive_dag, kRoot, other_dag, kLeafRoot) !=
+          zs_ted.zhang_shasha_ted(kRepetitiveTree, kLeaf)) {
+    std::cerr << "Incorrect distance on the repetitive DAG" << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,141 @@
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fstream>
+#include "unit_cost_model.h"
+#include "string_edit_distance_cost_model.h"
+#include "string_label.h"
+#include "node.h"
+#include "bracket_notation_parser.h"
+#include "zhang_shasha.h"
+
+/// Verifies the intervals of anytime computations for one pair of trees: an
+/// unreachable deadline gives the distance, a cancelled computation and
+/// computations with deadlines growing from zero give intervals containing
+/// the distance.
+///
+/// \param t1 Source tree.
+/// \param t2 Destination tree.
+/// \param error Set to a description of the first failure.
+template <typename CostModel>
+void verify_intervals(const node::Node<label::StringLabel>& t1,
+                      const node::Node<label::StringLabel>& t2,
+                      std::string& error) {
+  using Algorithm = zhang_shasha::Algorithm<label::StringLabel, CostModel>;
+  using Clock = std::chrono::steady_clock;
+  Algorithm zs_ted;
+  const double kDistance = zs_ted.zhang_shasha_ted(t1, t2);
+
+  auto contains = [&](const typename Algorithm::Interval& interval) {
+    if (interval.exact) {
+      return interval.lower == kDistance && interval.upper == kDistance;
+    }
+    return interval.lower <= kDistance && kDistance <= interval.upper;
+  };
+
+  typename Algorithm::Interval interval = zs_ted.zhang_shasha_ted_anytime(
+      t1, t2, Clock::now() + std::chrono::hours(1));
+  if (!interval.exact || interval.lower != kDistance) {
+    error = "Distance " + std::to_string(interval.lower) + " instead of " +
+            std::to_string(kDistance);
+    return;
+  }
+
+  const std::atomic<bool> kCancelled(true);
+  interval = zs_ted.zhang_shasha_ted_anytime(
+      t1, t2, Clock::now() + std::chrono::hours(1), &kCancelled);
+  if (!contains(interval)) {
+    error = "Cancelled interval [" + std::to_string(interval.lower) + ", " +
+            std::to_string(interval.upper) + "] misses " +
+            std::to_string(kDistance);
+    return;
+  }
+  // An interrupted computation has no mapping.
+  if (!interval.exact && !zs_ted.compute_edit_mapping().matched.empty()) {
+    error = "Mapping after an interrupted computation";
+    return;
+  }
+
+  for (auto budget = std::chrono::microseconds(1);; budget *= 2) {
+    interval = zs_ted.zhang_shasha_ted_anytime(t1, t2, Clock::now() + budget);
+    if (!contains(interval)) {
+      error = "Interval [" + std::to_string(interval.lower) + ", " +
+              std::to_string(interval.upper) + "] misses " +
+              std::to_string(kDistance);
+      return;
+    }
+    if (interval.exact) {
+      return;
+    }
+  }
+}
+
+int main() {
+
+  using Label = label::StringLabel;
+
+  // Parse test cases from file.
+  std::ifstream test_cases_file("ted_test_data.txt");
+  if (!test_cases_file.is_open()) {
+    std::cerr << "Error while opening file." << std::endl;
+    return -1;
+  }
+
+  // Source and destination trees of all test cases, to be joined in two
+  // large trees.
+  std::string all_trees_1 = "{\"root\"";
+  std::string all_trees_2 = "{\"root\"";
+
+  // Read test cases from a file line by line.
+  for (std::string line; std::getline( test_cases_file, line);) {
+    if (line[0] == '#') {
+      // Read the single test case.
+      std::getline(test_cases_file, line);
+      std::string input_tree_1_string = line;
+      std::getline(test_cases_file, line);
+      std::string input_tree_2_string = line;
+      std::getline(test_cases_file, line);
+      all_trees_1 += input_tree_1_string;
+      all_trees_2 += input_tree_2_string;
+
+      // Parse test tree.
+      parser::BracketNotationParser bnp;
+      node::Node<Label> t1 = bnp.parse_string(input_tree_1_string);
+      node::Node<Label> t2 = bnp.parse_string(input_tree_2_string);
+
+      std::string error;
+      verify_intervals<cost_model::UnitCostModel<Label>>(t1, t2, error);
+      if (error.empty()) {
+        verify_intervals<cost_model::StringEditDistanceCostModel<Label>>(
+            t1, t2, error);
+      }
+      if (!error.empty()) {
+        std::cerr << error << std::endl;
+        std::cerr << input_tree_1_string << std::endl;
+        std::cerr << input_tree_2_string << std::endl;
+        return -1;
+      }
+    }
+  }
+
+  // Large trees are interrupted after some key-root pairs are completed.
+  all_trees_1 += "}";
+  all_trees_2 += "}";
+  parser::BracketNotationParser bnp;
+  node::Node<Label> t1 = bnp.parse_string(all_trees_1);
+  node::Node<Label> t2 = bnp.parse_string(all_trees_2);
+  std::string error;
+  verify_intervals<cost_model::UnitCostModel<Label>>(t1, t2, error);
+  if (error.empty()) {
+    verify_intervals<cost_model::StringEditDistanceCostModel<Label>>(
+        t1, t2, error);
+  }
+  if (!error.empty()) {
+    std::cerr << error << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
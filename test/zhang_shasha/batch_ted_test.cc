@@ -0,0 +1,146 @@
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fstream>
+#include "unit_cost_model.h"
+#include "string_edit_distance_cost_model.h"
+#include "string_label.h"
+#include "node.h"
+#include "bracket_notation_parser.h"
+#include "zhang_shasha.h"
+#include "batch_ted.h"
+
+using Label = label::StringLabel;
+
+/// Copies a tree with pseudo-random labels, keeping its shape.
+node::Node<Label> relabel(const node::Node<Label>& n, unsigned& seed) {
+  seed = seed * 1103515245 + 12345;
+  node::Node<Label> copy(Label(std::string(1, 'a' + (seed >> 16) % 4)));
+  for (const node::Node<Label>& child : n.get_children()) {
+    copy.add_child(relabel(child, seed));
+  }
+  return copy;
+}
+
+/// Creates a tree from the parents of its nodes, a parent precedes its
+/// children.
+node::Node<Label> make_tree(const std::vector<int>& parent, unsigned& seed) {
+  std::vector<node::Node<Label>> nodes;
+  for (std::size_t n = 0; n < parent.size(); ++n) {
+    seed = seed * 1103515245 + 12345;
+    nodes.emplace_back(Label(std::string(1, 'a' + (seed >> 16) % 4)));
+  }
+  for (std::size_t n = parent.size() - 1; n > 0; --n) {
+    nodes[parent[n]].add_child(nodes[n]);
+  }
+  return nodes[0];
+}
+
+/// Compares the batched distances to one zhang_shasha_ted call per pair.
+template <typename CostModel>
+bool verify_batch(const std::vector<node::Node<Label>>& trees1,
+                  const std::vector<node::Node<Label>>& trees2) {
+  using Batch = zhang_shasha::BatchAlgorithm<Label, CostModel>;
+  std::vector<typename Batch::TreePair> pairs;
+  for (std::size_t p = 0; p < trees1.size(); ++p) {
+    pairs.emplace_back(std::cref(trees1[p]), std::cref(trees2[p]));
+  }
+  Batch batch_ted;
+  std::vector<double> distances = batch_ted.zhang_shasha_ted(pairs);
+  zhang_shasha::Algorithm<Label, CostModel> zs_ted;
+  for (std::size_t p = 0; p < pairs.size(); ++p) {
+    double correct_result = zs_ted.zhang_shasha_ted(trees1[p], trees2[p]);
+    if (std::abs(distances[p] - correct_result) > 1e-9) {
+      std::cerr << "Incorrect batched TED result of pair " << p << ": " << distances[p] << " instead of " << correct_result << std::endl;
+      return false;
+    }
+  }
+  auto stats = batch_ted.get_statistics();
+  if (stats.pairs != static_cast<long long>(pairs.size()) ||
+      stats.batched_pairs + stats.single_pairs != stats.pairs ||
+      stats.batched_pairs == 0 ||
+      stats.batches * Batch::kLanes < stats.batched_pairs) {
+    std::cerr << "Incorrect statistics: " << stats.batches << " batches, " << stats.batched_pairs << " batched pairs, " << stats.single_pairs << " single pairs" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int main() {
+
+  using CostModel = cost_model::UnitCostModel<Label>;
+
+  // Parse test cases from file.
+  std::ifstream test_cases_file("ted_test_data.txt");
+  if (!test_cases_file.is_open()) {
+    std::cerr << "Error while opening file." << std::endl;
+    return -1;
+  }
+  parser::BracketNotationParser bnp;
+  std::vector<node::Node<Label>> trees1;
+  std::vector<node::Node<Label>> trees2;
+  std::vector<double> correct_results;
+  for (std::string line; std::getline( test_cases_file, line);) {
+    if (line[0] == '#') {
+      std::getline(test_cases_file, line);
+      trees1.push_back(bnp.parse_string(line));
+      std::getline(test_cases_file, line);
+      trees2.push_back(bnp.parse_string(line));
+      std::getline(test_cases_file, line);
+      correct_results.push_back(std::stod(line));
+    }
+  }
+
+  // The test cases alone have mostly distinct shapes.
+  zhang_shasha::BatchAlgorithm<Label, CostModel> batch_ted;
+  std::vector<zhang_shasha::BatchAlgorithm<Label, CostModel>::TreePair> pairs;
+  for (std::size_t p = 0; p < trees1.size(); ++p) {
+    pairs.emplace_back(std::cref(trees1[p]), std::cref(trees2[p]));
+  }
+  std::vector<double> distances = batch_ted.zhang_shasha_ted(pairs);
+  for (std::size_t p = 0; p < pairs.size(); ++p) {
+    if (distances[p] != correct_results[p]) {
+      std::cerr << "Incorrect TED result of test case " << p + 1 << ": " << distances[p] << " instead of " << correct_results[p] << std::endl;
+      return -1;
+    }
+  }
+
+  // Add relabeled copies of every pair: same shapes, different costs. The
+  // number of copies fills several batches, the last one partially.
+  const std::size_t kTestCases = trees1.size();
+  unsigned seed = 1;
+  for (int copy = 0; copy < 19; ++copy) {
+    for (std::size_t p = 0; p < kTestCases; ++p) {
+      trees1.push_back(relabel(trees1[p], seed));
+      trees2.push_back(relabel(trees2[p], seed));
+    }
+  }
+  if (!verify_batch<CostModel>(trees1, trees2) ||
+      !verify_batch<cost_model::StringEditDistanceCostModel<Label>>(trees1, trees2)) {
+    return -1;
+  }
+
+  // Pairs of equal sizes and slightly different shapes: a comb whose last
+  // leaf is moved to another spine node. Only groups of equal shapes are
+  // batched, the others are computed one by one.
+  std::vector<node::Node<Label>> similar1;
+  std::vector<node::Node<Label>> similar2;
+  std::vector<int> comb(1, -1);
+  for (int n = 1; n < 24; n += 2) {
+    comb.push_back(n - 1);
+    comb.push_back(n - 1);
+  }
+  for (int variant = 0; variant < 40; ++variant) {
+    std::vector<int> moved = comb;
+    moved.back() = variant % 12 * 2;
+    similar1.push_back(make_tree(comb, seed));
+    similar2.push_back(make_tree(moved, seed));
+  }
+  if (!verify_batch<CostModel>(similar1, similar2) ||
+      !verify_batch<cost_model::StringEditDistanceCostModel<Label>>(similar1, similar2)) {
+    return -1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,110 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fstream>
+#include "unit_cost_model.h"
+#include "string_label.h"
+#include "node.h"
+#include "bracket_notation_parser.h"
+#include "zhang_shasha.h"
+
+/// Returns true if node a is a proper ancestor of node d.
+///
+/// \param lld Leftmost leaf descendants indexed in postorder-1.
+/// \param a Postorder id of the ancestor candidate.
+/// \param d Postorder id of the descendant candidate.
+bool is_ancestor(const std::vector<int>& lld, int a, int d) {
+  return lld[a - 1] <= d && d < a;
+}
+
+int main() {
+
+  using Label = label::StringLabel;
+  using CostModel = cost_model::UnitCostModel<Label>;
+  using Algorithm = zhang_shasha::Algorithm<Label, CostModel>;
+
+  // Parse test cases from file.
+  std::ifstream test_cases_file("ted_test_data.txt");
+  if (!test_cases_file.is_open()) {
+    std::cerr << "Error while opening file." << std::endl;
+    return -1;
+  }
+
+  // Initialise ZS algorithm.
+  Algorithm zs_ted;
+
+  // Read test cases from a file line by line.
+  for (std::string line; std::getline( test_cases_file, line);) {
+    if (line[0] == '#') {
+      // Read the single test case.
+      std::getline(test_cases_file, line);
+      std::string input_tree_1_string = line;
+      std::getline(test_cases_file, line);
+      std::string input_tree_2_string = line;
+      std::getline(test_cases_file, line);
+
+      // Parse test tree.
+      parser::BracketNotationParser bnp;
+      node::Node<Label> t1 = bnp.parse_string(input_tree_1_string);
+      node::Node<Label> t2 = bnp.parse_string(input_tree_2_string);
+
+      // Execute the algorithm and recover the mapping.
+      double computed_results = zs_ted.zhang_shasha_ted(t1, t2);
+      const Algorithm::EditMapping mapping = zs_ted.compute_edit_mapping();
+      const std::vector<int>& t1_lld = zs_ted.get_test_items().t1_lld;
+      const std::vector<int>& t2_lld = zs_ted.get_test_items().t2_lld;
+
+      std::string error;
+
+      // The cost of the mapping must be the distance.
+      double mapping_cost = mapping.renamed.size() + mapping.deleted.size() +
+                            mapping.inserted.size();
+      if (mapping_cost != computed_results) {
+        error = "Mapping cost " + std::to_string(mapping_cost) +
+                " instead of " + std::to_string(computed_results);
+      }
+
+      // Every node must be covered by exactly one edit operation.
+      std::vector<std::pair<int, int>> pairs(mapping.matched);
+      pairs.insert(pairs.end(), mapping.renamed.begin(), mapping.renamed.end());
+      std::vector<int> t1_covered(t1.get_tree_size(), 0);
+      std::vector<int> t2_covered(t2.get_tree_size(), 0);
+      for (const auto& p : pairs) {
+        ++t1_covered[p.first - 1];
+        ++t2_covered[p.second - 1];
+      }
+      for (int i : mapping.deleted) {
+        ++t1_covered[i - 1];
+      }
+      for (int j : mapping.inserted) {
+        ++t2_covered[j - 1];
+      }
+      for (int c : t1_covered) {
+        if (c != 1) error = "Source node not covered exactly once";
+      }
+      for (int c : t2_covered) {
+        if (c != 1) error = "Destination node not covered exactly once";
+      }
+
+      // Mapped pairs must preserve sibling order and ancestry.
+      for (const auto& p : pairs) {
+        for (const auto& q : pairs) {
+          if ((p.first < q.first) != (p.second < q.second) ||
+              is_ancestor(t1_lld, p.first, q.first) !=
+                  is_ancestor(t2_lld, p.second, q.second)) {
+            error = "Mapping is not a valid edit mapping";
+          }
+        }
+      }
+
+      if (!error.empty()) {
+        std::cerr << error << std::endl;
+        std::cerr << input_tree_1_string << std::endl;
+        std::cerr << input_tree_2_string << std::endl;
+        return -1;
+      }
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,69 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include "unit_cost_model.h"
+#include "string_label.h"
+#include "node.h"
+#include "bracket_notation_parser.h"
+#include "zhang_shasha.h"
+
+int main() {
+
+  using Label = label::StringLabel;
+  using CostModel = cost_model::UnitCostModel<Label>;
+
+  // Parse test cases from file.
+  std::ifstream test_cases_file("incremental_ted_test_data.txt");
+  if (!test_cases_file.is_open()) {
+    std::cerr << "Error while opening file." << std::endl;
+    return -1;
+  }
+
+  // Initialise ZS algorithm, one for the updates and one for reference.
+  zhang_shasha::Algorithm<Label, CostModel> zs_ted;
+  zhang_shasha::Algorithm<Label, CostModel> zs_ted_reference;
+
+  // Read test cases from a file line by line.
+  for (std::string line; std::getline( test_cases_file, line);) {
+    if (line[0] == '#') {
+      // Read the single test case: source tree, destination tree, changed
+      // destination tree, and postorder ids of the changed subtrees.
+      std::getline(test_cases_file, line);
+      std::string input_tree_1_string = line;
+      std::getline(test_cases_file, line);
+      std::string input_tree_2_string = line;
+      std::getline(test_cases_file, line);
+      std::string changed_tree_2_string = line;
+      std::getline(test_cases_file, line);
+      std::istringstream changed_stream(line);
+      std::vector<int> changed_subtrees;
+      for (int j; changed_stream >> j;) {
+        changed_subtrees.push_back(j);
+      }
+
+      // Parse test tree.
+      parser::BracketNotationParser bnp;
+      node::Node<Label> t1 = bnp.parse_string(input_tree_1_string);
+      node::Node<Label> t2 = bnp.parse_string(input_tree_2_string);
+      node::Node<Label> changed_t2 = bnp.parse_string(changed_tree_2_string);
+
+      // Execute the algorithm and update the distance.
+      zs_ted.zhang_shasha_ted(t1, t2);
+      double computed_results =
+          zs_ted.zhang_shasha_ted_update(changed_t2, changed_subtrees);
+      double correct_result =
+          zs_ted_reference.zhang_shasha_ted(t1, changed_t2);
+
+      if (correct_result != computed_results) {
+        std::cerr << "Incorrect TED result: " << computed_results << " instead of " << correct_result << std::endl;
+        std::cerr << input_tree_1_string << std::endl;
+        std::cerr << changed_tree_2_string << std::endl;
+        return -1;
+      }
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,180 @@
+#include <cstdio>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fstream>
+#include "unit_cost_model.h"
+#include "string_label.h"
+#include "node.h"
+#include "bracket_notation_parser.h"
+#include "zhang_shasha.h"
+#include "persistent_distance_cache.h"
+
+using Label = label::StringLabel;
+using CostModel = cost_model::UnitCostModel<Label>;
+using Algorithm = zhang_shasha::Algorithm<Label, CostModel>;
+using Cache = zhang_shasha::PersistentDistanceCache;
+
+/// Computes all test cases through the cache.
+///
+/// \param cache The cache.
+/// \param trees Pairs of trees in bracket notation.
+/// \param correct_results The distances.
+/// \return True if all distances are correct.
+bool compute_all(Cache& cache, const std::vector<std::string>& trees,
+                 const std::vector<double>& correct_results) {
+  parser::BracketNotationParser bnp;
+  Algorithm zs_ted;
+  for (std::size_t c = 0; c < correct_results.size(); ++c) {
+    node::Node<Label> t1 = bnp.parse_string(trees[2 * c]);
+    node::Node<Label> t2 = bnp.parse_string(trees[2 * c + 1]);
+    double computed_results = cache.ted(zs_ted, t1, t2, 1);
+    if (correct_results[c] != computed_results) {
+      std::cerr << "Incorrect TED result: " << computed_results << " instead of " << correct_results[c] << std::endl;
+      std::cerr << trees[2 * c] << std::endl;
+      std::cerr << trees[2 * c + 1] << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Reads the bytes of a file.
+std::string read_file(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(in),
+                     std::istreambuf_iterator<char>());
+}
+
+int main() {
+
+  // Parse test cases from file.
+  std::ifstream test_cases_file("ted_test_data.txt");
+  if (!test_cases_file.is_open()) {
+    std::cerr << "Error while opening file." << std::endl;
+    return -1;
+  }
+  std::vector<std::string> trees;
+  std::vector<double> correct_results;
+  for (std::string line; std::getline( test_cases_file, line);) {
+    if (line[0] == '#') {
+      std::getline(test_cases_file, line);
+      trees.push_back(line);
+      std::getline(test_cases_file, line);
+      trees.push_back(line);
+      std::getline(test_cases_file, line);
+      correct_results.push_back(std::stod(line));
+    }
+  }
+
+  const std::string kPath = "persistent_distance_cache_test.bin";
+  std::remove(kPath.c_str());
+
+  // The first run computes and stores all distances.
+  long long entries = 0;
+  {
+    Cache cache;
+    if (!cache.open(kPath)) {
+      std::cerr << cache.get_error() << std::endl;
+      return -1;
+    }
+    if (!compute_all(cache, trees, correct_results) ||
+        !compute_all(cache, trees, correct_results)) {
+      return -1;
+    }
+    Cache::Statistics stats = cache.get_statistics();
+    entries = stats.entries;
+    if (stats.misses != entries ||
+        stats.hits != 2 * static_cast<long long>(correct_results.size()) - entries) {
+      std::cerr << "Incorrect counters: " << stats.hits << " hits, " << stats.misses << " misses" << std::endl;
+      return -1;
+    }
+  }
+
+  // The next run reads them from the file, even after an interrupted write.
+  // The incomplete record is cut off, the complete ones stay in place.
+  const std::string kComplete = read_file(kPath);
+  std::ofstream(kPath, std::ios::binary | std::ios::app).write("torn", 4);
+  for (int run = 0; run < 2; ++run) {
+    Cache cache;
+    if (!cache.open(kPath)) {
+      std::cerr << cache.get_error() << std::endl;
+      return -1;
+    }
+    if (!compute_all(cache, trees, correct_results)) {
+      return -1;
+    }
+    Cache::Statistics stats = cache.get_statistics();
+    if (stats.loaded != entries || stats.misses != 0) {
+      std::cerr << "Incorrect counters after reopening: " << stats.loaded << " loaded, " << stats.misses << " misses" << std::endl;
+      return -1;
+    }
+    if (read_file(kPath) != kComplete) {
+      std::cerr << "Incorrect file after reopening." << std::endl;
+      return -1;
+    }
+    double distance = 0.0;
+    parser::BracketNotationParser bnp;
+    if (cache.lookup(Cache::fingerprint(bnp.parse_string(trees[0])),
+                     Cache::fingerprint(bnp.parse_string(trees[1])), 2,
+                     distance)) {
+      std::cerr << "Found a distance of another cost model." << std::endl;
+      return -1;
+    }
+  }
+
+  // Threads sharing a cache.
+  std::remove(kPath.c_str());
+  {
+    Cache cache;
+    if (!cache.open(kPath)) {
+      std::cerr << cache.get_error() << std::endl;
+      return -1;
+    }
+    std::vector<std::thread> threads;
+    std::vector<char> correct(4, 0);
+    for (int t = 0; t < 4; ++t) {
+      threads.emplace_back([&, t]() {
+        correct[t] = compute_all(cache, trees, correct_results);
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    for (char c : correct) {
+      if (!c) {
+        return -1;
+      }
+    }
+    if (cache.get_statistics().entries != entries) {
+      std::cerr << "Incorrect number of entries: " << cache.get_statistics().entries << std::endl;
+      return -1;
+    }
+  }
+  std::remove(kPath.c_str());
+
+  // Other files are not overwritten.
+  std::ofstream(kPath) << "not a cache" << std::endl;
+  Cache cache;
+  if (cache.open(kPath)) {
+    std::cerr << "Opened a file that is not a cache." << std::endl;
+    return -1;
+  }
+  std::remove(kPath.c_str());
+
+  // Fingerprints depend on the labels and the structure.
+  parser::BracketNotationParser bnp;
+  if (Cache::fingerprint(bnp.parse_string("{\"a\"{\"b\"}{\"c\"}}")) !=
+          Cache::fingerprint(bnp.parse_string("{\"a\"{\"b\"}{\"c\"}}")) ||
+      Cache::fingerprint(bnp.parse_string("{\"a\"{\"b\"}{\"c\"}}")) ==
+          Cache::fingerprint(bnp.parse_string("{\"a\"{\"c\"}{\"b\"}}")) ||
+      Cache::fingerprint(bnp.parse_string("{\"a\"{\"b\"}{\"c\"}}")) ==
+          Cache::fingerprint(bnp.parse_string("{\"a\"{\"b\"{\"c\"}}}"))) {
+    std::cerr << "Incorrect fingerprints." << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,106 @@
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fstream>
+#include "unit_cost_model.h"
+#include "string_edit_distance_cost_model.h"
+#include "string_label.h"
+#include "node.h"
+#include "bracket_notation_parser.h"
+#include "zhang_shasha.h"
+#include "small_tree_ted.h"
+
+int main() {
+
+  using Label = label::StringLabel;
+  using CostModel = cost_model::UnitCostModel<Label>;
+  using StringCostModel = cost_model::StringEditDistanceCostModel<Label>;
+
+  // Parse test cases from file.
+  std::ifstream test_cases_file("ted_test_data.txt");
+  if (!test_cases_file.is_open()) {
+    std::cerr << "Error while opening file." << std::endl;
+    return -1;
+  }
+
+  // The largest test trees have 29 nodes: some fit the tiny engine, some the
+  // small one. Engines live for all test cases to reuse the buffers.
+  zhang_shasha::SmallTreeTED<Label, CostModel, 32> small_ted;
+  zhang_shasha::SmallTreeTED<Label, CostModel, 8> tiny_ted;
+  zhang_shasha::SizeDispatchingAlgorithm<Label, CostModel> dispatching_ted;
+  zhang_shasha::SizeDispatchingAlgorithm<Label, StringCostModel> string_dispatching_ted;
+  zhang_shasha::Algorithm<Label, StringCostModel> string_zs_ted;
+
+  int test_cases = 0;
+  for (std::string line; std::getline( test_cases_file, line);) {
+    if (line[0] == '#') {
+      ++test_cases;
+      std::getline(test_cases_file, line);
+      std::string input_tree_1_string = line;
+      std::getline(test_cases_file, line);
+      std::string input_tree_2_string = line;
+      std::getline(test_cases_file, line);
+      double correct_result = std::stod(line);
+
+      parser::BracketNotationParser bnp;
+      node::Node<Label> t1 = bnp.parse_string(input_tree_1_string);
+      node::Node<Label> t2 = bnp.parse_string(input_tree_2_string);
+
+      double small_result = small_ted.zhang_shasha_ted(t1, t2);
+      double dispatching_result = dispatching_ted.zhang_shasha_ted(t1, t2);
+      if (small_result != correct_result || dispatching_result != correct_result) {
+        std::cerr << "Incorrect TED result: " << small_result << " and " << dispatching_result << " instead of " << correct_result << std::endl;
+        std::cerr << input_tree_1_string << std::endl;
+        std::cerr << input_tree_2_string << std::endl;
+        return -1;
+      }
+
+      // Trees above the capacity are rejected.
+      const bool kFits = t1.get_tree_size() <= 8 && t2.get_tree_size() <= 8;
+      double tiny_result = tiny_ted.zhang_shasha_ted(t1, t2);
+      if ((kFits && tiny_result != correct_result) || (!kFits && tiny_result != -1)) {
+        std::cerr << "Incorrect TED result of the tiny engine: " << tiny_result << std::endl;
+        std::cerr << input_tree_1_string << std::endl;
+        std::cerr << input_tree_2_string << std::endl;
+        return -1;
+      }
+
+      // Cost models with non-constant costs.
+      double string_result = string_dispatching_ted.zhang_shasha_ted(t1, t2);
+      double string_correct_result = string_zs_ted.zhang_shasha_ted(t1, t2);
+      if (std::abs(string_result - string_correct_result) > 1e-9) {
+        std::cerr << "Incorrect TED result with string costs: " << string_result << " instead of " << string_correct_result << std::endl;
+        return -1;
+      }
+    }
+  }
+
+  auto stats = dispatching_ted.get_statistics();
+  if (stats.tiny + stats.small + stats.general != test_cases ||
+      stats.tiny == 0 || stats.small == 0) {
+    std::cerr << "Incorrect dispatching: " << stats.tiny << " tiny, " << stats.small << " small, " << stats.general << " general" << std::endl;
+    return -1;
+  }
+
+  // A path deeper than the capacities is left after the capacity levels and
+  // computed by the general engine.
+  node::Node<Label> deep1(Label("a"));
+  node::Node<Label> deep2(Label("a"));
+  for (int depth = 1; depth < 200; ++depth) {
+    node::Node<Label> parent(Label("a"));
+    parent.add_child(deep1);
+    deep1 = parent;
+    if (depth < 199) {
+      deep2 = parent;
+    }
+  }
+  double deep_result = dispatching_ted.zhang_shasha_ted(deep1, deep2);
+  if (deep_result != 1 || tiny_ted.zhang_shasha_ted(deep1, deep2) != -1 ||
+      dispatching_ted.get_statistics().general != stats.general + 1) {
+    std::cerr << "Incorrect TED result for deep trees: " << deep_result << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,110 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fstream>
+#include "unit_cost_model.h"
+#include "string_label.h"
+#include "node.h"
+#include "bracket_notation_parser.h"
+#include "zhang_shasha.h"
+
+using Label = label::StringLabel;
+using CostModel = cost_model::UnitCostModel<Label>;
+using Algorithm = zhang_shasha::Algorithm<Label, CostModel>;
+
+/// Sums the subtree sizes of the key roots of the source tree of the last
+/// computation.
+///
+/// \param zs_ted The algorithm.
+/// \return Sum of the subtree sizes.
+long long key_root_nodes(const Algorithm& zs_ted) {
+  long long nodes = 0;
+  for (int kr : zs_ted.get_test_items().t1_kr) {
+    nodes += kr - zs_ted.get_test_items().t1_lld[kr - 1] + 1;
+  }
+  return nodes;
+}
+
+int main() {
+
+  if (!Algorithm::Statistics::kEnabled) {
+    std::cerr << "Statistics are disabled, nothing to test." << std::endl;
+    return 0;
+  }
+
+  parser::BracketNotationParser bnp;
+  Algorithm zs_ted;
+
+  // Source postorder b c a with key roots c and a, destination postorder
+  // z y w x with key roots w and x: four key-root pairs with subtree sizes
+  // 1 and 3 times 1 and 4.
+  zs_ted.zhang_shasha_ted(bnp.parse_string("{\"a\"{\"b\"}{\"c\"}}"),
+      bnp.parse_string("{\"x\"{\"y\"{\"z\"}}{\"w\"}}"));
+  Algorithm::Statistics stats = zs_ted.get_statistics();
+  if (stats.t1_size != 3 || stats.t2_size != 4 || stats.t1_key_roots != 2 ||
+      stats.t2_key_roots != 2 || stats.forest_distance_calls != 4 ||
+      stats.key_root_pairs_reused != 0 || stats.cache_hits != 0 ||
+      stats.cells_computed != 4 * 5 ||
+      stats.matrix_bytes < 2 * 4 * 5 * static_cast<long long>(sizeof(int))) {
+    std::cerr << "Incorrect statistics of a small pair." << std::endl;
+    return -1;
+  }
+
+  // Identical trees are not computed, the counters are reset.
+  zs_ted.zhang_shasha_ted(bnp.parse_string("{\"a\"{\"b\"}{\"c\"}}"),
+      bnp.parse_string("{\"a\"{\"b\"}{\"c\"}}"));
+  stats = zs_ted.get_statistics();
+  if (stats.t1_key_roots != 2 || stats.forest_distance_calls != 0 ||
+      stats.cells_computed != 0) {
+    std::cerr << "Incorrect statistics of identical trees." << std::endl;
+    return -1;
+  }
+
+  // Parse test cases from file.
+  std::ifstream test_cases_file("ted_test_data.txt");
+  if (!test_cases_file.is_open()) {
+    std::cerr << "Error while opening file." << std::endl;
+    return -1;
+  }
+
+  // Every key-root pair is computed or reused. Without reuse, a call computes
+  // the product of the subtree sizes of its key roots.
+  for (std::string line; std::getline( test_cases_file, line);) {
+    if (line[0] == '#') {
+      std::getline(test_cases_file, line);
+      std::string input_tree_1_string = line;
+      std::getline(test_cases_file, line);
+      std::string input_tree_2_string = line;
+      std::getline(test_cases_file, line);
+
+      node::Node<Label> t1 = bnp.parse_string(input_tree_1_string);
+      node::Node<Label> t2 = bnp.parse_string(input_tree_2_string);
+
+      zs_ted.zhang_shasha_ted(t2, t1);
+      const long long kT2Nodes = key_root_nodes(zs_ted);
+      zs_ted.zhang_shasha_ted(t1, t2);
+      const long long kT1Nodes = key_root_nodes(zs_ted);
+      stats = zs_ted.get_statistics();
+      const long long kPairs =
+          static_cast<long long>(stats.t1_key_roots) * stats.t2_key_roots;
+      const bool kComputed = stats.forest_distance_calls > 0 ||
+                             stats.key_root_pairs_reused > 0;
+      if (stats.t1_size != t1.get_tree_size() ||
+          stats.t2_size != t2.get_tree_size() ||
+          static_cast<std::size_t>(stats.t1_key_roots) !=
+              zs_ted.get_test_items().t1_kr.size() ||
+          (kComputed && stats.forest_distance_calls +
+              stats.key_root_pairs_reused != kPairs) ||
+          stats.cells_computed > kT1Nodes * kT2Nodes ||
+          (stats.key_root_pairs_reused == 0 &&
+           stats.cells_computed != (kComputed ? kT1Nodes * kT2Nodes : 0))) {
+        std::cerr << "Incorrect statistics: " << stats.forest_distance_calls << " calls, " << stats.key_root_pairs_reused << " reused, " << stats.cells_computed << " cells" << std::endl;
+        std::cerr << input_tree_1_string << std::endl;
+        std::cerr << input_tree_2_string << std::endl;
+        return -1;
+      }
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,76 @@
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <fstream>
+#include "unit_cost_model.h"
+#include "string_label.h"
+#include "node.h"
+#include "bracket_notation_parser.h"
+#include "zhang_shasha.h"
+
+int main() {
+
+  using Label = label::StringLabel;
+  using CostModel = cost_model::UnitCostModel<Label>;
+  using Algorithm = zhang_shasha::Algorithm<Label, CostModel>;
+
+  // Parse test cases from file.
+  std::ifstream test_cases_file("ted_test_data.txt");
+  if (!test_cases_file.is_open()) {
+    std::cerr << "Error while opening file." << std::endl;
+    return -1;
+  }
+  std::vector<std::string> trees;
+  std::vector<double> correct_results;
+  for (std::string line; std::getline( test_cases_file, line);) {
+    if (line[0] == '#') {
+      std::getline(test_cases_file, line);
+      trees.push_back(line);
+      std::getline(test_cases_file, line);
+      trees.push_back(line);
+      std::getline(test_cases_file, line);
+      correct_results.push_back(std::stod(line));
+    }
+  }
+
+  // Initialise ZS algorithms sharing a cache of all key-root pairs. The small
+  // cache evicts blocks while the test cases are computed.
+  auto large_cache = std::make_shared<Algorithm::Cache>(1 << 24, 0);
+  auto small_cache = std::make_shared<Algorithm::Cache>(1 << 12, 0);
+  Algorithm zs_ted;
+  zs_ted.set_cache(large_cache);
+  Algorithm zs_ted_evicting;
+  zs_ted_evicting.set_cache(small_cache);
+
+  // Compute all test cases twice, the second pass reads the cache.
+  parser::BracketNotationParser bnp;
+  for (int pass = 0; pass < 2; ++pass) {
+    for (std::size_t c = 0; c < correct_results.size(); ++c) {
+      node::Node<Label> t1 = bnp.parse_string(trees[2 * c]);
+      node::Node<Label> t2 = bnp.parse_string(trees[2 * c + 1]);
+      double computed_results = zs_ted.zhang_shasha_ted(t1, t2);
+      double computed_results_evicting = zs_ted_evicting.zhang_shasha_ted(t1, t2);
+      if (correct_results[c] != computed_results ||
+          correct_results[c] != computed_results_evicting) {
+        std::cerr << "Incorrect TED result: " << computed_results << ", " << computed_results_evicting << " instead of " << correct_results[c] << std::endl;
+        std::cerr << trees[2 * c] << std::endl;
+        std::cerr << trees[2 * c + 1] << std::endl;
+        return -1;
+      }
+    }
+  }
+
+  const Algorithm::Cache::Statistics kStats = large_cache->get_statistics();
+  if (kStats.hits == 0 || kStats.evictions != 0) {
+    std::cerr << "Unexpected cache use: " << kStats.hits << " hits, " << kStats.evictions << " evictions" << std::endl;
+    return -1;
+  }
+  const Algorithm::Cache::Statistics kSmallStats = small_cache->get_statistics();
+  if (kSmallStats.evictions == 0 || kSmallStats.bytes > (1 << 12)) {
+    std::cerr << "Unexpected cache use: " << kSmallStats.evictions << " evictions, " << kSmallStats.bytes << " bytes" << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,129 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fstream>
+#include "unit_cost_model.h"
+#include "string_label.h"
+#include "node.h"
+#include "bracket_notation_parser.h"
+#include "zhang_shasha.h"
+
+/// Collects the subtrees of a tree in postorder.
+///
+/// \param root Root of the tree.
+/// \param subtrees Filled with the roots of all subtrees.
+template <typename Node>
+void collect_subtrees(const Node& root, std::vector<const Node*>& subtrees) {
+  for (const Node& child : root.get_children()) {
+    collect_subtrees(child, subtrees);
+  }
+  subtrees.push_back(&root);
+}
+
+int main() {
+
+  using Label = label::StringLabel;
+  using CostModel = cost_model::UnitCostModel<Label>;
+  using Algorithm = zhang_shasha::Algorithm<Label, CostModel>;
+
+  // Parse test cases from file.
+  std::ifstream test_cases_file("ted_test_data.txt");
+  if (!test_cases_file.is_open()) {
+    std::cerr << "Error while opening file." << std::endl;
+    return -1;
+  }
+
+  // Initialise ZS algorithm.
+  Algorithm zs_ted;
+  Algorithm search;
+
+  // Read test cases from a file line by line. The source tree is the query,
+  // the destination tree is the document.
+  for (std::string line; std::getline( test_cases_file, line);) {
+    if (line[0] == '#') {
+      // Read the single test case.
+      std::getline(test_cases_file, line);
+      std::string input_tree_1_string = line;
+      std::getline(test_cases_file, line);
+      std::string input_tree_2_string = line;
+      std::getline(test_cases_file, line);
+
+      // Parse test tree.
+      parser::BracketNotationParser bnp;
+      node::Node<Label> query = bnp.parse_string(input_tree_1_string);
+      node::Node<Label> document = bnp.parse_string(input_tree_2_string);
+
+      // Distances to all document subtrees, computed one by one.
+      std::vector<const node::Node<Label>*> subtrees;
+      collect_subtrees(document, subtrees);
+      std::vector<double> distances;
+      for (const node::Node<Label>* subtree : subtrees) {
+        distances.push_back(zs_ted.zhang_shasha_ted(query, *subtree));
+      }
+
+      // Only subtrees whose root label equals that of the query.
+      const Algorithm::NodeFilter kSameRootLabel =
+          [&query](const node::Node<Label>& n) {
+            return n.label() == query.label();
+          };
+
+      std::string error;
+      for (int filtered = 0; filtered < 2; ++filtered) {
+        const Algorithm::NodeFilter kFilter =
+            filtered ? kSameRootLabel : Algorithm::NodeFilter();
+        for (double threshold : {0.0, 1.0, 2.0, 4.0}) {
+          std::vector<Algorithm::SubtreeMatch> expected;
+          for (int j = 1; j <= static_cast<int>(subtrees.size()); ++j) {
+            if (distances[j - 1] <= threshold &&
+                (!kFilter || kFilter(*subtrees[j - 1]))) {
+              expected.push_back({j, distances[j - 1]});
+            }
+          }
+          std::stable_sort(expected.begin(), expected.end(),
+                           [](const Algorithm::SubtreeMatch& a,
+                              const Algorithm::SubtreeMatch& b) {
+                             return a.distance < b.distance;
+                           });
+          const std::vector<Algorithm::SubtreeMatch> matches =
+              search.search_subtrees(query, document, threshold, kFilter);
+          bool equal = matches.size() == expected.size();
+          for (std::size_t m = 0; equal && m < matches.size(); ++m) {
+            equal = matches[m].node == expected[m].node &&
+                    matches[m].distance == expected[m].distance;
+          }
+          if (!equal) {
+            error = "Wrong matches within " + std::to_string(threshold);
+          }
+
+          // The k closest subtrees are the first k matches of a threshold
+          // search with the distance of the k-th closest subtree.
+          const int kK = expected.size();
+          if (kK > 0) {
+            const std::vector<Algorithm::SubtreeMatch> top =
+                search.search_top_subtrees(query, document, kK, kFilter);
+            for (int m = 0; m < kK; ++m) {
+              if (top[m].node != expected[m].node ||
+                  top[m].distance != expected[m].distance) {
+                error = "Wrong top " + std::to_string(kK) + " subtrees";
+              }
+            }
+          }
+        }
+      }
+
+      // The search leaves no subtree distances for an edit mapping.
+      if (!search.compute_edit_mapping().matched.empty()) {
+        error = "Mapping after a subtree search";
+      }
+
+      if (!error.empty()) {
+        std::cerr << error << std::endl;
+        std::cerr << input_tree_1_string << std::endl;
+        std::cerr << input_tree_2_string << std::endl;
+        return -1;
+      }
+    }
+  }
+
+  return 0;
+}